@@ -15,6 +15,12 @@
 #include "fbl_defs.h"
 #include "bcp.h"
 #include "crc16.h"
+#include "prof.h"
+#include "cpu_tcm.h"
+#include "ext_flash.h"
+
+#include <stddef.h> /* for offsetof() */
+
 
 #if (TRC_FEAT_BCP_ENA == STD_ON)
 #define TRACE_BCP_API(...)   TRACE_FEATURE(TRC_FEAT_ID_eBCP, TRACE_FEATURE_CLASS3, __VA_ARGS__)
@@ -50,10 +56,23 @@ typedef enum BCP_STATE
 #define MSG_BUF_SZ_FBL_RX (1024 + 16)
 #define MSG_BUF_SZ_FBL_TX (1024 + 16)
 
+/* Worst case size of an encoded frame: SOF, every byte escaped, EOF */
+#define FRM_BUF_SZ_FBL_TX (2 * MSG_BUF_SZ_FBL_TX + 2)
+
+/* The RX buffer is placed such that the block data of a program request
+ * is page aligned, so it can be programmed without copying it.
+ */
+#define MSG_BUF_ALIGN_FBL_RX FLASH_PAGE_SIZE
+#define MSG_BUF_PAD_FBL_RX   (MSG_BUF_ALIGN_FBL_RX - BCP_HEADER_LEN - offsetof(T_FBL_MSG_PROGRAM_REQ, blkData))
+
 typedef struct
 {
+  uint8  rxPad[MSG_BUF_PAD_FBL_RX];
   uint8  rxBuffer[MSG_BUF_SZ_FBL_RX];
   uint8  txBuffer[MSG_BUF_SZ_FBL_TX];
+#if (COM_UART_DMA == STD_ON)
+  uint8  txFrame[FRM_BUF_SZ_FBL_TX];
+#endif /* (COM_UART_DMA == STD_ON) */
   uint16 txLen;
   T_PDU  rxPdu;
   T_PDU  txPdu;
@@ -61,9 +80,11 @@ typedef struct
   T_BCP_JOB_RESULT lastJobResult;
   T_DLCF_CTX dlcfCtx;
   T_CRC16_DATA crcCtx;
+  T_BCP_EVT_CBK evtCbk;
 }T_BCP_DATA;
 
-static T_BCP_DATA bcp_dataTbl[1];
+/* The protocol buffers are accessed per byte, so keep them in DTCM */
+__dtcm_bss static T_BCP_DATA bcp_dataTbl[1] __attribute__((aligned(MSG_BUF_ALIGN_FBL_RX)));
 
 
 /*
@@ -84,10 +105,13 @@ boolean bcp_isFrameCrcValid(T_CRC16_DATA* ctx, T_PDU* pdu)
                   | (pdu->data[pdu->len - 1] << 0)
                   );
 
+  PROF_START(PROF_ID_eBCP_FRAME_CRC);
   crc16_preset(ctx, 0);
   crc16_updateFTabFwd(ctx, pdu->data, pdu->len - sizeof(uint16));
   crc16_finalize(ctx, 0);
   expCrc = crc16_read(ctx);
+  PROF_STOP(PROF_ID_eBCP_FRAME_CRC);
+
   if(msgCrc == expCrc)
   {
     result = !FALSE;
@@ -129,6 +153,10 @@ uint8 bcp_escBytes[] =
 
 boolean dlcf_uart_recvByte(void* param, uint8* byte);
 boolean dlcf_uart_sendByte(void* param, const uint8 byte);
+boolean dlcf_uart_sendBlock(void* param, const uint8* block, uint16 len);
+boolean dlcf_uart_isTxBusy(void* param);
+boolean dlcf_uart_recvBlock(void* param, const uint8** block, uint16* len);
+void dlcf_uart_releaseBlock(void* param, uint16 len);
 
 /* Setup channel configuration */
 T_DLCF_CFG bcp_dlcfCfg =
@@ -145,6 +173,12 @@ static const T_DLCF_DEV_INFO bcp_devInfo =
   .wrByte = &dlcf_uart_sendByte,
   .rdByte = &dlcf_uart_recvByte,
   .devData = (void*)&bcp_devID,
+#if (COM_UART_DMA == STD_ON)
+  .wrBlock = &dlcf_uart_sendBlock,
+  .isTxBusy = &dlcf_uart_isTxBusy,
+  .getRxBlock = &dlcf_uart_recvBlock,
+  .relRxBlock = &dlcf_uart_releaseBlock,
+#endif /* (COM_UART_DMA == STD_ON) */
 };
 
 
@@ -469,16 +503,101 @@ void bcp_init(void)
   /* Setup DLCF */
   dlcf_configCtx(&bcpData->dlcfCtx, &bcp_dlcfCfg);
   dlcf_setDevInfo(&bcpData->dlcfCtx, &bcp_devInfo);
+#if (COM_UART_DMA == STD_ON)
+  /* Encode frames for DMA transfer */
+  dlcf_setTxBuffer(&bcpData->dlcfCtx, bcpData->txFrame, sizeof(bcpData->txFrame));
+#endif /* (COM_UART_DMA == STD_ON) */
 
   /* Setup CRC16 */
   crc16_configCtx(&bcpData->crcCtx, crc16_tblP1021);
 
   bcpData->lastJobResult = BCP_JOB_RESULT_eOK;
+  bcpData->evtCbk = NULL;
   bcpData->state = BCP_STATE_eIDLE;
   TRACE_BCP_STATE("BCP State: RESET -> IDLE\n");
 }
 
 
+/*
+ ******************************************************************************
+ *
+ ******************************************************************************
+ * @brief Bind BCP to another transport than COM_UART
+ *
+ * The transport is given by DLCF device info. Byte stream devices get their
+ * frames delimited by DLCF, packet devices (DLCF_DEV_FLAG_PACKET) carry the
+ * BCP messages unframed. The transport can only be changed while BCP is idle.
+ *
+ ******************************************************************************
+ */
+
+T_STATUS bcp_setTransport(const T_DLCF_DEV_INFO* devInfo)
+{
+  T_BCP_DATA* bcpData = bcp_dataTbl;
+  T_STATUS result = STATUS_eNOK;
+
+  TRACE_BCP_API("bcp_setTransport()\n");
+
+  if(BCP_STATE_eIDLE != bcpData->state)
+  {
+    /* Operation not allowed */
+  }
+  else if(NULL == devInfo)
+  {
+    /* Invalid transport */
+  }
+  else if(DLCF_OK != dlcf_setDevInfo(&bcpData->dlcfCtx, devInfo))
+  {
+    /* DLCF still active */
+  }
+  else
+  {
+    result = STATUS_eOK;
+  }
+  return result;
+}
+
+
+/*
+ ******************************************************************************
+ * Function: bcp_setEventCallback
+ ******************************************************************************
+ * @brief Set the callback reporting a completed frame
+ *
+ * The callback is executed by bcp_run(), once a frame was received or
+ * transmitted, so the users of BCP need to be run only then.
+ *
+ * @param [in] evtCbk - Event callback, NULL to disable
+ *
+ ******************************************************************************
+ */
+
+void bcp_setEventCallback(T_BCP_EVT_CBK evtCbk)
+{
+  T_BCP_DATA* bcpData = bcp_dataTbl;
+
+  bcpData->evtCbk = evtCbk;
+}
+
+
+/*
+ ******************************************************************************
+ * Function: bcp_signalEvent
+ ******************************************************************************
+ * @brief Report an event by the event callback, if set
+ *
+ ******************************************************************************
+ */
+
+static void bcp_signalEvent(T_BCP_DATA* bcpData, uint32 evt)
+{
+  if(NULL != bcpData->evtCbk)
+  {
+    bcpData->evtCbk(evt);
+  }
+}
+
+
 /*
  ******************************************************************************
  *
@@ -544,6 +663,7 @@ void bcp_run(void)
         bcpData->state = BCP_STATE_eIDLE;
       }
       TRACE_BCP_STATE("BCP State: LISTEN -> IDLE\n");
+      bcp_signalEvent(bcpData, BCP_EVT_FRAME_RX);
     }
     else
     {
@@ -570,6 +690,7 @@ void bcp_run(void)
       bcpData->lastJobResult = BCP_JOB_RESULT_eOK;
       bcpData->state = BCP_STATE_eIDLE;
       TRACE_BCP_STATE("BCP State: TX_PEND -> IDLE\n");
+      bcp_signalEvent(bcpData, BCP_EVT_FRAME_TX);
     }
     else
     {
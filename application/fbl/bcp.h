@@ -1,6 +1,8 @@
 #ifndef BCP_H
 #define BCP_H
 
+#include "dlcf.h" /* for T_DLCF_DEV_INFO */
+
 #define BCP_TX_PENDING     1
 #define BCP_RX_PENDING     1
 #define BCP_OK             0
@@ -22,9 +24,19 @@ typedef enum BCP_JOB_RESULT
   BCP_JOB_RESULT_ePENDING,
 }T_BCP_JOB_RESULT;
 
+/* Events reported by the event callback */
+#define BCP_EVT_FRAME_RX   0x01 /* Frame received, valid or not */
+#define BCP_EVT_FRAME_TX   0x02 /* Frame transmitted */
+
+/* Event callback type */
+typedef void (*T_BCP_EVT_CBK)(uint32 evt);
+
 void bcp_init(void);
 void bcp_run(void);
 
+T_STATUS bcp_setTransport(const T_DLCF_DEV_INFO* devInfo);
+void bcp_setEventCallback(T_BCP_EVT_CBK evtCbk);
+
 void bcp_cancel(void);
 T_STATUS bcp_listen(void);
 T_STATUS bcp_sendMsg(T_PDU* txMsg);
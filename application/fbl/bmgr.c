@@ -3,7 +3,10 @@
 #endif /* BMGR_C */
 
 #include "bsp.h"
+#include "config.h"
 #include "cpu_irq.h"
+#include "cpu_cache.h"
+#include "cpu_mpu.h"
 #include "hab_api.h"
 #include "hab_info.h"
 #include "trace_pub.h"
@@ -13,6 +16,7 @@
 #include "fbl_defs.h"
 #include "libc.h"
 #include "noinit.h"
+#include "btl.h"
 #include "swinfo.h"
 #include "target_cfg.h"
 #include "fbl.h"
@@ -59,6 +63,12 @@ typedef struct
    const void* appIvtAddr;
    void (*appEntry)(void);
    uint32 timeout;
+   uint32 cmdTimeout;   /* Time to wait for a bootstrap request */
+   boolean entryChecked;
+   boolean enterFbl;
+   boolean traceReady;    /* Trace set up, so diagnostics are output */
+   boolean authFailed;    /* Application image authentication failed */
+   const char* appErrMsg; /* Reason the application image is invalid */
 }T_BMGR_DATA;
 
 static T_BMGR_DATA bmgr_data;
@@ -117,21 +127,21 @@ static boolean bmgr_isAppImgInvalid(T_BMGR_DATA* bmgrData)
     /* Invalid application image tag, so
      * no valid application pressent.
      */
-    TRACE_BMGR_INFO("BMGR: SWInfo invalid tag\n");
+    bmgrData->appErrMsg = "SWInfo invalid tag";
   }
   else if(appSwInfo.imgAddr < FBL_APP_START_ADDR)
   {
     /* Invalid application image start address,
      * so no valid application pressent.
      */
-    TRACE_BMGR_INFO("BMGR: SWInfo invalid addr\n");
+    bmgrData->appErrMsg = "SWInfo invalid addr";
   }
   else if(appSwInfo.imgAddr + appSwInfo.imgSize > FBL_APP_END_ADDR + 1)
   {
     /* Invalid application image end address,
      * so no valid application pressent.
      */
-    TRACE_BMGR_INFO("BMGR: SWInfo invalid len\n");
+    bmgrData->appErrMsg = "SWInfo invalid len";
   }
 #if 0
   else if(bmgr_isAppCrcInalid(&appSwInfo, appSwInfo.startAddr, appSwInfo.endAddr))
@@ -139,32 +149,32 @@ static boolean bmgr_isAppImgInvalid(T_BMGR_DATA* bmgrData)
     /* Invalid application image CRC, so
      * no valid application pressent.
      */
-    TRACE_BMGR_INFO("BMGR: SWInfo invalid CRC\n");
+    bmgrData->appErrMsg = "SWInfo invalid CRC";
   }
 #endif
   else if( !hab_isIvtValid(bmgrData->appIvtAddr))
   {
     /* Application IVT address doesn't contain a valid IVT header */
-    TRACE_BMGR_INFO("BMGR: IVT invalid header\n");
+    bmgrData->appErrMsg = "IVT invalid header";
   }
   else if(0 == (((uint32)(void*)bmgrData->appEntry) & 0x1))
   {
     /* Application entry is not a valid thumb instruction address */
-    TRACE_BMGR_INFO("BMGR: SWInfo invalid entry\n");
+    bmgrData->appErrMsg = "SWInfo invalid entry";
   }
   else if(((uint32)(void*)bmgrData->appEntry) < appSwInfo.imgAddr)
   {
     /* Unexpected entry address, so
      * no valid application pressent.
      */
-    TRACE_BMGR_INFO("BMGR: SWInfo invalid entry\n");
+    bmgrData->appErrMsg = "SWInfo invalid entry";
   }
   else if(((uint32)(void*)bmgrData->appEntry) >= (appSwInfo.imgAddr + appSwInfo.imgSize))
   {
     /* Unexpected entry address, so
      * no valid application pressent.
      */
-    TRACE_BMGR_INFO("BMGR: SWInfo invalid entry\n");
+    bmgrData->appErrMsg = "SWInfo invalid entry";
   }
   else
   {
@@ -250,6 +260,39 @@ static boolean bmgr_checkFblEntryCondition(T_BMGR_DATA* bmgrData)
 }
 
 
+/*
+ ******************************************************************************
+ *
+ ******************************************************************************
+ * @brief Check the FBL entry condition once per boot
+ *
+ * @par Description:
+ *   The entry condition consumes the loader request in the noinit data,
+ *   so the result is kept for bmgr_init() if bmgr_fastBoot() ran before.
+ *
+ ******************************************************************************
+ */
+
+static boolean bmgr_isFblEntryRequired(T_BMGR_DATA* bmgrData)
+{
+   if(FALSE != bmgrData->entryChecked)
+   {
+      /* Already checked by the fast boot path */
+   }
+   else
+   {
+      /* Read the Application entry vector and IVT address */
+      bmgr_readAppEntry(bmgrData);
+      bmgr_readAppIvtAddr(bmgrData);
+
+      bmgrData->enterFbl = bmgr_checkFblEntryCondition(bmgrData);
+      bmgrData->entryChecked = !FALSE;
+      btl_mark(NOINIT_BTL_EVT_eAPP_CHECKED);
+   }
+   return bmgrData->enterFbl;
+}
+
+
 /*
  ******************************************************************************
  *
@@ -335,13 +378,14 @@ void bmgr_execWaitCmd(T_BMGR_DATA* bmgrData)
      * to enter application.
      */
     bcp_cancel();
+    btl_mark(NOINIT_BTL_EVT_eWAIT_CMD_END);
     bmgrData->state = BMGR_STATE_eENTER_APP;
     TRACE_BMGR_STATE("BMGR: WAIT_CMD -> ENTER_APP\n");
   }
   /* No timeout, so check whether BCP is idle */
   else if(BCP_STATUS_eIDLE != bcpStatus)
   {
-    bmgrData->timeout--;
+    /* Frame still pending, the timeout is counted by bmgr_tick() */
   }
   /* Check for job result */
   else if(BCP_JOB_RESULT_eOK != bcp_getJobResult())
@@ -426,20 +470,14 @@ void bmgr_execSendNak(T_BMGR_DATA* bmgrData)
   bcpStatus = bcp_getStatus();
 
   TRACE_BMGR_API("bmgr_execSendNak()\n");
-  if(bmgrData->timeout == 0)
-  {
-    /* Timeout exceeded.
-	 * We will return to state WAIT_CMD for further transition to ENTER_APP as
-     * soon as the tansmission of the response frame has finished.
-     */
-  }
   /* Check if a frame was received */
   if(BCP_STATUS_eIDLE != bcpStatus)
   {
     /* BCP still busy.
-     * Keep track for the timeout.
+     * The timeout is counted by bmgr_tick(). If it is exceeded, we will
+     * return to state WAIT_CMD for further transition to ENTER_APP as
+     * soon as the tansmission of the response frame has finished.
      */
-    bmgrData->timeout--;
   }
   else
   {
@@ -463,6 +501,7 @@ void bmgr_execSendNak(T_BMGR_DATA* bmgrData)
 void bmgr_execEnterFbl(T_BMGR_DATA* bmgrData)
 {
 //  TRACE_BMGR_API("BMGR: bmgr_execEnterFbl\n");
+  btl_mark(NOINIT_BTL_EVT_eENTER_FBL);
   bmgr_exit();
   fbl_enter();
 }
@@ -499,24 +538,80 @@ void bmgr_execEnterApp(T_BMGR_DATA* bmgrData)
   }
   else
   {
+    btl_mark(NOINIT_BTL_EVT_eAPP_AUTH);
+
     /* Give the UART/TRACE some time to get out all bytes */
     for(volatile int i = 0; i < 1000; i++);
     
     /* Wait till UART/TRACE is ready, disable UARTS and disable all interrupts */
     cpu_disableIRQs();
+    btl_mark(NOINIT_BTL_EVT_eENTER_APP);
+
+#if (FBL_CACHE_ENA == STD_ON)
+    /* Hand over the core in reset configuration */
+    cpu_disableDCache();
+    cpu_disableICache();
+    cpu_disableMpu();
+#endif /* (FBL_CACHE_ENA == STD_ON) */
 
     /* Jump to entry */
     bmgrData->appEntry();
   }
 
-  /* We didn't enter the application, so the authenetication failed */
-  hab_dumpStatus();
-  
+  /* We didn't enter the application, so the authenetication failed.
+   * On the fast boot path the status is dumped by bmgr_init().
+   */
+  bmgrData->authFailed = !FALSE;
+  if(FALSE != bmgrData->traceReady)
+  {
+    hab_dumpStatus();
+  }
+
   bmgrData->state = BMGR_STATE_eENTER_FBL;
   TRACE_BMGR_STATE("BMGR: WAIT_CMD -> ENTER_FBL\n");
 }
 
 
+/*
+ ******************************************************************************
+ *
+ ******************************************************************************
+ * @brief Enter a valid application without setting up the loader
+ *
+ * @param [in] hostDetected - Line activity of a host was detected
+ *
+ * @par Description:
+ *   Function is called from main() before any loader peripheral is set up.
+ *   It jumps into the application if the image is valid, no loader request
+ *   is pending and no host was detected. If a host was detected the
+ *   bootstrap request is waited for FBL_FAST_BOOT_CMD_TIMEOUT only.
+ *   The function returns if the application is not entered.
+ *
+ ******************************************************************************
+ */
+
+void bmgr_fastBoot(boolean hostDetected)
+{
+  T_BMGR_DATA* bmgrData = &bmgr_data;
+
+  if(FALSE != bmgr_isFblEntryRequired(bmgrData))
+  {
+    /* Invalid application or loader request, so enter FBL */
+  }
+  else if(FALSE != hostDetected)
+  {
+    /* A host might want to bootstrap, so give it a short chance */
+    bmgrData->cmdTimeout = FBL_FAST_BOOT_CMD_TIMEOUT;
+  }
+  else
+  {
+    /* Returns only if the authentication failed */
+    bmgr_execEnterApp(bmgrData);
+    bmgrData->enterFbl = !FALSE;
+  }
+}
+
+
 /*
  ******************************************************************************
  *
@@ -529,15 +624,33 @@ void bmgr_execEnterApp(T_BMGR_DATA* bmgrData)
 void bmgr_init(void)
 {
   T_BMGR_DATA* bmgrData = &bmgr_data;
+  boolean enterFbl;
 
    bmgrData->state = BMGR_STATE_eRESET;
+   bmgrData->traceReady = !FALSE;
    TRACE_BMGR_API("bmgr_init()\n");
 
-   /* Read the Application entry vector and IVT address */
-   bmgr_readAppEntry(bmgrData);
-   bmgr_readAppIvtAddr(bmgrData);
-   
-   if(FALSE != bmgr_checkFblEntryCondition(bmgrData))
+   if(0 == bmgrData->cmdTimeout)
+   {
+      /* Fast boot path didn't detect a host */
+      bmgrData->cmdTimeout = BMGR_CMD_TIMEOUT;
+   }
+
+   enterFbl = bmgr_isFblEntryRequired(bmgrData);
+
+   /* Output the diagnostics, which the fast boot path can't as it runs
+    * before the trace is set up.
+    */
+   if(NULL != bmgrData->appErrMsg)
+   {
+      TRACE_BMGR_INFO("BMGR: %s\n", bmgrData->appErrMsg);
+   }
+   if(FALSE != bmgrData->authFailed)
+   {
+      hab_dumpStatus();
+   }
+
+   if(FALSE != enterFbl)
    {
       /* Conditions fulfilled to directly enter FBL. */
       bmgrData->state = BMGR_STATE_eENTER_FBL;
@@ -550,7 +663,7 @@ void bmgr_init(void)
        * the application.
        */
       bmgrData->state = BMGR_STATE_eWAIT_CMD;
-      bmgrData->timeout = BMGR_CMD_TIMEOUT;
+      bmgrData->timeout = bmgrData->cmdTimeout;
       TRACE_BMGR_STATE("BMGR: RESET -> WAIT_CMD\n");
 
       /* Set BCP to listen state */
@@ -560,6 +673,35 @@ void bmgr_init(void)
 }
 
 
+/*
+ ******************************************************************************
+ * Function: bmgr_tick
+ ******************************************************************************
+ * @brief Count the bootstrap request timeout
+ *
+ * @par Description:
+ *   Called on every system tick, while bmgr_run() is called on received
+ *   or transmitted frames as well.
+ *
+ ******************************************************************************
+ */
+
+void bmgr_tick(void)
+{
+   T_BMGR_DATA* bmgrData = &bmgr_data;
+
+   if( (BMGR_STATE_eWAIT_CMD != bmgrData->state)
+    && (BMGR_STATE_eSEND_NAK != bmgrData->state) )
+   {
+      /* No bootstrap request awaited */
+   }
+   else if(bmgrData->timeout > 0)
+   {
+      bmgrData->timeout--;
+   }
+}
+
+
 /*
  ******************************************************************************
  *
@@ -1,8 +1,10 @@
 #ifndef BMGR_H
 #define BMGR_H
 
+void bmgr_fastBoot(boolean hostDetected);
 void bmgr_init(void);
 void bmgr_run(void);
+void bmgr_tick(void);
 void bmgr_exit(void);
 
 #endif /* BMGR_H */
@@ -0,0 +1,161 @@
+#ifndef BTL_C
+#define BTL_C
+#endif /* BTL_C */
+
+#include "bsp.h"
+#include "config.h"
+#include "cpu_cyc.h"
+#include "libc.h"
+#include "btl.h"
+
+
+/*
+ * Boot timeline
+ *
+ * The timeline records the cycles between boot milestones into the noinit
+ * data, so it survives the jump into the application. The application reads
+ * it at NOINIT_DATA_ADDR if the tag is valid.
+ * The timeline starts with the first milestone in main(), so the startup code
+ * running from reset up to main() is not included in the totals.
+ * Each entry holds the cycles since the previous one, which keeps entries
+ * valid across the wrap of the cycle counter as long as no single phase
+ * exceeds 2^32 cycles.
+ */
+
+static const char* btl_evtNameList[MAX_NOINIT_BTL_EVT_ID] =
+{
+  [NOINIT_BTL_EVT_eMAIN]          = "main",
+  [NOINIT_BTL_EVT_eSTD_UART_INIT] = "stdUartInit",
+  [NOINIT_BTL_EVT_eTRACE_INIT]    = "traceInit",
+  [NOINIT_BTL_EVT_eCOM_UART_INIT] = "comUartInit",
+  [NOINIT_BTL_EVT_eSYS_INIT]      = "sysInit",
+  [NOINIT_BTL_EVT_eAPP_CHECKED]   = "appChecked",
+  [NOINIT_BTL_EVT_eINIT_DONE]     = "initDone",
+  [NOINIT_BTL_EVT_eWAIT_CMD_END]  = "waitCmdEnd",
+  [NOINIT_BTL_EVT_eAPP_AUTH]      = "appAuth",
+  [NOINIT_BTL_EVT_eENTER_APP]     = "enterApp",
+  [NOINIT_BTL_EVT_eENTER_FBL]     = "enterFbl",
+};
+
+
+/*
+ ******************************************************************************
+ * Function: btl_init
+ ******************************************************************************
+ * @brief Start a new boot timeline
+ *
+ * @par Description:
+ *   Function starts the cycle counter and records the first milestone. It
+ *   shall be called as early as possible in main().
+ *
+ ******************************************************************************
+ */
+
+void btl_init(void)
+{
+  T_NOINIT_BTL* bootTl = &noinit_getData()->bootTl;
+
+  cpu_enableCycleCounter();
+
+  libc_memset(bootTl, 0, sizeof(T_NOINIT_BTL));
+  bootTl->tag = NOINIT_BTL_TAG;
+  bootTl->cpuFreq = CPU_CORE_CLK_FREQ;
+  bootTl->lastCycCnt = cpu_getCycleCount();
+
+  btl_mark(NOINIT_BTL_EVT_eMAIN);
+}
+
+
+/*
+ ******************************************************************************
+ * Function: btl_mark
+ ******************************************************************************
+ * @brief Record a boot milestone
+ *
+ * @param [in] evtID - Milestone as of enum NOINIT_BTL_EVT_ID
+ *
+ * @par Description:
+ *   Milestones are ignored if the timeline is full.
+ *
+ ******************************************************************************
+ */
+
+void btl_mark(uint32 evtID)
+{
+  T_NOINIT_BTL* bootTl = &noinit_getData()->bootTl;
+  uint32 cycCnt = cpu_getCycleCount();
+
+  if(NOINIT_BTL_TAG != bootTl->tag)
+  {
+    /* Timeline not started */
+  }
+  else if(bootTl->numEvts >= NOINIT_BTL_MAX_EVTS)
+  {
+    /* Timeline full */
+  }
+  else
+  {
+    bootTl->evts[bootTl->numEvts].evtID = evtID;
+    bootTl->evts[bootTl->numEvts].cycles = cycCnt - bootTl->lastCycCnt;
+    bootTl->numEvts++;
+    bootTl->lastCycCnt = cycCnt;
+  }
+}
+
+
+/*
+ ******************************************************************************
+ * Function: btl_getTimeline
+ ******************************************************************************
+ * @brief Get the recorded boot timeline
+ *
+ ******************************************************************************
+ */
+
+const T_NOINIT_BTL* btl_getTimeline(void)
+{
+  return &noinit_getData()->bootTl;
+}
+
+
+/*
+ ******************************************************************************
+ * Function: btl_dump
+ ******************************************************************************
+ * @brief Print the boot timeline
+ *
+ * @par Description:
+ *   Every milestone is printed with the microseconds of its phase and the
+ *   microseconds elapsed since the first milestone in main().
+ *
+ ******************************************************************************
+ */
+
+void btl_dump(void)
+{
+  const T_NOINIT_BTL* bootTl = btl_getTimeline();
+  uint32 cyclesPerUs = bootTl->cpuFreq / 1000000u;
+  uint32 totalUs = 0;
+  uint32 phaseUs;
+  uint32 evtID;
+  uint32 i;
+
+  if( (NOINIT_BTL_TAG != bootTl->tag) || (cyclesPerUs == 0) )
+  {
+    libc_puts("No boot timeline recorded\n");
+  }
+  else
+  {
+    libc_printf("Milestone        Phase[us]   Total[us]\n");
+    for(i = 0; (i < bootTl->numEvts) && (i < NOINIT_BTL_MAX_EVTS); i++)
+    {
+      evtID = bootTl->evts[i].evtID;
+      phaseUs = bootTl->evts[i].cycles / cyclesPerUs;
+      totalUs += phaseUs;
+      libc_printf("%-14s %11u %11u\n",
+                  (evtID < MAX_NOINIT_BTL_EVT_ID) ? btl_evtNameList[evtID] : "?",
+                  phaseUs,
+                  totalUs);
+    }
+  }
+}
@@ -0,0 +1,11 @@
+#ifndef BTL_H
+#define BTL_H
+
+#include "noinit.h"
+
+extern void btl_init(void);
+extern void btl_mark(uint32 evtID);
+extern const T_NOINIT_BTL* btl_getTimeline(void);
+extern void btl_dump(void);
+
+#endif /* BTL_H */
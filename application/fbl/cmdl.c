@@ -19,6 +19,11 @@
 #include "hab_api.h"
 #include "hab_info.h"
 #include "target_cfg.h"
+#include "sched.h"
+#include "prof.h"
+#include "btl.h"
+#include "cpu_cache.h"
+#include "cpu_mpu.h"
 
 #include "cmdl.h"
 
@@ -70,6 +75,8 @@ static int cmdl_helpCmd(const char* argStr)
   libc_puts("habCheck .. Check HAB status\n");
   libc_puts("habStatus .. Show HAB status\n");
   libc_puts("cpuID .. Show CPU UID\n");
+  libc_puts("perf .. Show cycle counts, 'perf reset' clears them\n");
+  libc_puts("bootTl .. Show boot timeline\n");
   
   return 0;
 }
@@ -187,6 +194,26 @@ static int cmdl_appInfoCmd(const char* argStr)
 }
 
 
+/*
+ ******************************************************************************
+ *
+ ******************************************************************************
+ *
+ *
+ ******************************************************************************
+ */
+
+static void cmdl_prepareRomEntry(void)
+{
+#if (FBL_CACHE_ENA == STD_ON)
+  /* ROM expects the core in reset configuration */
+  cpu_disableDCache();
+  cpu_disableICache();
+  cpu_disableMpu();
+#endif /* (FBL_CACHE_ENA == STD_ON) */
+}
+
+
 /*
  ******************************************************************************
  *
@@ -202,6 +229,7 @@ static int cmdl_sdpUsbCmd(const char* argStr)
   T_ROM_API* romApi;
   uint32 arg = BOOT_API_ENTER_SDP_ON_USB;
   
+  cmdl_prepareRomEntry();
   romApi = romApi_getAddr();
   romApi->bootApi(&arg);
   return 0;
@@ -223,6 +251,7 @@ static int cmdl_sdpUartCmd(const char* argStr)
   T_ROM_API* romApi;
   uint32 arg = BOOT_API_ENTER_SDP_ON_UART;
   
+  cmdl_prepareRomEntry();
   romApi = romApi_getAddr();
   romApi->bootApi(&arg);
   return 0;
@@ -734,6 +763,69 @@ static int cmdl_habStatusCmd(const char* argStr)
 }
 
 
+/*
+ ******************************************************************************
+ *
+ ******************************************************************************
+ *
+ *
+ ******************************************************************************
+ */
+
+static int cmdl_perfCmd(const char* argStr)
+{
+  const T_SCHED_TASK* task;
+  uint32 taskID;
+
+  /* Skip argument delimiter */
+  while(*argStr == ' ')
+  {
+    argStr++;
+  }
+
+  /* Compare only an argument of the keyword's length, so no byte behind it is read */
+  if( (libc_strlen(argStr) == (sizeof("reset") - 1))
+   && (0 == libc_memcmp(argStr, "reset", sizeof("reset") - 1)) )
+  {
+    prof_clear();
+    sched_clrStats();
+    libc_puts("Cycle counts cleared\n");
+  }
+  else
+  {
+    prof_dump();
+
+    libc_printf("Task         Runs       Last       Max\n");
+    taskID = 0;
+    task = sched_getTask(taskID);
+    while(NULL != task)
+    {
+      libc_printf("%-12s %10u %10u %10u\n", task->name, task->runCnt, task->cycLast, task->cycMax);
+      taskID++;
+      task = sched_getTask(taskID);
+    }
+    libc_printf("Sleep: %u kCycles\n", (uint32)(sched_getSleepCycles() >> 10));
+  }
+  return 0;
+}
+
+
+/*
+ ******************************************************************************
+ *
+ ******************************************************************************
+ *
+ *
+ ******************************************************************************
+ */
+
+static int cmdl_bootTlCmd(const char* argStr)
+{
+  btl_dump();
+  return 0;
+}
+
+
 /*
  ******************************************************************************
  *
@@ -791,6 +883,8 @@ static T_CLI_ENTRY cmdl_cmdTable[] =
   {"wrSecJtag", &cmdl_wrSecJtagCmd},
   {"wrDisJtag", &cmdl_wrDisJtagCmd},
   {"wrDisSjc", &cmdl_wrDisSjcCmd},
+  {"perf", &cmdl_perfCmd},
+  {"bootTl", &cmdl_bootTlCmd},
   {"\\*", &cmdl_unknownCmd},
   {NULL,   NULL},
 };
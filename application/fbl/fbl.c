@@ -3,10 +3,13 @@
 #endif /* FBL_C */
 
 #include "bsp.h"
+#include "config.h"
 
 #include "trace_pub.h"
 #include "rom_api.h"
 #include "ext_flash.h"
+#include "dcp.h"
+#include "uart.h"
 #include "libc.h"
 #include "pdu.h"
 #include "bcp.h"
@@ -31,6 +34,90 @@
 #define TRACE_FBL_STATE(...) /* empty */
 #endif /* (TRC_FEAT_FBL_ENA) */
 
+/* Time in ms to receive a valid frame after switching the baud rate */
+#define FBL_BAUDRATE_TIMEOUT 1000u
+
+/* DCP channel computing the block digests */
+#define FBL_DCP_HASH_CHAN 0
+
+/* Hash block size of SHA-256 */
+#define FBL_HASH_CHUNK_SIZE 64u
+
+/* Features announced by the capabilities */
+#define FBL_CAP_FEATURES ( FBL_CAP_FEAT_BAUDRATE | FBL_CAP_FEAT_DIGEST | FBL_CAP_FEAT_FILL                \
+                         | ((FBL_STAGE_ENA == STD_ON) ? (FBL_CAP_FEAT_STAGE | FBL_CAP_FEAT_STREAM) : 0) \
+                         | ((FBL_RESUME_ENA == STD_ON) ? FBL_CAP_FEAT_RESUME : 0)                     \
+                         | ((FBL_LAZY_ERASE == STD_ON) ? FBL_CAP_FEAT_LAZY_ERASE : 0)                 \
+                         | ((FBL_WRITE_AVOID == STD_ON) ? FBL_CAP_FEAT_WRITE_AVOID : 0) )
+
+#if (FBL_STAGE_ENA == STD_ON)
+#if (FBL_STAGE_SIZE > (FBL_WINDOW_MAX_BLKS * FBL_BLK_SIZE))
+#error "FBL_WINDOW_MAX_BLKS doesn't cover the staging arena"
+#endif
+
+/* Staging arena, placed into the OCRAM part of the FlexRAM */
+#define __stage_bss __attribute__((section(".stageBss")))
+#endif /* (FBL_STAGE_ENA == STD_ON) */
+
+#if (FBL_LAZY_ERASE == STD_ON)
+/* Sectors of the application region tracked by the erase map */
+#define FBL_ERASE_MAP_SECTORS (FBL_APP_MAX_SIZE / FLASH_ERASE_SECTOR_SIZE)
+#define FBL_ERASE_MAP_WORDS   ((FBL_ERASE_MAP_SECTORS + 31) / 32)
+#endif /* (FBL_LAZY_ERASE == STD_ON) */
+
+#if (FBL_WRITE_AVOID == STD_ON)
+#if (FBL_LAZY_ERASE != STD_ON)
+#error "FBL_WRITE_AVOID requires FBL_LAZY_ERASE"
+#endif
+
+/* Blocks of the application region tracked by the block map */
+#define FBL_BLK_MAP_WORDS     (((FBL_APP_MAX_SIZE / FBL_BLK_SIZE) + 31) / 32)
+#define FBL_SECT_BLKS         (FLASH_ERASE_SECTOR_SIZE / FBL_BLK_SIZE)
+
+/* Result of comparing a block against the flash content */
+typedef enum FBL_BLK_CMP
+{
+  FBL_BLK_CMP_eEQUAL = 0,  /* Nothing to program */
+  FBL_BLK_CMP_ePROGRAM,    /* Bits to be cleared only */
+  FBL_BLK_CMP_eERASE,      /* Bits to be set, so the sector needs an erase */
+}T_FBL_BLK_CMP;
+
+typedef struct
+{
+  uint32 blkSkipped;   /* Blocks matching the flash content */
+  uint32 blkProgOnly;  /* Blocks programmed into a sector not erased */
+  uint32 sectErased;   /* Sectors of the erase region erased */
+  uint32 sectKept;     /* Sectors of the erase region not erased */
+}T_FBL_WRITE_STATS;
+#endif /* (FBL_WRITE_AVOID == STD_ON) */
+
+#if (FBL_RESUME_ENA == STD_ON)
+#if (FBL_RESUME_MAX_BLKS < (FBL_APP_MAX_SIZE / FBL_BLK_SIZE))
+#error "FBL_RESUME_MAX_BLKS doesn't cover the application region"
+#endif
+
+/* Journal tag "FJR1" */
+#define FBL_JRNL_TAG 0x31524A46
+
+/* Download journal at FBL_JOURNAL_ADDR
+ * The journal sector is erased when a download starts. Afterwards fields
+ * are programmed from the blank value only and the bit of each verified
+ * block is cleared in the map, so the journal is appended to without an
+ * erase. The tag is programmed last and cleared on activation.
+ */
+typedef struct
+{
+  uint32 tag;
+  uint32 sessionID;
+  uint32 imgAddr;
+  uint32 imgSize;
+  uint8  imgDigest[FBL_RESUME_DIGEST_SIZE];
+  uint32 entryVect;
+  uint32 entryVectInv;
+  uint32 blkMap[FBL_RESUME_MAP_WORDS]; /* Bit cleared for each verified block, bit 0 at imgAddr */
+}T_FBL_JRNL;
+#endif /* (FBL_RESUME_ENA == STD_ON) */
+
 
 typedef enum FBL_STATE
 {
@@ -51,11 +138,59 @@ typedef struct
   uint32 entryVect;
   uint32 entryVectInv;
   uint16 timeCnt;
+  uint16 baudTimeCnt;  /* Countdown to fall back to prevBaudrate, 0 if confirmed */
+  uint16 baudTimeout;  /* Countdown value for the requested baud rate */
+  uint32 newBaudrate;  /* Baud rate to be set up after the response, 0 if none */
+  uint32 prevBaudrate; /* Baud rate to fall back to */
+#if (FBL_LAZY_ERASE == STD_ON)
+  uint32 eraseMap[FBL_ERASE_MAP_WORDS]; /* Sectors pending to be erased, bit 0 at FBL_APP_START_ADDR */
+  uint32 eraseEnd;     /* Sector index behind the erase region */
+  uint32 writeSect;    /* Sector index next to the recently programmed one */
+  uint32 eraseJobSect; /* Sector erased ahead by the running flash job */
+  boolean eraseJobEna; /* A sector is erased ahead by a flash job */
+#endif /* (FBL_LAZY_ERASE == STD_ON) */
+#if (FBL_WRITE_AVOID == STD_ON)
+  uint32 blkMap[FBL_BLK_MAP_WORDS]; /* Blocks of pending sectors holding the image, bit 0 at FBL_APP_START_ADDR */
+  uint32 sectBuf[FLASH_ERASE_SECTOR_SIZE / sizeof(uint32)]; /* Blocks saved across a sector erase */
+  boolean eraseAheadEna; /* Recent block needed an erase, so the image differs from the flash */
+  T_FBL_WRITE_STATS stats;
+#endif /* (FBL_WRITE_AVOID == STD_ON) */
+  uint32 fillBuf[FBL_BLK_SIZE / sizeof(uint32)]; /* Block of a fill pattern */
+#if (FBL_STAGE_ENA == STD_ON)
+  uint32 stageAddr;    /* Flash address of the staged window */
+  uint32 stageLen;     /* Bytes staged, 0 if none */
+  uint32 winSize;      /* Size of the streamed window at stageAddr, 0 if none */
+  uint32 winMap[FBL_WINDOW_MAP_WORDS]; /* Blocks of the window received */
+  boolean streamEna;   /* Recent request was a stream request */
+#endif /* (FBL_STAGE_ENA == STD_ON) */
+#if (FBL_RESUME_ENA == STD_ON)
+  boolean jrnlOpen;    /* Download progress is journaled */
+#endif /* (FBL_RESUME_ENA == STD_ON) */
   T_FBL_STATE state;
 }T_FBL_DATA;
 
 static T_FBL_DATA fbl_dataTbl[1];
 
+#if (FBL_STAGE_ENA == STD_ON)
+__stage_bss static uint32 fbl_stageBuf[FBL_STAGE_SIZE / sizeof(uint32)];
+#endif /* (FBL_STAGE_ENA == STD_ON) */
+
+static T_DCP_CFG fbl_dcpCfg =
+{
+  .gatherResidualWrites = !FALSE,
+  .enableContextCaching = !FALSE,
+  .enableContextSwitching = FALSE,
+  .enableChannel = (1u << FBL_DCP_HASH_CHAN),
+  .enableChannelInterrupt = 0,
+};
+
+static T_DCP_CHAN_CFG fbl_dcpHashCfg =
+{
+  .opc = DCP_OPC_eHASH,
+  .swapCfg = 0,
+  .algo = DCP_HASH_ALGO_eSHA256,
+};
+
 
 void fbl_sendSwInfoRsp(void)
 {
@@ -181,13 +316,2129 @@ uint32 fbl_procBootstrapMsg(T_FBL_DATA* fblData, T_PDU* msgPdu)
   /* Check for correct message contents */
   else if(0 != libc_memcmp(&reqMsg->bootMagic, expToken, sizeof(reqMsg->bootMagic)))
   {
-    TRACE_FBL_INFO("FBL: Invalid token\n");
-    errCode = BCP_ERR_ID_eINVALID_DATA;
+    TRACE_FBL_INFO("FBL: Invalid token\n");
+    errCode = BCP_ERR_ID_eINVALID_DATA;
+  }
+  else
+  {
+    /* Valid bootstrap command received */
+    TRACE_FBL_INFO("FBL: Valid bootstrap\n");
+  }
+  return errCode;
+}
+
+
+/*
+ ******************************************************************************
+ *
+ ******************************************************************************
+ *
+ *
+ ******************************************************************************
+ */
+
+uint32 fbl_procSwInfoMsg(T_FBL_DATA* fblData, T_PDU* reqPdu)
+{
+  uint32 errCode = BCP_ERR_ID_eNONE;
+
+  (void)fblData;
+
+  /* Check for correct size of expected message */
+  if(reqPdu->len != sizeof(T_FBL_MSG_SWINFO_REQ))
+  {
+    /* Unexpected size */
+    TRACE_FBL_INFO("FBL: Unexpected size %d\n", reqPdu->len);
+    errCode = BCP_ERR_ID_eINVALID_SIZE;
+  }
+  else
+  {
+    /* Valid SW info command received */
+    TRACE_FBL_INFO("FBL: Valid swInfo request\n");
+  }
+  return errCode;
+}
+
+
+/*
+ ******************************************************************************
+ * Function: fbl_procCapsMsg
+ ******************************************************************************
+ * @brief Check a capabilities request
+ *
+ ******************************************************************************
+ */
+
+uint32 fbl_procCapsMsg(T_FBL_DATA* fblData, T_PDU* reqPdu)
+{
+  uint32 errCode = BCP_ERR_ID_eNONE;
+
+  (void)fblData;
+
+  /* Check for correct size of expected message */
+  if(reqPdu->len != sizeof(T_FBL_MSG_CAPS_REQ))
+  {
+    /* Unexpected size */
+    TRACE_FBL_INFO("FBL: Unexpected size %d\n", reqPdu->len);
+    errCode = BCP_ERR_ID_eINVALID_SIZE;
+  }
+  else
+  {
+    TRACE_FBL_INFO("FBL: Valid capabilities request\n");
+  }
+  return errCode;
+}
+
+
+/*
+ ******************************************************************************
+ * Function: fbl_putCap
+ ******************************************************************************
+ * @brief Append a capability TLV
+ *
+ * @return Length of the TLVs including the appended one
+ *
+ ******************************************************************************
+ */
+
+static uint32 fbl_putCap(uint8 tlvBuf[], uint32 tlvLen, uint8 tag, uint32 value, uint8 valueLen)
+{
+  uint8 byteIdx;
+
+  tlvBuf[tlvLen++] = tag;
+  tlvBuf[tlvLen++] = valueLen;
+  for(byteIdx = 0; byteIdx < valueLen; byteIdx++)
+  {
+    tlvBuf[tlvLen++] = (uint8)(value >> (8 * byteIdx));
+  }
+  return tlvLen;
+}
+
+
+/*
+ ******************************************************************************
+ * Function: fbl_sendCapsRsp
+ ******************************************************************************
+ * @brief Send the capabilities
+ *
+ * @par Description:
+ *   The capabilities follow the build configuration, except for the page
+ *   size, which is discovered from the device.
+ *
+ ******************************************************************************
+ */
+
+void fbl_sendCapsRsp(void)
+{
+  T_FBL_MSG_CAPS_RSP* rspMsg = NULL;
+  T_PDU  rspPdu;
+  uint32 tlvLen = 0;
+
+  if(STATUS_eOK != bcp_allocTxPdu(&rspPdu))
+  {
+    TRACE_FBL_ERROR("FBL Error\n");
+  }
+  else
+  {
+    rspMsg = (T_FBL_MSG_CAPS_RSP*)rspPdu.data;
+    rspMsg->msgType = FBL_MSG_ID_eCAPS_RSP;
+
+    tlvLen = fbl_putCap(rspMsg->tlv, tlvLen, FBL_CAP_TAG_ePROTO_VERSION, FBL_PROTO_VERSION, sizeof(uint16));
+    tlvLen = fbl_putCap(rspMsg->tlv, tlvLen, FBL_CAP_TAG_eFEATURES, FBL_CAP_FEATURES, sizeof(uint32));
+    tlvLen = fbl_putCap(rspMsg->tlv, tlvLen, FBL_CAP_TAG_eBLK_SIZE, FBL_BLK_SIZE, sizeof(uint32));
+#if (FBL_STAGE_ENA == STD_ON)
+    tlvLen = fbl_putCap(rspMsg->tlv, tlvLen, FBL_CAP_TAG_eWINDOW_SIZE, sizeof(fbl_stageBuf), sizeof(uint32));
+#endif /* (FBL_STAGE_ENA == STD_ON) */
+    tlvLen = fbl_putCap(rspMsg->tlv, tlvLen, FBL_CAP_TAG_eDIGEST_SIZE, FBL_DIGEST_SIZE, sizeof(uint8));
+    tlvLen = fbl_putCap(rspMsg->tlv, tlvLen, FBL_CAP_TAG_eDIGEST_MAX_BLKS, FBL_DIGEST_MAX_BLKS, sizeof(uint16));
+    tlvLen = fbl_putCap(rspMsg->tlv, tlvLen, FBL_CAP_TAG_eAPP_START, FBL_APP_START_ADDR, sizeof(uint32));
+    tlvLen = fbl_putCap(rspMsg->tlv, tlvLen, FBL_CAP_TAG_eAPP_MAX_SIZE, FBL_APP_MAX_SIZE, sizeof(uint32));
+    tlvLen = fbl_putCap(rspMsg->tlv, tlvLen, FBL_CAP_TAG_eERASE_SIZE, FLASH_ERASE_SECTOR_SIZE, sizeof(uint32));
+    tlvLen = fbl_putCap(rspMsg->tlv, tlvLen, FBL_CAP_TAG_ePAGE_SIZE, extflash_getPageSize(), sizeof(uint32));
+    tlvLen = fbl_putCap(rspMsg->tlv, tlvLen, FBL_CAP_TAG_eMAX_BAUDRATE, FBL_MAX_BAUDRATE, sizeof(uint32));
+
+    rspPdu.len = offsetof(T_FBL_MSG_CAPS_RSP, tlv) + tlvLen;
+  }
+
+  if(NULL == rspMsg)
+  {
+    /* */
+  }
+  else if(STATUS_eOK != bcp_sendMsg(&rspPdu))
+  {
+    TRACE_FBL_ERROR("FBL Error\n");
+  }
+}
+
+
+/*
+ ******************************************************************************
+ *
+ ******************************************************************************
+ *
+ *
+ ******************************************************************************
+ */
+
+uint32 fbl_procInvalidateMsg(T_FBL_DATA* fblData, T_PDU* reqPdu)
+{
+  T_FBL_MSG_INVALIDATE_REQ* reqMsg = (T_FBL_MSG_INVALIDATE_REQ*)reqPdu->data;
+  uint32 errCode = BCP_ERR_ID_eNONE;
+
+  // TODO: Handle update sequence state checking
+  
+  /* Check for correct size of expected message */
+  if(reqPdu->len != sizeof(T_FBL_MSG_INVALIDATE_REQ))
+  {
+    /* Unexpected size */
+    TRACE_FBL_INFO("FBL: Unexpected size %d\n", reqPdu->len);
+    errCode = BCP_ERR_ID_eINVALID_SIZE;
+  }
+  else if(reqMsg->blkAddr < FBL_APP_START_ADDR)
+  {
+    /* Invalid application start address */
+    errCode = BCP_ERR_ID_eINVALID_DATA;
+  }
+  else if(0 != (reqMsg->blkAddr & (FBL_ALIGN_SIZE - 1)))
+  {
+    /* Improper alignment of start address */
+    errCode = BCP_ERR_ID_eINVALID_DATA;
+  }
+  else if(reqMsg->blkSize < FBL_ALIGN_SIZE)
+  {
+    /* Invalid size */
+    errCode = BCP_ERR_ID_eINVALID_DATA;
+  }
+  else if(0 != (reqMsg->blkSize & (FBL_ALIGN_SIZE - 1)))
+  {
+    /* Improper alignment of size */
+    errCode = BCP_ERR_ID_eINVALID_DATA;
+  }
+  else if((reqMsg->blkAddr + reqMsg->blkSize) >= FBL_APP_END_ADDR)
+  {
+    /* Invalid end address */
+    errCode = BCP_ERR_ID_eINVALID_DATA;
+  }
+  /* The update sequence starts here, so open the flash session once */
+  else if(STATUS_eOK != extflash_open())
+  {
+    /* Flash device not accessible */
+    errCode = BCP_ERR_ID_eINCONSISTENT;
+  }
+  else
+  {
+    uint32 logAddr = FBL_APP_ENTRY_ADDR - FBL_FLASH_BASE_ADDR;
+    uint8  invalidSignValue[sizeof(fblData->entryVect)] = { 0 };
+
+    TRACE_FBL_INFO("FBL: Valid invalidate request\n");
+    (void)extflash_write(logAddr, invalidSignValue, FLASH_WRITE_PAGE_SIZE);
+    fblData->imgAddr = reqMsg->blkAddr;
+    fblData->imgSize = reqMsg->blkSize;
+  }
+  return errCode;
+}
+
+
+/*
+ ******************************************************************************
+ *
+ ******************************************************************************
+ *
+ *
+ ******************************************************************************
+ */
+
+static T_STATUS fbl_eraseRegion(uint32 logAddr, uint32 numBytes)
+{
+  T_STATUS result = STATUS_eOK;
+  uint32 sectAddr = logAddr & ~(FLASH_ERASE_SECTOR_SIZE - 1);
+  uint32 endAddr = (logAddr + numBytes + FLASH_ERASE_SECTOR_SIZE - 1) & ~(FLASH_ERASE_SECTOR_SIZE - 1);
+  uint32 runAddr = sectAddr;
+
+  /* Erase runs of sectors, which are not blank, with a single call */
+  while( (sectAddr < endAddr) && (STATUS_eOK == result) )
+  {
+    if(FALSE != extflash_isBlank(sectAddr, FLASH_ERASE_SECTOR_SIZE))
+    {
+      /* Sector is blank, so erase the pending run before it */
+      if(runAddr < sectAddr)
+      {
+        result = extflash_erase(runAddr, sectAddr - runAddr);
+      }
+      runAddr = sectAddr + FLASH_ERASE_SECTOR_SIZE;
+    }
+    sectAddr += FLASH_ERASE_SECTOR_SIZE;
+  }
+
+  if( (STATUS_eOK == result) && (runAddr < endAddr) )
+  {
+    /* Erase the run up to the end of the region */
+    result = extflash_erase(runAddr, endAddr - runAddr);
+  }
+  return result;
+}
+
+
+#if (FBL_LAZY_ERASE == STD_ON)
+/*
+ ******************************************************************************
+ * Function: fbl_deferErase
+ ******************************************************************************
+ * @brief Mark the sectors of a region to be erased later on
+ *
+ * @par Description:
+ *   The sectors are erased on the first program into them or ahead of the
+ *   write pointer while the next request is received, so the erase time is
+ *   hidden behind the transfer time.
+ *
+ * @return FALSE if the region exceeds the erase map and is to be erased now
+ *
+ ******************************************************************************
+ */
+
+static boolean fbl_deferErase(T_FBL_DATA* fblData, uint32 addr, uint32 numBytes)
+{
+  boolean result = FALSE;
+  uint32 sectIdx = (addr - FBL_APP_START_ADDR) / FLASH_ERASE_SECTOR_SIZE;
+  uint32 endIdx = ((addr - FBL_APP_START_ADDR) + numBytes + FLASH_ERASE_SECTOR_SIZE - 1) / FLASH_ERASE_SECTOR_SIZE;
+
+  libc_memset(fblData->eraseMap, 0, sizeof(fblData->eraseMap));
+  fblData->eraseEnd = 0;
+  fblData->writeSect = sectIdx;
+#if (FBL_WRITE_AVOID == STD_ON)
+  libc_memset(fblData->blkMap, 0, sizeof(fblData->blkMap));
+  libc_memset(&fblData->stats, 0, sizeof(fblData->stats));
+  fblData->eraseAheadEna = FALSE;
+#endif /* (FBL_WRITE_AVOID == STD_ON) */
+
+  if(addr < FBL_APP_START_ADDR)
+  {
+    /* Region outside of the erase map */
+  }
+  else if(endIdx > FBL_ERASE_MAP_SECTORS)
+  {
+    /* Region exceeds the erase map */
+  }
+  else
+  {
+    for(; sectIdx < endIdx; sectIdx++)
+    {
+      fblData->eraseMap[sectIdx / 32] |= (1u << (sectIdx % 32));
+    }
+    fblData->eraseEnd = endIdx;
+    result = !FALSE;
+  }
+  return result;
+}
+
+
+/*
+ ******************************************************************************
+ * Function: fbl_isErasePending
+ ******************************************************************************
+ * @brief Check, if a sector of the erase region has not been erased yet
+ *
+ ******************************************************************************
+ */
+
+static boolean fbl_isErasePending(T_FBL_DATA* fblData, uint32 sectIdx)
+{
+  return ( (sectIdx < fblData->eraseEnd)
+        && (0 != (fblData->eraseMap[sectIdx / 32] & (1u << (sectIdx % 32)))) );
+}
+
+
+#if (FBL_WRITE_AVOID == STD_ON)
+/*
+ ******************************************************************************
+ * Function: fbl_isBlkDone
+ ******************************************************************************
+ * @brief Check, if a block of a pending sector holds the image already
+ *
+ ******************************************************************************
+ */
+
+static boolean fbl_isBlkDone(T_FBL_DATA* fblData, uint32 blkIdx)
+{
+  return (0 != (fblData->blkMap[blkIdx / 32] & (1u << (blkIdx % 32))));
+}
+
+
+/*
+ ******************************************************************************
+ * Function: fbl_compareBlock
+ ******************************************************************************
+ * @brief Compare a block against the flash content over the mapped window
+ *
+ ******************************************************************************
+ */
+
+static T_FBL_BLK_CMP fbl_compareBlock(uint32 blkAddr, const uint8 blkData[])
+{
+  T_FBL_BLK_CMP result = FBL_BLK_CMP_eEQUAL;
+  const uint32* flashPtr = (const uint32*)blkAddr;
+  const uint32* dataPtr = (const uint32*)(const void*)blkData;
+  uint32 wordIdx;
+
+  for(wordIdx = 0; (wordIdx < (FBL_BLK_SIZE / sizeof(uint32))) && (FBL_BLK_CMP_eERASE != result); wordIdx++)
+  {
+    if(flashPtr[wordIdx] == dataPtr[wordIdx])
+    {
+      /* Word matches */
+    }
+    else if(0 != (dataPtr[wordIdx] & ~flashPtr[wordIdx]))
+    {
+      /* Programming can't set bits */
+      result = FBL_BLK_CMP_eERASE;
+    }
+    else
+    {
+      result = FBL_BLK_CMP_ePROGRAM;
+    }
+  }
+  return result;
+}
+
+
+/*
+ ******************************************************************************
+ * Function: fbl_isSectorDone
+ ******************************************************************************
+ * @brief Check, if a pending sector needs no erase
+ *
+ * @par Description:
+ *   A sector needs no erase, if each block either holds the image already
+ *   or is blank.
+ *
+ ******************************************************************************
+ */
+
+static boolean fbl_isSectorDone(T_FBL_DATA* fblData, uint32 sectIdx)
+{
+  boolean result = !FALSE;
+  uint32 blkIdx = sectIdx * FBL_SECT_BLKS;
+  uint32 logAddr = (FBL_APP_START_ADDR - FBL_FLASH_BASE_ADDR) + (blkIdx * FBL_BLK_SIZE);
+  uint32 blkCnt;
+
+  for(blkCnt = 0; (blkCnt < FBL_SECT_BLKS) && (FALSE != result); blkCnt++)
+  {
+    if( (FALSE == fbl_isBlkDone(fblData, blkIdx + blkCnt))
+     && (FALSE == extflash_isBlank(logAddr + (blkCnt * FBL_BLK_SIZE), FBL_BLK_SIZE)) )
+    {
+      result = FALSE;
+    }
+  }
+  return result;
+}
+
+
+/*
+ ******************************************************************************
+ * Function: fbl_eraseKeepBlocks
+ ******************************************************************************
+ * @brief Erase a sector and restore the blocks holding the image already
+ *
+ ******************************************************************************
+ */
+
+static T_STATUS fbl_eraseKeepBlocks(T_FBL_DATA* fblData, uint32 sectIdx)
+{
+  T_STATUS result;
+  uint32 blkIdx = sectIdx * FBL_SECT_BLKS;
+  uint32 logAddr = (FBL_APP_START_ADDR - FBL_FLASH_BASE_ADDR) + (sectIdx * FLASH_ERASE_SECTOR_SIZE);
+  const uint8* sectPtr = (const uint8*)(FBL_APP_START_ADDR + (sectIdx * FLASH_ERASE_SECTOR_SIZE));
+  uint8* bufPtr = (uint8*)(void*)fblData->sectBuf;
+  uint32 blkCnt;
+
+  for(blkCnt = 0; blkCnt < FBL_SECT_BLKS; blkCnt++)
+  {
+    if(FALSE != fbl_isBlkDone(fblData, blkIdx + blkCnt))
+    {
+      libc_memcpy(&bufPtr[blkCnt * FBL_BLK_SIZE], &sectPtr[blkCnt * FBL_BLK_SIZE], FBL_BLK_SIZE);
+    }
+  }
+
+  result = fbl_eraseRegion(logAddr, FLASH_ERASE_SECTOR_SIZE);
+
+  for(blkCnt = 0; (blkCnt < FBL_SECT_BLKS) && (STATUS_eOK == result); blkCnt++)
+  {
+    if(FALSE != fbl_isBlkDone(fblData, blkIdx + blkCnt))
+    {
+      result = extflash_write(logAddr + (blkCnt * FBL_BLK_SIZE), &bufPtr[blkCnt * FBL_BLK_SIZE], FBL_BLK_SIZE);
+    }
+  }
+  return result;
+}
+#endif /* (FBL_WRITE_AVOID == STD_ON) */
+
+
+/*
+ ******************************************************************************
+ * Function: fbl_eraseSector
+ ******************************************************************************
+ * @brief Erase a sector of the erase map, if it is pending to be erased
+ *
+ * @par Description:
+ *   With write avoidance, a sector whose blocks hold the image already or
+ *   are blank isn't erased. Otherwise the blocks holding the image are
+ *   restored after the erase.
+ *
+ ******************************************************************************
+ */
+
+static T_STATUS fbl_eraseSector(T_FBL_DATA* fblData, uint32 sectIdx)
+{
+  T_STATUS result = STATUS_eOK;
+#if (FBL_WRITE_AVOID != STD_ON)
+  uint32 logAddr = (FBL_APP_START_ADDR - FBL_FLASH_BASE_ADDR) + (sectIdx * FLASH_ERASE_SECTOR_SIZE);
+#endif /* (FBL_WRITE_AVOID != STD_ON) */
+
+  if(FALSE == fbl_isErasePending(fblData, sectIdx))
+  {
+    /* Sector outside of the erase region or already erased */
+  }
+#if (FBL_WRITE_AVOID == STD_ON)
+  else if(FALSE != fbl_isSectorDone(fblData, sectIdx))
+  {
+    fblData->eraseMap[sectIdx / 32] &= ~(1u << (sectIdx % 32));
+    fblData->stats.sectKept++;
+  }
+  else if(STATUS_eOK != (result = fbl_eraseKeepBlocks(fblData, sectIdx)))
+  {
+    /* Erase failed, keep the sector pending */
+  }
+  else
+  {
+    fblData->eraseMap[sectIdx / 32] &= ~(1u << (sectIdx % 32));
+    fblData->stats.sectErased++;
+  }
+#else /* (FBL_WRITE_AVOID != STD_ON) */
+  else if(STATUS_eOK != (result = fbl_eraseRegion(logAddr, FLASH_ERASE_SECTOR_SIZE)))
+  {
+    /* Erase failed, keep the sector pending */
+  }
+  else
+  {
+    fblData->eraseMap[sectIdx / 32] &= ~(1u << (sectIdx % 32));
+  }
+#endif /* (FBL_WRITE_AVOID) */
+  return result;
+}
+
+
+#if (FBL_WRITE_AVOID == STD_ON)
+/*
+ ******************************************************************************
+ * Function: fbl_hasDoneBlocks
+ ******************************************************************************
+ * @brief Check, if any block of a pending sector holds the image already
+ *
+ ******************************************************************************
+ */
+
+static boolean fbl_hasDoneBlocks(T_FBL_DATA* fblData, uint32 sectIdx)
+{
+  boolean result = FALSE;
+  uint32 blkIdx = sectIdx * FBL_SECT_BLKS;
+  uint32 blkCnt;
+
+  for(blkCnt = 0; (blkCnt < FBL_SECT_BLKS) && (FALSE == result); blkCnt++)
+  {
+    result = fbl_isBlkDone(fblData, blkIdx + blkCnt);
+  }
+  return result;
+}
+#endif /* (FBL_WRITE_AVOID == STD_ON) */
+
+
+/*
+ ******************************************************************************
+ * Function: fbl_pollEraseJob
+ ******************************************************************************
+ * @brief Poll the sector erase running ahead and account its completion
+ *
+ * @par Description:
+ *   The sector is taken off the erase map, once the job succeeded. A
+ *   failed erase keeps the sector pending, so it is retried on the program
+ *   request.
+ *
+ ******************************************************************************
+ */
+
+static void fbl_pollEraseJob(T_FBL_DATA* fblData)
+{
+  uint32 sectIdx = fblData->eraseJobSect;
+
+  if(FALSE == fblData->eraseJobEna)
+  {
+    /* No sector erased ahead */
+  }
+  else
+  {
+    extflash_run();
+
+    if(EXTFLASH_STATUS_eIDLE != extflash_getStatus())
+    {
+      /* Sector erase still running */
+    }
+    else if(EXTFLASH_JOB_RESULT_eOK != extflash_getJobResult())
+    {
+      TRACE_FBL_ERROR("FBL: Erase ahead of sector %d failed\n", sectIdx);
+      fblData->eraseJobEna = FALSE;
+    }
+    else
+    {
+      fblData->eraseMap[sectIdx / 32] &= ~(1u << (sectIdx % 32));
+#if (FBL_WRITE_AVOID == STD_ON)
+      fblData->stats.sectErased++;
+#endif /* (FBL_WRITE_AVOID == STD_ON) */
+      fblData->eraseJobEna = FALSE;
+    }
+  }
+}
+
+
+/*
+ ******************************************************************************
+ * Function: fbl_finishEraseAhead
+ ******************************************************************************
+ * @brief Wait for the sector erase running ahead to complete
+ *
+ * @par Description:
+ *   Called before a request is processed, as the flash can't be read or
+ *   programmed while it erases.
+ *
+ ******************************************************************************
+ */
+
+static void fbl_finishEraseAhead(T_FBL_DATA* fblData)
+{
+  while(FALSE != fblData->eraseJobEna)
+  {
+    fbl_pollEraseJob(fblData);
+  }
+}
+
+
+/*
+ ******************************************************************************
+ * Function: fbl_eraseAhead
+ ******************************************************************************
+ * @brief Erase the next pending sector ahead of the write pointer
+ *
+ * @par Description:
+ *   Called while a request is received. The sector is erased by a flash job
+ *   started here and polled by the following calls, so the FBL task keeps
+ *   receiving meanwhile. A job still running when the request is complete
+ *   is waited for by fbl_finishEraseAhead(). The host waits for the response
+ *   before sending the next frame and the COM_UART receive buffer is sized
+ *   for a worst case escaped frame (see UART1_RX_BUF_SIZE), so no data is
+ *   lost while waiting.
+ *   With write avoidance, sectors are erased ahead only while the image
+ *   differs from the flash content, as the erase prevents skipping blocks.
+ *   A sector holding image blocks already is left to the program request,
+ *   which restores the blocks after the erase.
+ *
+ ******************************************************************************
+ */
+
+static void fbl_eraseAhead(T_FBL_DATA* fblData)
+{
+  uint32 sectIdx = fblData->writeSect;
+  uint32 endIdx = fblData->writeSect + FBL_ERASE_AHEAD_SECTORS;
+  uint32 logAddr;
+
+  if(endIdx > fblData->eraseEnd)
+  {
+    endIdx = fblData->eraseEnd;
+  }
+
+#if (FBL_WRITE_AVOID == STD_ON)
+  if(FALSE == fblData->eraseAheadEna)
+  {
+    /* Image matches the flash so far */
+    endIdx = sectIdx;
+  }
+#endif /* (FBL_WRITE_AVOID == STD_ON) */
+
+  while( (sectIdx < endIdx) && (FALSE == fbl_isErasePending(fblData, sectIdx)) )
+  {
+    sectIdx++;
+  }
+  logAddr = (FBL_APP_START_ADDR - FBL_FLASH_BASE_ADDR) + (sectIdx * FLASH_ERASE_SECTOR_SIZE);
+
+  if(FALSE != fblData->eraseJobEna)
+  {
+    /* Sector erase running */
+    fbl_pollEraseJob(fblData);
+  }
+  else if(sectIdx >= endIdx)
+  {
+    /* No sector pending ahead */
+  }
+#if (FBL_WRITE_AVOID == STD_ON)
+  else if(FALSE != fbl_isSectorDone(fblData, sectIdx))
+  {
+    fblData->eraseMap[sectIdx / 32] &= ~(1u << (sectIdx % 32));
+    fblData->stats.sectKept++;
+  }
+  else if(FALSE != fbl_hasDoneBlocks(fblData, sectIdx))
+  {
+    /* Blocks to be restored, left to the program request */
+  }
+#endif /* (FBL_WRITE_AVOID == STD_ON) */
+  else if(STATUS_eOK != extflash_startErase(logAddr, FLASH_ERASE_SECTOR_SIZE))
+  {
+    /* A failed erase is retried on the program request */
+  }
+  else
+  {
+    fblData->eraseJobSect = sectIdx;
+    fblData->eraseJobEna = !FALSE;
+  }
+}
+
+
+/*
+ ******************************************************************************
+ * Function: fbl_erasePending
+ ******************************************************************************
+ * @brief Erase all sectors not erased by program requests so far
+ *
+ ******************************************************************************
+ */
+
+static T_STATUS fbl_erasePending(T_FBL_DATA* fblData)
+{
+  T_STATUS result = STATUS_eOK;
+  uint32 sectIdx;
+
+  for(sectIdx = 0; (sectIdx < fblData->eraseEnd) && (STATUS_eOK == result); sectIdx++)
+  {
+    result = fbl_eraseSector(fblData, sectIdx);
+  }
+  return result;
+}
+
+
+/*
+ ******************************************************************************
+ * Function: fbl_programBlock
+ ******************************************************************************
+ * @brief Program a block, erasing its sector first if pending
+ *
+ * @par Description:
+ *   With write avoidance, a block of a sector pending to be erased is
+ *   compared against the flash content first. A matching block is skipped
+ *   and a block clearing bits only is programmed without erase, so the
+ *   sector is erased only if a block sets bits.
+ *
+ * @return STATUS_eOK if the block holds the data, STATUS_eNOK otherwise
+ *
+ ******************************************************************************
+ */
+
+static T_STATUS fbl_programBlock(T_FBL_DATA* fblData, uint32 blkAddr, uint8 blkData[])
+{
+  T_STATUS result = STATUS_eOK;
+  uint32 logAddr = blkAddr - FBL_FLASH_BASE_ADDR;
+  uint32 sectIdx = (blkAddr - FBL_APP_START_ADDR) / FLASH_ERASE_SECTOR_SIZE;
+#if (FBL_WRITE_AVOID == STD_ON)
+  uint32 blkIdx = (blkAddr - FBL_APP_START_ADDR) / FBL_BLK_SIZE;
+  T_FBL_BLK_CMP blkCmp = FBL_BLK_CMP_eERASE;
+
+  if(FALSE != fbl_isErasePending(fblData, sectIdx))
+  {
+    blkCmp = fbl_compareBlock(blkAddr, blkData);
+    fblData->eraseAheadEna = (FBL_BLK_CMP_eERASE == blkCmp);
+  }
+#endif /* (FBL_WRITE_AVOID == STD_ON) */
+
+  fblData->writeSect = sectIdx + 1;
+
+  if(FALSE == fbl_isErasePending(fblData, sectIdx))
+  {
+    /* Sector outside of the erase region or erased already */
+    result = extflash_write(logAddr, blkData, FBL_BLK_SIZE);
+  }
+#if (FBL_WRITE_AVOID == STD_ON)
+  else if(FBL_BLK_CMP_eEQUAL == blkCmp)
+  {
+    fblData->blkMap[blkIdx / 32] |= (1u << (blkIdx % 32));
+    fblData->stats.blkSkipped++;
+  }
+  else if(FBL_BLK_CMP_ePROGRAM == blkCmp)
+  {
+    result = extflash_write(logAddr, blkData, FBL_BLK_SIZE);
+    if(STATUS_eOK == result)
+    {
+      fblData->blkMap[blkIdx / 32] |= (1u << (blkIdx % 32));
+      fblData->stats.blkProgOnly++;
+    }
+  }
+#endif /* (FBL_WRITE_AVOID == STD_ON) */
+  /* Erase the sector on the first program into it */
+  else if(STATUS_eOK != (result = fbl_eraseSector(fblData, sectIdx)))
+  {
+    /* Erase failed */
+  }
+  else
+  {
+    result = extflash_write(logAddr, blkData, FBL_BLK_SIZE);
+  }
+  return result;
+}
+#endif /* (FBL_LAZY_ERASE == STD_ON) */
+
+
+#if (FBL_RESUME_ENA == STD_ON)
+/*
+ ******************************************************************************
+ * Function: fbl_writeJrnl
+ ******************************************************************************
+ * @brief Program a field of the journal
+ *
+ ******************************************************************************
+ */
+
+static T_STATUS fbl_writeJrnl(const void* field, void* srcBuf, uint32 numBytes)
+{
+  return extflash_write((uint32)field - FBL_FLASH_BASE_ADDR, (uint8*)srcBuf, numBytes);
+}
+
+
+/*
+ ******************************************************************************
+ * Function: fbl_openJrnl
+ ******************************************************************************
+ * @brief Start a new journal
+ *
+ * @par Description:
+ *   The tag is programmed last, so a journal interrupted while being
+ *   started isn't taken.
+ *
+ ******************************************************************************
+ */
+
+static T_STATUS fbl_openJrnl(uint32 sessionID, uint32 imgAddr, uint32 imgSize, uint8 imgDigest[])
+{
+  const T_FBL_JRNL* jrnl = (const T_FBL_JRNL*)FBL_JOURNAL_ADDR;
+  T_STATUS result;
+  uint32 hdr[3];
+  uint32 tag = FBL_JRNL_TAG;
+
+  hdr[0] = sessionID;
+  hdr[1] = imgAddr;
+  hdr[2] = imgSize;
+
+  result = fbl_eraseRegion(FBL_JOURNAL_ADDR - FBL_FLASH_BASE_ADDR, FBL_JOURNAL_SIZE);
+  if(STATUS_eOK == result)
+  {
+    result = fbl_writeJrnl(&jrnl->sessionID, hdr, sizeof(hdr));
+  }
+  if(STATUS_eOK == result)
+  {
+    result = fbl_writeJrnl(jrnl->imgDigest, imgDigest, FBL_RESUME_DIGEST_SIZE);
+  }
+  if(STATUS_eOK == result)
+  {
+    result = fbl_writeJrnl(&jrnl->tag, &tag, sizeof(tag));
+  }
+  return result;
+}
+
+
+/*
+ ******************************************************************************
+ * Function: fbl_restartJrnl
+ ******************************************************************************
+ * @brief Drop the blocks journaled so far, as the download starts over
+ *
+ ******************************************************************************
+ */
+
+static T_STATUS fbl_restartJrnl(T_FBL_DATA* fblData)
+{
+  const T_FBL_JRNL* jrnl = (const T_FBL_JRNL*)FBL_JOURNAL_ADDR;
+  T_STATUS result = STATUS_eOK;
+  uint8  imgDigest[FBL_RESUME_DIGEST_SIZE];
+  uint32 wordIdx = 0;
+
+  while( (wordIdx < FBL_RESUME_MAP_WORDS) && (FLASH_BLANK_VALUE == jrnl->blkMap[wordIdx]) )
+  {
+    wordIdx++;
+  }
+
+  if(FALSE == fblData->jrnlOpen)
+  {
+    /* No journal */
+  }
+  else if(wordIdx >= FBL_RESUME_MAP_WORDS)
+  {
+    /* No block journaled yet */
+  }
+  else
+  {
+    libc_memcpy(imgDigest, jrnl->imgDigest, sizeof(imgDigest));
+    result = fbl_openJrnl(jrnl->sessionID, jrnl->imgAddr, jrnl->imgSize, imgDigest);
+    if(STATUS_eOK != result)
+    {
+      fblData->jrnlOpen = FALSE;
+    }
+  }
+  return result;
+}
+
+
+/*
+ ******************************************************************************
+ * Function: fbl_markJrnl
+ ******************************************************************************
+ * @brief Verify programmed blocks and journal them
+ *
+ * @par Description:
+ *   Blocks are read back over the mapped window. The entry vector is
+ *   journaled along with the block holding it, as the block is programmed
+ *   blank at the entry vector.
+ *
+ * @return STATUS_eOK if the blocks are verified or not journaled,
+ *         STATUS_eNOK otherwise
+ *
+ ******************************************************************************
+ */
+
+static T_STATUS fbl_markJrnl(T_FBL_DATA* fblData, uint32 blkAddr, uint8 blkData[], uint32 numBytes)
+{
+  const T_FBL_JRNL* jrnl = (const T_FBL_JRNL*)FBL_JOURNAL_ADDR;
+  T_STATUS result = STATUS_eOK;
+  uint32 blkOffs;
+  uint32 blkIdx;
+  uint32 mapWord;
+
+  for(blkOffs = 0; (blkOffs < numBytes) && (FALSE != fblData->jrnlOpen) && (STATUS_eOK == result); blkOffs += FBL_BLK_SIZE)
+  {
+    blkIdx = ((blkAddr + blkOffs) - jrnl->imgAddr) / FBL_BLK_SIZE;
+
+    if(0 != libc_memcmp((const void*)(blkAddr + blkOffs), &blkData[blkOffs], FBL_BLK_SIZE))
+    {
+      /* Flash doesn't hold the block */
+      result = STATUS_eNOK;
+    }
+    else if( ((blkAddr + blkOffs) < jrnl->imgAddr) || (blkIdx >= (jrnl->imgSize / FBL_BLK_SIZE)) )
+    {
+      /* Block outside of the journaled image */
+    }
+    else
+    {
+      if( ((blkAddr + blkOffs) <= FBL_APP_ENTRY_ADDR) && (FBL_APP_ENTRY_ADDR < (blkAddr + blkOffs + FBL_BLK_SIZE)) )
+      {
+        result = fbl_writeJrnl(&jrnl->entryVect, &fblData->entryVect,
+                               sizeof(fblData->entryVect) + sizeof(fblData->entryVectInv));
+      }
+      if(STATUS_eOK == result)
+      {
+        mapWord = ~(1u << (blkIdx % 32));
+        result = fbl_writeJrnl(&jrnl->blkMap[blkIdx / 32], &mapWord, sizeof(mapWord));
+      }
+    }
+  }
+  return result;
+}
+
+
+/*
+ ******************************************************************************
+ * Function: fbl_closeJrnl
+ ******************************************************************************
+ * @brief Invalidate the journal of a completed download
+ *
+ ******************************************************************************
+ */
+
+static void fbl_closeJrnl(T_FBL_DATA* fblData)
+{
+  const T_FBL_JRNL* jrnl = (const T_FBL_JRNL*)FBL_JOURNAL_ADDR;
+  uint32 tag = 0;
+
+  if(FALSE != fblData->jrnlOpen)
+  {
+    (void)fbl_writeJrnl(&jrnl->tag, &tag, sizeof(tag));
+    fblData->jrnlOpen = FALSE;
+  }
+}
+
+
+/*
+ ******************************************************************************
+ * Function: fbl_checkImgDigest
+ ******************************************************************************
+ * @brief Compare the programmed image against the journaled digest
+ *
+ * @par Description:
+ *   The entry vector isn't programmed before activation, so the hash block
+ *   holding it is hashed from a copy with the entry vector put in. The
+ *   image is block aligned, so the segments before it are full hash blocks.
+ *
+ ******************************************************************************
+ */
+
+static T_STATUS fbl_checkImgDigest(T_FBL_DATA* fblData)
+{
+  const T_FBL_JRNL* jrnl = (const T_FBL_JRNL*)FBL_JOURNAL_ADDR;
+  T_STATUS result = STATUS_eOK;
+  uint32 imgEnd = fblData->imgAddr + fblData->imgSize;
+  uint32 entryChunkAddr = FBL_APP_ENTRY_ADDR & ~(FBL_HASH_CHUNK_SIZE - 1);
+  uint8  entryChunk[FBL_HASH_CHUNK_SIZE];
+  T_DCP_MSG_SEG segTbl[3];
+  uint32 numSegs = 0;
+  T_DCP_DIGEST digest;
+  uint8  digestSize = sizeof(digest.bytes);
+
+  if(FALSE == fblData->jrnlOpen)
+  {
+    /* No digest to compare against */
+  }
+  else
+  {
+    if( (entryChunkAddr < fblData->imgAddr) || ((entryChunkAddr + FBL_HASH_CHUNK_SIZE) > imgEnd) )
+    {
+      /* Entry vector not part of the image */
+      segTbl[numSegs].msgText = (const uint8*)fblData->imgAddr;
+      segTbl[numSegs++].msgLen = fblData->imgSize;
+    }
+    else
+    {
+      libc_memcpy(entryChunk, (const void*)entryChunkAddr, sizeof(entryChunk));
+      libc_memcpy(&entryChunk[FBL_APP_ENTRY_ADDR - entryChunkAddr], &fblData->entryVect, sizeof(fblData->entryVect));
+
+      if(entryChunkAddr > fblData->imgAddr)
+      {
+        segTbl[numSegs].msgText = (const uint8*)fblData->imgAddr;
+        segTbl[numSegs++].msgLen = entryChunkAddr - fblData->imgAddr;
+      }
+      segTbl[numSegs].msgText = entryChunk;
+      segTbl[numSegs++].msgLen = sizeof(entryChunk);
+      if((entryChunkAddr + FBL_HASH_CHUNK_SIZE) < imgEnd)
+      {
+        segTbl[numSegs].msgText = (const uint8*)(entryChunkAddr + FBL_HASH_CHUNK_SIZE);
+        segTbl[numSegs++].msgLen = imgEnd - (entryChunkAddr + FBL_HASH_CHUNK_SIZE);
+      }
+    }
+
+    result = dcp_hashSeg(FBL_DCP_HASH_CHAN, digest.bytes, &digestSize, segTbl, numSegs);
+    if(STATUS_eOK != result)
+    {
+      TRACE_FBL_ERROR("FBL: Digest failed\n");
+    }
+    else if(0 != libc_memcmp(digest.bytes, jrnl->imgDigest, FBL_RESUME_DIGEST_SIZE))
+    {
+      TRACE_FBL_INFO("FBL: Image digest mismatch\n");
+      result = STATUS_eNOK;
+    }
+    else
+    {
+      /* Image complete */
+    }
+  }
+  return result;
+}
+
+
+#if (FBL_LAZY_ERASE == STD_ON)
+/*
+ ******************************************************************************
+ * Function: fbl_resumeErase
+ ******************************************************************************
+ * @brief Rebuild the erase state of a resumed download
+ *
+ * @par Description:
+ *   The erase map was lost with the reset, so all sectors of the image are
+ *   pending again. With write avoidance the verified blocks are taken into
+ *   the block map, so their sectors are erased only if other blocks need
+ *   it and the verified blocks are restored. Otherwise a sector holding a
+ *   verified block has been erased before programming it, so it isn't
+ *   pending.
+ *
+ ******************************************************************************
+ */
+
+static void fbl_resumeErase(T_FBL_DATA* fblData)
+{
+  const T_FBL_JRNL* jrnl = (const T_FBL_JRNL*)FBL_JOURNAL_ADDR;
+  uint32 firstBlk = (jrnl->imgAddr - FBL_APP_START_ADDR) / FBL_BLK_SIZE;
+  uint32 imgBlk;
+  uint32 blkIdx;
+#if (FBL_WRITE_AVOID != STD_ON)
+  uint32 sectIdx;
+#endif /* (FBL_WRITE_AVOID != STD_ON) */
+
+  (void)fbl_deferErase(fblData, jrnl->imgAddr, jrnl->imgSize);
+
+  for(imgBlk = 0; imgBlk < (jrnl->imgSize / FBL_BLK_SIZE); imgBlk++)
+  {
+    blkIdx = firstBlk + imgBlk;
+    if(0 != (jrnl->blkMap[imgBlk / 32] & (1u << (imgBlk % 32))))
+    {
+      /* Block not verified yet */
+    }
+    else
+    {
+#if (FBL_WRITE_AVOID == STD_ON)
+      fblData->blkMap[blkIdx / 32] |= (1u << (blkIdx % 32));
+#else /* (FBL_WRITE_AVOID != STD_ON) */
+      sectIdx = (blkIdx * FBL_BLK_SIZE) / FLASH_ERASE_SECTOR_SIZE;
+      fblData->eraseMap[sectIdx / 32] &= ~(1u << (sectIdx % 32));
+#endif /* (FBL_WRITE_AVOID) */
+    }
+  }
+}
+#endif /* (FBL_LAZY_ERASE == STD_ON) */
+
+
+/*
+ ******************************************************************************
+ * Function: fbl_procResumeMsg
+ ******************************************************************************
+ * @brief Resume an interrupted download or start a new journal
+ *
+ * @par Description:
+ *   The journal lives in flash, so a download is resumed after a link loss
+ *   as well as after a power cycle.
+ *
+ ******************************************************************************
+ */
+
+uint32 fbl_procResumeMsg(T_FBL_DATA* fblData, T_PDU* reqPdu)
+{
+  T_FBL_MSG_RESUME_REQ* reqMsg = (T_FBL_MSG_RESUME_REQ*)reqPdu->data;
+  const T_FBL_JRNL* jrnl = (const T_FBL_JRNL*)FBL_JOURNAL_ADDR;
+  uint32 errCode = BCP_ERR_ID_eNONE;
+
+  /* Check for correct size of expected message */
+  if(reqPdu->len != sizeof(T_FBL_MSG_RESUME_REQ))
+  {
+    /* Unexpected size */
+    TRACE_FBL_INFO("FBL: Unexpected size %d\n", reqPdu->len);
+    errCode = BCP_ERR_ID_eINVALID_SIZE;
+  }
+  else if( (reqMsg->imgAddr < FBL_APP_START_ADDR) || (0 != (reqMsg->imgAddr & (FBL_BLK_SIZE - 1))) )
+  {
+    /* Invalid image address */
+    errCode = BCP_ERR_ID_eINVALID_DATA;
+  }
+  else if( (0 == reqMsg->imgSize) || (0 != (reqMsg->imgSize & (FBL_BLK_SIZE - 1))) )
+  {
+    /* Invalid image size */
+    errCode = BCP_ERR_ID_eINVALID_DATA;
+  }
+  else if(reqMsg->imgSize > (FBL_APP_MAX_SIZE - (reqMsg->imgAddr - FBL_APP_START_ADDR)))
+  {
+    /* Image exceeds the application region */
+    errCode = BCP_ERR_ID_eINVALID_DATA;
+  }
+  else if(STATUS_eOK != extflash_open())
+  {
+    /* Flash device not accessible */
+    errCode = BCP_ERR_ID_eINCONSISTENT;
+  }
+  else if( (FBL_JRNL_TAG == jrnl->tag)
+        && (reqMsg->sessionID == jrnl->sessionID)
+        && (reqMsg->imgAddr == jrnl->imgAddr)
+        && (reqMsg->imgSize == jrnl->imgSize)
+        && (0 == libc_memcmp(reqMsg->imgDigest, jrnl->imgDigest, FBL_RESUME_DIGEST_SIZE)) )
+  {
+    TRACE_FBL_INFO("FBL: Valid resume request, download resumed\n");
+    fblData->imgAddr = jrnl->imgAddr;
+    fblData->imgSize = jrnl->imgSize;
+    fblData->entryVect = jrnl->entryVect;
+    fblData->entryVectInv = jrnl->entryVectInv;
+#if (FBL_LAZY_ERASE == STD_ON)
+    fbl_resumeErase(fblData);
+#endif /* (FBL_LAZY_ERASE == STD_ON) */
+    fblData->jrnlOpen = !FALSE;
+  }
+  else if(STATUS_eOK != fbl_openJrnl(reqMsg->sessionID, reqMsg->imgAddr, reqMsg->imgSize, reqMsg->imgDigest))
+  {
+    /* Journal not writable */
+    fblData->jrnlOpen = FALSE;
+    errCode = BCP_ERR_ID_eINCONSISTENT;
+  }
+  else
+  {
+    TRACE_FBL_INFO("FBL: Valid resume request, new download\n");
+    fblData->imgAddr = reqMsg->imgAddr;
+    fblData->imgSize = reqMsg->imgSize;
+    fblData->jrnlOpen = !FALSE;
+  }
+  return errCode;
+}
+
+
+/*
+ ******************************************************************************
+ * Function: fbl_sendResumeRsp
+ ******************************************************************************
+ * @brief Send the blocks verified so far
+ *
+ ******************************************************************************
+ */
+
+void fbl_sendResumeRsp(void)
+{
+  const T_FBL_JRNL* jrnl = (const T_FBL_JRNL*)FBL_JOURNAL_ADDR;
+  T_FBL_MSG_RESUME_RSP* rspMsg = NULL;
+  T_PDU  rspPdu;
+  uint32 numWords;
+  uint32 wordIdx;
+
+  if(STATUS_eOK != bcp_allocTxPdu(&rspPdu))
+  {
+    TRACE_FBL_ERROR("FBL Error\n");
+  }
+  else
+  {
+    rspMsg = (T_FBL_MSG_RESUME_RSP*)rspPdu.data;
+    rspMsg->msgType = FBL_MSG_ID_eRESUME_RSP;
+    rspMsg->sessionID = jrnl->sessionID;
+    rspMsg->numBlks = jrnl->imgSize / FBL_BLK_SIZE;
+
+    /* The journal is read from flash, so its size is bounded again */
+    numWords = (rspMsg->numBlks + 31) / 32;
+    if(numWords > FBL_RESUME_MAP_WORDS)
+    {
+      numWords = FBL_RESUME_MAP_WORDS;
+    }
+    for(wordIdx = 0; wordIdx < numWords; wordIdx++)
+    {
+      rspMsg->blkMap[wordIdx] = ~(jrnl->blkMap[wordIdx]);
+    }
+
+    rspPdu.len = offsetof(T_FBL_MSG_RESUME_RSP, blkMap) + (numWords * sizeof(uint32));
+  }
+
+  if(NULL == rspMsg)
+  {
+    /* */
+  }
+  else if(STATUS_eOK != bcp_sendMsg(&rspPdu))
+  {
+    TRACE_FBL_ERROR("FBL Error\n");
+  }
+}
+#endif /* (FBL_RESUME_ENA == STD_ON) */
+
+
+/*
+ ******************************************************************************
+ *
+ ******************************************************************************
+ *
+ *
+ ******************************************************************************
+ */
+
+uint32 fbl_procEraseMsg(T_FBL_DATA* fblData, T_PDU* reqPdu)
+{
+  T_FBL_MSG_ERASE_REQ* reqMsg = (T_FBL_MSG_ERASE_REQ*)reqPdu->data;
+  uint32 errCode = BCP_ERR_ID_eNONE;
+
+  // TODO: Handle update sequence state checking
+  
+  /* Check for correct size of expected message */
+  if(reqPdu->len != sizeof(T_FBL_MSG_ERASE_REQ))
+  {
+    /* Unexpected size */
+    TRACE_FBL_INFO("FBL: Unexpected size %d\n", reqPdu->len);
+    errCode = BCP_ERR_ID_eINVALID_SIZE;
+  }
+  else if(reqMsg->blkAddr != fblData->imgAddr)
+  {
+    /* Invalid start address */
+    errCode = BCP_ERR_ID_eINVALID_DATA;
+  }
+  else if(reqMsg->blkSize != fblData->imgSize)
+  {
+    /* Invalid size */
+    errCode = BCP_ERR_ID_eINVALID_DATA;
+  }
+  else
+  {
+    uint32 logAddr = reqMsg->blkAddr - FBL_FLASH_BASE_ADDR;
+
+    TRACE_FBL_INFO("FBL: Valid erase request\n");
+#if (FBL_RESUME_ENA == STD_ON)
+    if(STATUS_eOK != fbl_restartJrnl(fblData))
+    {
+      /* Journal not writable */
+      errCode = BCP_ERR_ID_eINCONSISTENT;
+    }
+    else
+#endif /* (FBL_RESUME_ENA == STD_ON) */
+#if (FBL_LAZY_ERASE == STD_ON)
+    if(FALSE != fbl_deferErase(fblData, reqMsg->blkAddr, reqMsg->blkSize))
+    {
+      /* Sectors are erased on the program requests */
+    }
+    else
+#endif /* (FBL_LAZY_ERASE == STD_ON) */
+    if(STATUS_eOK != fbl_eraseRegion(logAddr, reqMsg->blkSize))
+    {
+      /* Erase failed */
+      errCode = BCP_ERR_ID_eINCONSISTENT;
+    }
+  }
+  return errCode;
+}
+
+
+/*
+ ******************************************************************************
+ * Function: fbl_takeEntryVect
+ ******************************************************************************
+ * @brief Take the entry vector out of the block holding it
+ *
+ ******************************************************************************
+ */
+
+static void fbl_takeEntryVect(T_FBL_DATA* fblData, uint32 blkAddr, uint8 blkData[])
+{
+  if(blkAddr > FBL_APP_ENTRY_ADDR)
+  {
+    /* Block start is beyond application entry */
+  }
+  else if((blkAddr + FBL_BLK_SIZE) < FBL_APP_ENTRY_ADDR)
+  {
+    /* Block end is less then application entry */
+  }
+  else
+  {
+    /* The current block contains the entry vector, which needs to be
+     * copied to a safe location and replaced by the flash blank value.
+     * 60010404 - 60010000 = 00000404;
+     * 0x4
+     */
+    uint32 entryOffs = FBL_APP_ENTRY_ADDR & (FBL_BLK_SIZE - 1);
+    uint32 blankValue = FLASH_BLANK_VALUE;
+
+    libc_memcpy(&fblData->entryVect, &blkData[entryOffs], sizeof(fblData->entryVect));
+    fblData->entryVectInv = (uint32)~(fblData->entryVect);
+
+    libc_memcpy(&blkData[entryOffs], &blankValue, sizeof(fblData->entryVect));
+  }
+}
+
+
+/*
+ ******************************************************************************
+ *
+ ******************************************************************************
+ *
+ *
+ ******************************************************************************
+ */
+
+uint32 fbl_procProgramMsg(T_FBL_DATA* fblData, T_PDU* reqPdu)
+{
+  T_FBL_MSG_PROGRAM_REQ* reqMsg = (T_FBL_MSG_PROGRAM_REQ*)reqPdu->data;
+  uint32 errCode = BCP_ERR_ID_eNONE;
+
+  // TODO: Handle update sequence state checking
+  
+  /* Check for correct size of expected message */
+  if(reqPdu->len != sizeof(T_FBL_MSG_PROGRAM_REQ))
+  {
+    /* Unexpected size */
+    TRACE_FBL_INFO("FBL: Unexpected size %d\n", reqPdu->len);
+    errCode = BCP_ERR_ID_eINVALID_SIZE;
+  }
+  else if(reqMsg->blkAddr < fblData->imgAddr)
+  {
+    /* Invalid block address */
+    errCode = BCP_ERR_ID_eINVALID_DATA;
+  }
+  else if(0 != (reqMsg->blkAddr & (FBL_ALIGN_SIZE - 1)))
+  {
+    /* Improper alignment of block address */
+    errCode = BCP_ERR_ID_eINVALID_DATA;
+  }
+  else if((reqMsg->blkAddr + FBL_ALIGN_SIZE) > (fblData->imgAddr + fblData->imgSize))
+  {
+    /* Invalid block address */
+    errCode = BCP_ERR_ID_eINVALID_DATA;
+  }
+  else
+  {
+    TRACE_FBL_INFO("FBL: Valid program request\n");
+    fbl_takeEntryVect(fblData, reqMsg->blkAddr, reqMsg->blkData);
+#if (FBL_LAZY_ERASE == STD_ON)
+    if(STATUS_eOK != fbl_programBlock(fblData, reqMsg->blkAddr, reqMsg->blkData))
+    {
+      /* Erase or program failed */
+      errCode = BCP_ERR_ID_eINCONSISTENT;
+    }
+#else /* (FBL_LAZY_ERASE != STD_ON) */
+    if(STATUS_eOK != extflash_write(reqMsg->blkAddr - FBL_FLASH_BASE_ADDR, reqMsg->blkData, FBL_ALIGN_SIZE))
+    {
+      /* Program failed */
+      errCode = BCP_ERR_ID_eINCONSISTENT;
+    }
+#endif /* (FBL_LAZY_ERASE) */
+#if (FBL_RESUME_ENA == STD_ON)
+    if( (BCP_ERR_ID_eNONE == errCode)
+     && (STATUS_eOK != fbl_markJrnl(fblData, reqMsg->blkAddr, reqMsg->blkData, FBL_BLK_SIZE)) )
+    {
+      /* Block not verified or not journaled */
+      errCode = BCP_ERR_ID_eINCONSISTENT;
+    }
+#endif /* (FBL_RESUME_ENA == STD_ON) */
+  }
+  return errCode;
+}
+
+
+/*
+ ******************************************************************************
+ * Function: fbl_procFillMsg
+ ******************************************************************************
+ * @brief Fill a block aligned range by a pattern
+ *
+ * @par Description:
+ *   A blank pattern isn't programmed. Each block of the range is to be
+ *   blank already or, with lazy erase, its sector is to be pending to be
+ *   erased. Such a block is dropped from the block map, so the erase of its
+ *   sector, on activation at the latest, leaves it blank. Otherwise the
+ *   fill is refused.
+ *
+ ******************************************************************************
+ */
+
+uint32 fbl_procFillMsg(T_FBL_DATA* fblData, T_PDU* reqPdu)
+{
+  T_FBL_MSG_FILL_REQ* reqMsg = (T_FBL_MSG_FILL_REQ*)reqPdu->data;
+  uint32 errCode = BCP_ERR_ID_eNONE;
+  uint32 blkAddr;
+  uint32 wordIdx;
+#if (FBL_WRITE_AVOID == STD_ON)
+  uint32 blkIdx;
+#endif /* (FBL_WRITE_AVOID == STD_ON) */
+
+  /* Check for correct size of expected message */
+  if(reqPdu->len != sizeof(T_FBL_MSG_FILL_REQ))
+  {
+    /* Unexpected size */
+    TRACE_FBL_INFO("FBL: Unexpected size %d\n", reqPdu->len);
+    errCode = BCP_ERR_ID_eINVALID_SIZE;
+  }
+  else if( (0 == reqMsg->blkSize) || (0 != (reqMsg->blkSize & (FBL_BLK_SIZE - 1))) )
+  {
+    /* Invalid size */
+    errCode = BCP_ERR_ID_eINVALID_DATA;
+  }
+  else if(0 != (reqMsg->blkAddr & (FBL_BLK_SIZE - 1)))
+  {
+    /* Improper alignment of block address */
+    errCode = BCP_ERR_ID_eINVALID_DATA;
+  }
+  else if( (reqMsg->blkAddr < fblData->imgAddr)
+        || ((reqMsg->blkAddr - fblData->imgAddr) + reqMsg->blkSize > fblData->imgSize) )
+  {
+    /* Range outside of the image */
+    errCode = BCP_ERR_ID_eINVALID_DATA;
+  }
+  else if( (reqMsg->blkAddr <= FBL_APP_ENTRY_ADDR)
+        && (FBL_APP_ENTRY_ADDR < (reqMsg->blkAddr + reqMsg->blkSize)) )
+  {
+    /* Entry vector is taken from the program request */
+    errCode = BCP_ERR_ID_eINVALID_DATA;
+  }
+  else if(FLASH_BLANK_VALUE == reqMsg->pattern)
+  {
+    TRACE_FBL_INFO("FBL: Valid fill request, blank\n");
+    for(blkAddr = reqMsg->blkAddr; blkAddr < (reqMsg->blkAddr + reqMsg->blkSize); blkAddr += FBL_BLK_SIZE)
+    {
+      if(FALSE != extflash_isBlank(blkAddr - FBL_FLASH_BASE_ADDR, FBL_BLK_SIZE))
+      {
+        /* Block blank already */
+      }
+#if (FBL_LAZY_ERASE == STD_ON)
+      else if(FALSE != fbl_isErasePending(fblData, (blkAddr - FBL_APP_START_ADDR) / FLASH_ERASE_SECTOR_SIZE))
+      {
+#if (FBL_WRITE_AVOID == STD_ON)
+        blkIdx = (blkAddr - FBL_APP_START_ADDR) / FBL_BLK_SIZE;
+        fblData->blkMap[blkIdx / 32] &= ~(1u << (blkIdx % 32));
+#endif /* (FBL_WRITE_AVOID == STD_ON) */
+      }
+#endif /* (FBL_LAZY_ERASE == STD_ON) */
+      else
+      {
+        /* Block programmed or not erased, so it can't be left blank */
+        errCode = BCP_ERR_ID_eUNEXPECTED;
+        break;
+      }
+    }
+  }
+  else
+  {
+    TRACE_FBL_INFO("FBL: Valid fill request\n");
+    for(wordIdx = 0; wordIdx < (FBL_BLK_SIZE / sizeof(uint32)); wordIdx++)
+    {
+      fblData->fillBuf[wordIdx] = reqMsg->pattern;
+    }
+
+    for(blkAddr = reqMsg->blkAddr; blkAddr < (reqMsg->blkAddr + reqMsg->blkSize); blkAddr += FBL_BLK_SIZE)
+    {
+#if (FBL_LAZY_ERASE == STD_ON)
+      if(STATUS_eOK != fbl_programBlock(fblData, blkAddr, (uint8*)(void*)fblData->fillBuf))
+#else /* (FBL_LAZY_ERASE != STD_ON) */
+      if(STATUS_eOK != extflash_write(blkAddr - FBL_FLASH_BASE_ADDR, (uint8*)(void*)fblData->fillBuf, FBL_BLK_SIZE))
+#endif /* (FBL_LAZY_ERASE) */
+      {
+        /* Erase or program failed */
+        errCode = BCP_ERR_ID_eINCONSISTENT;
+        break;
+      }
+#if (FBL_RESUME_ENA == STD_ON)
+      else if(STATUS_eOK != fbl_markJrnl(fblData, blkAddr, (uint8*)(void*)fblData->fillBuf, FBL_BLK_SIZE))
+      {
+        /* Block not verified or not journaled */
+        errCode = BCP_ERR_ID_eINCONSISTENT;
+        break;
+      }
+#endif /* (FBL_RESUME_ENA == STD_ON) */
+    }
+  }
+  return errCode;
+}
+
+
+#if (FBL_WRITE_AVOID == STD_ON)
+/*
+ ******************************************************************************
+ * Function: fbl_procKeepMsg
+ ******************************************************************************
+ * @brief Keep a block aligned range holding the image already
+ *
+ * @par Description:
+ *   The range is hashed over the mapped window. On a match its blocks are
+ *   taken into the block map, so the erase of their sectors restores them
+ *   rather than leaving them blank.
+ *
+ ******************************************************************************
+ */
+
+uint32 fbl_procKeepMsg(T_FBL_DATA* fblData, T_PDU* reqPdu)
+{
+  T_FBL_MSG_KEEP_REQ* reqMsg = (T_FBL_MSG_KEEP_REQ*)reqPdu->data;
+  uint32 errCode = BCP_ERR_ID_eNONE;
+  T_DCP_DIGEST digest;
+  uint8  digestSize = sizeof(reqMsg->digest);
+  uint32 blkIdx;
+  uint32 endIdx;
+
+  /* Check for correct size of expected message */
+  if(reqPdu->len != sizeof(T_FBL_MSG_KEEP_REQ))
+  {
+    /* Unexpected size */
+    TRACE_FBL_INFO("FBL: Unexpected size %d\n", reqPdu->len);
+    errCode = BCP_ERR_ID_eINVALID_SIZE;
+  }
+  else if( (0 == reqMsg->blkSize) || (0 != (reqMsg->blkSize & (FBL_BLK_SIZE - 1))) )
+  {
+    /* Invalid size */
+    errCode = BCP_ERR_ID_eINVALID_DATA;
+  }
+  else if(0 != (reqMsg->blkAddr & (FBL_BLK_SIZE - 1)))
+  {
+    /* Improper alignment of block address */
+    errCode = BCP_ERR_ID_eINVALID_DATA;
+  }
+  else if( (reqMsg->blkAddr < fblData->imgAddr)
+        || ((reqMsg->blkAddr - fblData->imgAddr) + reqMsg->blkSize > fblData->imgSize) )
+  {
+    /* Range outside of the image */
+    errCode = BCP_ERR_ID_eINVALID_DATA;
+  }
+  else if( (reqMsg->blkAddr <= FBL_APP_ENTRY_ADDR)
+        && (FBL_APP_ENTRY_ADDR < (reqMsg->blkAddr + reqMsg->blkSize)) )
+  {
+    /* Entry vector is taken from the program request */
+    errCode = BCP_ERR_ID_eINVALID_DATA;
+  }
+  else if(0 == fblData->eraseEnd)
+  {
+    /* No erase deferred by an erase request, so nothing to keep the range from */
+    errCode = BCP_ERR_ID_eUNEXPECTED;
+  }
+  else if(STATUS_eOK != dcp_hash(FBL_DCP_HASH_CHAN, digest.bytes, &digestSize,
+                                 (const uint8*)reqMsg->blkAddr, reqMsg->blkSize))
+  {
+    /* Hash failed */
+    errCode = BCP_ERR_ID_eINCONSISTENT;
+  }
+  else if(0 != libc_memcmp(digest.bytes, reqMsg->digest, sizeof(reqMsg->digest)))
+  {
+    /* Flash doesn't hold the range, so it's to be programmed */
+    errCode = BCP_ERR_ID_eINVALID_DATA;
+  }
+  else
+  {
+    TRACE_FBL_INFO("FBL: Valid keep request\n");
+    blkIdx = (reqMsg->blkAddr - FBL_APP_START_ADDR) / FBL_BLK_SIZE;
+    endIdx = blkIdx + (reqMsg->blkSize / FBL_BLK_SIZE);
+    for(; blkIdx < endIdx; blkIdx++)
+    {
+      fblData->blkMap[blkIdx / 32] |= (1u << (blkIdx % 32));
+      fblData->stats.blkSkipped++;
+    }
+#if (FBL_RESUME_ENA == STD_ON)
+    if(STATUS_eOK != fbl_markJrnl(fblData, reqMsg->blkAddr, (uint8*)reqMsg->blkAddr, reqMsg->blkSize))
+    {
+      /* Range not journaled */
+      errCode = BCP_ERR_ID_eINCONSISTENT;
+    }
+#endif /* (FBL_RESUME_ENA == STD_ON) */
+  }
+  return errCode;
+}
+#endif /* (FBL_WRITE_AVOID == STD_ON) */
+
+
+#if (FBL_STAGE_ENA == STD_ON)
+/*
+ ******************************************************************************
+ * Function: fbl_procStageMsg
+ ******************************************************************************
+ * @brief Copy a block into the staging arena
+ *
+ * @par Description:
+ *   The first block sets the start of the window. Further blocks extend
+ *   the window or replace a block staged before.
+ *
+ ******************************************************************************
+ */
+
+uint32 fbl_procStageMsg(T_FBL_DATA* fblData, T_PDU* reqPdu)
+{
+  T_FBL_MSG_STAGE_REQ* reqMsg = (T_FBL_MSG_STAGE_REQ*)reqPdu->data;
+  uint32 errCode = BCP_ERR_ID_eNONE;
+  uint32 stageAddr = (0 == fblData->stageLen) ? reqMsg->blkAddr : fblData->stageAddr;
+  uint32 stageOffs = reqMsg->blkAddr - stageAddr;
+
+  /* Check for correct size of expected message */
+  if(reqPdu->len != sizeof(T_FBL_MSG_STAGE_REQ))
+  {
+    /* Unexpected size */
+    TRACE_FBL_INFO("FBL: Unexpected size %d\n", reqPdu->len);
+    errCode = BCP_ERR_ID_eINVALID_SIZE;
+  }
+  else if(reqMsg->blkAddr < fblData->imgAddr)
+  {
+    /* Invalid block address */
+    errCode = BCP_ERR_ID_eINVALID_DATA;
+  }
+  else if(0 != (reqMsg->blkAddr & (FBL_BLK_SIZE - 1)))
+  {
+    /* Improper alignment of block address */
+    errCode = BCP_ERR_ID_eINVALID_DATA;
+  }
+  else if((reqMsg->blkAddr + FBL_BLK_SIZE) > (fblData->imgAddr + fblData->imgSize))
+  {
+    /* Invalid block address */
+    errCode = BCP_ERR_ID_eINVALID_DATA;
+  }
+  else if( (reqMsg->blkAddr < stageAddr) || (stageOffs > fblData->stageLen) )
+  {
+    /* Block not contiguous to the window */
+    errCode = BCP_ERR_ID_eINVALID_DATA;
+  }
+  else if((stageOffs + FBL_BLK_SIZE) > sizeof(fbl_stageBuf))
+  {
+    /* Staging arena full */
+    errCode = BCP_ERR_ID_eINVALID_DATA;
+  }
+  else
+  {
+    TRACE_FBL_INFO("FBL: Valid stage request\n");
+    fblData->winSize = 0;
+    libc_memcpy(&((uint8*)(void*)fbl_stageBuf)[stageOffs], reqMsg->blkData, FBL_BLK_SIZE);
+    fblData->stageAddr = stageAddr;
+    if(fblData->stageLen < (stageOffs + FBL_BLK_SIZE))
+    {
+      fblData->stageLen = stageOffs + FBL_BLK_SIZE;
+    }
+  }
+  return errCode;
+}
+
+
+#if (FBL_LAZY_ERASE == STD_ON)
+/*
+ ******************************************************************************
+ * Function: fbl_erasePendingRange
+ ******************************************************************************
+ * @brief Erase the pending sectors of a range by runs as large as possible
+ *
+ * @par Description:
+ *   Each run of consecutive pending sectors is erased by a single call, so
+ *   the driver uses its largest erase units.
+ *
+ ******************************************************************************
+ */
+
+static T_STATUS fbl_erasePendingRange(T_FBL_DATA* fblData, uint32 sectIdx, uint32 endIdx)
+{
+  T_STATUS result = STATUS_eOK;
+  uint32 runIdx = sectIdx;
+  uint32 logAddr;
+
+  for(; (sectIdx <= endIdx) && (STATUS_eOK == result); sectIdx++)
+  {
+    if( (sectIdx < endIdx) && (FALSE != fbl_isErasePending(fblData, sectIdx)) )
+    {
+      /* Extend the run */
+    }
+    else
+    {
+      if(runIdx < sectIdx)
+      {
+        logAddr = (FBL_APP_START_ADDR - FBL_FLASH_BASE_ADDR) + (runIdx * FLASH_ERASE_SECTOR_SIZE);
+        result = fbl_eraseRegion(logAddr, (sectIdx - runIdx) * FLASH_ERASE_SECTOR_SIZE);
+#if (FBL_WRITE_AVOID == STD_ON)
+        if(STATUS_eOK == result)
+        {
+          fblData->stats.sectErased += sectIdx - runIdx;
+        }
+#endif /* (FBL_WRITE_AVOID == STD_ON) */
+        for(; (runIdx < sectIdx) && (STATUS_eOK == result); runIdx++)
+        {
+          fblData->eraseMap[runIdx / 32] &= ~(1u << (runIdx % 32));
+        }
+      }
+      runIdx = sectIdx + 1;
+    }
+  }
+  return result;
+}
+#endif /* (FBL_LAZY_ERASE == STD_ON) */
+
+
+#if (FBL_LAZY_ERASE == STD_ON)
+/*
+ ******************************************************************************
+ * Function: fbl_programBurst
+ ******************************************************************************
+ * @brief Program a page aligned region by page program jobs
+ *
+ * @par Description:
+ *   Each page is programmed by a flash job, the same native commands the
+ *   sectors are erased ahead by. The job is polled until the device is
+ *   ready again before the next page is started.
+ *
+ ******************************************************************************
+ */
+
+static T_STATUS fbl_programBurst(uint32 logAddr, const uint8 srcBuf[], uint32 numBytes)
+{
+  T_STATUS result = STATUS_eOK;
+  uint32 pageSize = extflash_getPageSize();
+  uint32 offs;
+
+  for(offs = 0; (offs < numBytes) && (STATUS_eOK == result); offs += pageSize)
+  {
+    result = extflash_startWrite(logAddr + offs, &srcBuf[offs]);
+    while( (STATUS_eOK == result) && (EXTFLASH_STATUS_eIDLE != extflash_getStatus()) )
+    {
+      extflash_run();
+    }
+
+    if( (STATUS_eOK == result) && (EXTFLASH_JOB_RESULT_eOK != extflash_getJobResult()) )
+    {
+      /* Program failed */
+      result = STATUS_eNOK;
+    }
+  }
+  return result;
+}
+#endif /* (FBL_LAZY_ERASE == STD_ON) */
+
+
+/*
+ ******************************************************************************
+ * Function: fbl_programStage
+ ******************************************************************************
+ * @brief Program the staged window
+ *
+ * @par Description:
+ *   Without a bulk erase each block takes the path of the program request.
+ *   With a bulk erase the pending sectors of the window are erased at once
+ *   and the sector aligned window is programmed by a single burst.
+ *
+ ******************************************************************************
+ */
+
+static T_STATUS fbl_programStage(T_FBL_DATA* fblData, boolean bulkErase)
+{
+  T_STATUS result = STATUS_eOK;
+  uint8* stagePtr = (uint8*)(void*)fbl_stageBuf;
+#if (FBL_LAZY_ERASE == STD_ON)
+  uint32 sectIdx = (fblData->stageAddr - FBL_APP_START_ADDR) / FLASH_ERASE_SECTOR_SIZE;
+  uint32 endIdx = ((fblData->stageAddr - FBL_APP_START_ADDR) + fblData->stageLen) / FLASH_ERASE_SECTOR_SIZE;
+  uint32 blkOffs;
+
+  if(FALSE == bulkErase)
+  {
+    for(blkOffs = 0; (blkOffs < fblData->stageLen) && (STATUS_eOK == result); blkOffs += FBL_BLK_SIZE)
+    {
+      result = fbl_programBlock(fblData, fblData->stageAddr + blkOffs, &stagePtr[blkOffs]);
+    }
+  }
+  else if(STATUS_eOK != (result = fbl_erasePendingRange(fblData, sectIdx, endIdx)))
+  {
+    /* Erase failed */
+  }
+  else
+  {
+    fblData->writeSect = endIdx;
+    result = fbl_programBurst(fblData->stageAddr - FBL_FLASH_BASE_ADDR, stagePtr, fblData->stageLen);
+  }
+#else /* (FBL_LAZY_ERASE != STD_ON) */
+  /* Region erased by the erase request */
+  (void)bulkErase;
+  result = extflash_write(fblData->stageAddr - FBL_FLASH_BASE_ADDR, stagePtr, fblData->stageLen);
+#endif /* (FBL_LAZY_ERASE) */
+  return result;
+}
+
+
+/*
+ ******************************************************************************
+ * Function: fbl_procCommitMsg
+ ******************************************************************************
+ * @brief Verify the staged window and program it
+ *
+ * @par Description:
+ *   The window is dropped on a digest mismatch, so the host stages it
+ *   again.
+ *
+ ******************************************************************************
+ */
+
+uint32 fbl_procCommitMsg(T_FBL_DATA* fblData, T_PDU* reqPdu)
+{
+  T_FBL_MSG_COMMIT_REQ* reqMsg = (T_FBL_MSG_COMMIT_REQ*)reqPdu->data;
+  uint32 errCode = BCP_ERR_ID_eNONE;
+  uint8* stagePtr = (uint8*)(void*)fbl_stageBuf;
+  T_DCP_DIGEST digest;
+  uint8  digestSize = sizeof(reqMsg->digest);
+  uint32 entryBlkAddr = FBL_APP_ENTRY_ADDR & ~(FBL_BLK_SIZE - 1);
+
+  /* Check for correct size of expected message */
+  if(reqPdu->len != sizeof(T_FBL_MSG_COMMIT_REQ))
+  {
+    /* Unexpected size */
+    TRACE_FBL_INFO("FBL: Unexpected size %d\n", reqPdu->len);
+    errCode = BCP_ERR_ID_eINVALID_SIZE;
+  }
+  else if(0 == fblData->stageLen)
+  {
+    /* Nothing staged */
+    errCode = BCP_ERR_ID_eUNEXPECTED;
+  }
+  else if( (reqMsg->blkAddr != fblData->stageAddr) || (reqMsg->blkSize != fblData->stageLen) )
+  {
+    /* Window differs from the staged one */
+    errCode = BCP_ERR_ID_eINVALID_DATA;
+  }
+  else if( (0 != (reqMsg->flags & FBL_COMMIT_FLAG_BULK_ERASE))
+        && ( (0 != (reqMsg->blkAddr & (FLASH_ERASE_SECTOR_SIZE - 1)))
+          || (0 != (reqMsg->blkSize & (FLASH_ERASE_SECTOR_SIZE - 1))) ) )
+  {
+    /* Bulk erase of a window not sector aligned */
+    errCode = BCP_ERR_ID_eINVALID_DATA;
+  }
+  else if(STATUS_eOK != dcp_hash(FBL_DCP_HASH_CHAN, digest.bytes, &digestSize, stagePtr, fblData->stageLen))
+  {
+    /* Hash failed */
+    errCode = BCP_ERR_ID_eINCONSISTENT;
+  }
+  else if(0 != libc_memcmp(digest.bytes, reqMsg->digest, sizeof(reqMsg->digest)))
+  {
+    /* Staged data corrupted, so stage it again */
+    fblData->stageLen = 0;
+    fblData->winSize = 0;
+    errCode = BCP_ERR_ID_eINVALID_DATA;
+  }
+  else
+  {
+    TRACE_FBL_INFO("FBL: Valid commit request\n");
+    if( (entryBlkAddr >= fblData->stageAddr) && (entryBlkAddr < (fblData->stageAddr + fblData->stageLen)) )
+    {
+      fbl_takeEntryVect(fblData, entryBlkAddr, &stagePtr[entryBlkAddr - fblData->stageAddr]);
+    }
+
+    if(STATUS_eOK != fbl_programStage(fblData, (0 != (reqMsg->flags & FBL_COMMIT_FLAG_BULK_ERASE))))
+    {
+      /* Erase or program failed */
+      errCode = BCP_ERR_ID_eINCONSISTENT;
+    }
+#if (FBL_RESUME_ENA == STD_ON)
+    else if(STATUS_eOK != fbl_markJrnl(fblData, fblData->stageAddr, stagePtr, fblData->stageLen))
+    {
+      /* Window not verified or not journaled */
+      errCode = BCP_ERR_ID_eINCONSISTENT;
+    }
+#endif /* (FBL_RESUME_ENA == STD_ON) */
+    fblData->stageLen = 0;
+    fblData->winSize = 0;
+  }
+  return errCode;
+}
+
+
+/*
+ ******************************************************************************
+ * Function: fbl_procWindowMsg
+ ******************************************************************************
+ * @brief Open a window to be streamed
+ *
+ * @par Description:
+ *   The window currently open is kept, so the request reports its missing
+ *   blocks. Another window drops the data staged so far.
+ *
+ ******************************************************************************
+ */
+
+uint32 fbl_procWindowMsg(T_FBL_DATA* fblData, T_PDU* reqPdu)
+{
+  T_FBL_MSG_WINDOW_REQ* reqMsg = (T_FBL_MSG_WINDOW_REQ*)reqPdu->data;
+  uint32 errCode = BCP_ERR_ID_eNONE;
+
+  /* Check for correct size of expected message */
+  if(reqPdu->len != sizeof(T_FBL_MSG_WINDOW_REQ))
+  {
+    /* Unexpected size */
+    TRACE_FBL_INFO("FBL: Unexpected size %d\n", reqPdu->len);
+    errCode = BCP_ERR_ID_eINVALID_SIZE;
+  }
+  else if( (0 == reqMsg->blkSize) || (0 != (reqMsg->blkSize & (FBL_BLK_SIZE - 1))) )
+  {
+    /* Invalid size */
+    errCode = BCP_ERR_ID_eINVALID_DATA;
+  }
+  else if(reqMsg->blkSize > sizeof(fbl_stageBuf))
+  {
+    /* Window exceeds the staging arena */
+    errCode = BCP_ERR_ID_eINVALID_DATA;
+  }
+  else if(0 != (reqMsg->blkAddr & (FBL_BLK_SIZE - 1)))
+  {
+    /* Improper alignment of block address */
+    errCode = BCP_ERR_ID_eINVALID_DATA;
+  }
+  else if( (reqMsg->blkAddr < fblData->imgAddr)
+        || ((reqMsg->blkAddr - fblData->imgAddr) + reqMsg->blkSize > fblData->imgSize) )
+  {
+    /* Window outside of the image */
+    errCode = BCP_ERR_ID_eINVALID_DATA;
+  }
+  else if( (reqMsg->blkAddr == fblData->stageAddr) && (reqMsg->blkSize == fblData->winSize) )
+  {
+    TRACE_FBL_INFO("FBL: Valid window request\n");
+  }
+  else
+  {
+    TRACE_FBL_INFO("FBL: Valid window request, new window\n");
+    fblData->stageAddr = reqMsg->blkAddr;
+    fblData->stageLen = 0;
+    fblData->winSize = reqMsg->blkSize;
+    libc_memset(fblData->winMap, 0, sizeof(fblData->winMap));
+  }
+  return errCode;
+}
+
+
+/*
+ ******************************************************************************
+ * Function: fbl_sendWindowRsp
+ ******************************************************************************
+ * @brief Send the blocks missing from the window
+ *
+ ******************************************************************************
+ */
+
+void fbl_sendWindowRsp(T_FBL_DATA* fblData)
+{
+  T_FBL_MSG_WINDOW_RSP* rspMsg = NULL;
+  T_PDU  rspPdu;
+  uint32 numBlks = fblData->winSize / FBL_BLK_SIZE;
+  uint32 numWords = (numBlks + 31) / 32;
+  uint32 wordIdx;
+
+  if(STATUS_eOK != bcp_allocTxPdu(&rspPdu))
+  {
+    TRACE_FBL_ERROR("FBL Error\n");
+  }
+  else
+  {
+    rspMsg = (T_FBL_MSG_WINDOW_RSP*)rspPdu.data;
+    rspMsg->msgType = FBL_MSG_ID_eWINDOW_RSP;
+    rspMsg->blkAddr = fblData->stageAddr;
+    rspMsg->blkSize = fblData->winSize;
+
+    for(wordIdx = 0; wordIdx < numWords; wordIdx++)
+    {
+      rspMsg->missMap[wordIdx] = ~(fblData->winMap[wordIdx]);
+    }
+    if(0 != (numBlks % 32))
+    {
+      /* Bits beyond the window */
+      rspMsg->missMap[numWords - 1] &= (1u << (numBlks % 32)) - 1;
+    }
+
+    rspPdu.len = offsetof(T_FBL_MSG_WINDOW_RSP, missMap) + (numWords * sizeof(uint32));
+  }
+
+  if(NULL == rspMsg)
+  {
+    /* */
+  }
+  else if(STATUS_eOK != bcp_sendMsg(&rspPdu))
+  {
+    TRACE_FBL_ERROR("FBL Error\n");
+  }
+}
+
+
+/*
+ ******************************************************************************
+ * Function: fbl_procStreamMsg
+ ******************************************************************************
+ * @brief Copy a streamed block into the window
+ *
+ * @par Description:
+ *   The window becomes staged, once each of its blocks has been received.
+ *   Errors aren't answered, the block is reported missing instead.
+ *
+ ******************************************************************************
+ */
+
+uint32 fbl_procStreamMsg(T_FBL_DATA* fblData, T_PDU* reqPdu)
+{
+  T_FBL_MSG_STREAM_REQ* reqMsg = (T_FBL_MSG_STREAM_REQ*)reqPdu->data;
+  uint32 errCode = BCP_ERR_ID_eNONE;
+  uint32 blkIdx = (reqMsg->blkAddr - fblData->stageAddr) / FBL_BLK_SIZE;
+  uint32 numBlks = fblData->winSize / FBL_BLK_SIZE;
+
+  /* Check for correct size of expected message */
+  if(reqPdu->len != sizeof(T_FBL_MSG_STREAM_REQ))
+  {
+    /* Unexpected size */
+    TRACE_FBL_INFO("FBL: Unexpected size %d\n", reqPdu->len);
+    errCode = BCP_ERR_ID_eINVALID_SIZE;
+  }
+  else if(0 == fblData->winSize)
+  {
+    /* No window open */
+    errCode = BCP_ERR_ID_eUNEXPECTED;
+  }
+  else if(0 != (reqMsg->blkAddr & (FBL_BLK_SIZE - 1)))
+  {
+    /* Improper alignment of block address */
+    errCode = BCP_ERR_ID_eINVALID_DATA;
+  }
+  else if( (reqMsg->blkAddr < fblData->stageAddr) || (blkIdx >= numBlks) )
+  {
+    /* Block outside of the window */
+    errCode = BCP_ERR_ID_eINVALID_DATA;
+  }
+  else
+  {
+    libc_memcpy(&((uint8*)(void*)fbl_stageBuf)[blkIdx * FBL_BLK_SIZE], reqMsg->blkData, FBL_BLK_SIZE);
+    fblData->winMap[blkIdx / 32] |= (1u << (blkIdx % 32));
+
+    /* Check for a complete window */
+    blkIdx = 0;
+    while( (blkIdx < numBlks) && (0 != (fblData->winMap[blkIdx / 32] & (1u << (blkIdx % 32)))) )
+    {
+      blkIdx++;
+    }
+    if(blkIdx == numBlks)
+    {
+      fblData->stageLen = fblData->winSize;
+    }
+  }
+  return errCode;
+}
+#endif /* (FBL_STAGE_ENA == STD_ON) */
+
+
+/*
+ ******************************************************************************
+ *
+ ******************************************************************************
+ *
+ *
+ ******************************************************************************
+ */
+
+uint32 fbl_procActivateMsg(T_FBL_DATA* fblData, T_PDU* reqPdu)
+{
+  T_FBL_MSG_ACTIVATE_REQ* reqMsg = (T_FBL_MSG_ACTIVATE_REQ*)reqPdu->data;
+  uint32 errCode = BCP_ERR_ID_eNONE;
+
+  // TODO: Handle update sequence state checking
+  
+  /* Check for correct size of expected message */
+  if(reqPdu->len != sizeof(T_FBL_MSG_ACTIVATE_REQ))
+  {
+    /* Unexpected size */
+    TRACE_FBL_INFO("FBL: Unexpected size %d\n", reqPdu->len);
+    errCode = BCP_ERR_ID_eINVALID_SIZE;
+  }
+  else if(reqMsg->blkAddr != fblData->imgAddr)
+  {
+    /* Invalid start address */
+    errCode = BCP_ERR_ID_eINVALID_DATA;
+  }
+  else if(reqMsg->blkSize != fblData->imgSize)
+  {
+    /* Invalid size */
+    errCode = BCP_ERR_ID_eINVALID_DATA;
+  }
+  else if(fblData->entryVect != ~(fblData->entryVectInv))
+  {
+    errCode = BCP_ERR_ID_eINCONSISTENT;
+  }
+#if (FBL_LAZY_ERASE == STD_ON)
+  /* Sectors not programmed need to be blank as well */
+  else if(STATUS_eOK != fbl_erasePending(fblData))
+  {
+    errCode = BCP_ERR_ID_eINCONSISTENT;
+  }
+#endif /* (FBL_LAZY_ERASE == STD_ON) */
+#if (FBL_RESUME_ENA == STD_ON)
+  /* The image programmed needs to match the digest announced by the session.
+   * It's checked after the pending sectors have been erased, as their stale
+   * content isn't part of the image.
+   */
+  else if(STATUS_eOK != fbl_checkImgDigest(fblData))
+  {
+    errCode = BCP_ERR_ID_eINCONSISTENT;
   }
+#endif /* (FBL_RESUME_ENA == STD_ON) */
   else
   {
-    /* Valid bootstrap command received */
-    TRACE_FBL_INFO("FBL: Valid bootstrap\n");
+    uint32 logAddr = FBL_APP_ENTRY_ADDR - 0x60000000;
+
+    TRACE_FBL_INFO("FBL: Valid activate request\n");
+#if (FBL_WRITE_AVOID == STD_ON)
+    TRACE_FBL_INFO("FBL: %u blocks skipped, %u programmed without erase, %u sectors erased, %u kept\n",
+                   fblData->stats.blkSkipped, fblData->stats.blkProgOnly,
+                   fblData->stats.sectErased, fblData->stats.sectKept);
+#endif /* (FBL_WRITE_AVOID == STD_ON) */
+    (void)extflash_write(logAddr, (uint8*)(void*)&fblData->entryVect, sizeof(fblData->entryVect));
+#if (FBL_RESUME_ENA == STD_ON)
+    fbl_closeJrnl(fblData);
+#endif /* (FBL_RESUME_ENA == STD_ON) */
   }
   return errCode;
 }
@@ -202,14 +2453,14 @@ uint32 fbl_procBootstrapMsg(T_FBL_DATA* fblData, T_PDU* msgPdu)
  ******************************************************************************
  */
 
-uint32 fbl_procSwInfoMsg(T_FBL_DATA* fblData, T_PDU* reqPdu)
+uint32 fbl_procRestartMsg(T_FBL_DATA* fblData, T_PDU* reqPdu)
 {
   uint32 errCode = BCP_ERR_ID_eNONE;
 
-  (void)fblData;
-
+  // TODO: Handle update sequence state checking
+  
   /* Check for correct size of expected message */
-  if(reqPdu->len != sizeof(T_FBL_MSG_SWINFO_REQ))
+  if(reqPdu->len != sizeof(T_FBL_MSG_RESET_REQ))
   {
     /* Unexpected size */
     TRACE_FBL_INFO("FBL: Unexpected size %d\n", reqPdu->len);
@@ -217,8 +2468,7 @@ uint32 fbl_procSwInfoMsg(T_FBL_DATA* fblData, T_PDU* reqPdu)
   }
   else
   {
-    /* Valid SW info command received */
-    TRACE_FBL_INFO("FBL: Valid swInfo request\n");
+    TRACE_FBL_INFO("FBL: Valid restart request\n");
   }
   return errCode;
 }
@@ -233,54 +2483,35 @@ uint32 fbl_procSwInfoMsg(T_FBL_DATA* fblData, T_PDU* reqPdu)
  ******************************************************************************
  */
 
-uint32 fbl_procInvalidateMsg(T_FBL_DATA* fblData, T_PDU* reqPdu)
+uint32 fbl_procBaudrateMsg(T_FBL_DATA* fblData, T_PDU* reqPdu)
 {
-  T_FBL_MSG_INVALIDATE_REQ* reqMsg = (T_FBL_MSG_INVALIDATE_REQ*)reqPdu->data;
+  T_FBL_MSG_BAUDRATE_REQ* reqMsg = (T_FBL_MSG_BAUDRATE_REQ*)reqPdu->data;
   uint32 errCode = BCP_ERR_ID_eNONE;
 
-  // TODO: Handle update sequence state checking
-  
   /* Check for correct size of expected message */
-  if(reqPdu->len != sizeof(T_FBL_MSG_INVALIDATE_REQ))
+  if(reqPdu->len != sizeof(T_FBL_MSG_BAUDRATE_REQ))
   {
     /* Unexpected size */
     TRACE_FBL_INFO("FBL: Unexpected size %d\n", reqPdu->len);
     errCode = BCP_ERR_ID_eINVALID_SIZE;
   }
-  else if(reqMsg->blkAddr < FBL_APP_START_ADDR)
-  {
-    /* Invalid application start address */
-    errCode = BCP_ERR_ID_eINVALID_DATA;
-  }
-  else if(0 != (reqMsg->blkAddr & (FBL_ALIGN_SIZE - 1)))
-  {
-    /* Improper alignment of start address */
-    errCode = BCP_ERR_ID_eINVALID_DATA;
-  }
-  else if(reqMsg->blkSize < FBL_ALIGN_SIZE)
-  {
-    /* Invalid size */
-    errCode = BCP_ERR_ID_eINVALID_DATA;
-  }
-  else if(0 != (reqMsg->blkSize & (FBL_ALIGN_SIZE - 1)))
+  else if(UART_OK != uart_checkBaudrate(COM_UART, reqMsg->baudrate))
   {
-    /* Improper alignment of size */
+    /* Baud rate can't be set up */
     errCode = BCP_ERR_ID_eINVALID_DATA;
   }
-  else if((reqMsg->blkAddr + reqMsg->blkSize) >= FBL_APP_END_ADDR)
+  else if(reqMsg->timeout > 0xFFFFu)
   {
-    /* Invalid end address */
+    /* Timeout out of range */
     errCode = BCP_ERR_ID_eINVALID_DATA;
   }
   else
   {
-    uint32 logAddr = FBL_APP_ENTRY_ADDR - FBL_FLASH_BASE_ADDR;
-    uint8  invalidSignValue[sizeof(fblData->entryVect)] = { 0 };
+    TRACE_FBL_INFO("FBL: Valid baud rate request %d\n", reqMsg->baudrate);
 
-    TRACE_FBL_INFO("FBL: Valid invalidate request\n");
-    (void)extflash_write(logAddr, invalidSignValue, FLASH_WRITE_PAGE_SIZE);
-    fblData->imgAddr = reqMsg->blkAddr;
-    fblData->imgSize = reqMsg->blkSize;
+    /* The new baud rate is applied after the ACK has been sent */
+    fblData->newBaudrate = reqMsg->baudrate;
+    fblData->baudTimeout = (0 == reqMsg->timeout) ? FBL_BAUDRATE_TIMEOUT : reqMsg->timeout;
   }
   return errCode;
 }
@@ -288,47 +2519,46 @@ uint32 fbl_procInvalidateMsg(T_FBL_DATA* fblData, T_PDU* reqPdu)
 
 /*
  ******************************************************************************
- *
+ * Function: fbl_procDigestMsg
  ******************************************************************************
- *
+ * @brief Check a digest request
  *
  ******************************************************************************
  */
 
-uint32 fbl_procEraseMsg(T_FBL_DATA* fblData, T_PDU* reqPdu)
+uint32 fbl_procDigestMsg(T_FBL_DATA* fblData, T_PDU* reqPdu)
 {
-  T_FBL_MSG_ERASE_REQ* reqMsg = (T_FBL_MSG_ERASE_REQ*)reqPdu->data;
+  T_FBL_MSG_DIGEST_REQ* reqMsg = (T_FBL_MSG_DIGEST_REQ*)reqPdu->data;
   uint32 errCode = BCP_ERR_ID_eNONE;
 
-  // TODO: Handle update sequence state checking
-  
+  (void)fblData;
+
   /* Check for correct size of expected message */
-  if(reqPdu->len != sizeof(T_FBL_MSG_ERASE_REQ))
+  if(reqPdu->len != sizeof(T_FBL_MSG_DIGEST_REQ))
   {
     /* Unexpected size */
     TRACE_FBL_INFO("FBL: Unexpected size %d\n", reqPdu->len);
     errCode = BCP_ERR_ID_eINVALID_SIZE;
   }
-  else if(reqMsg->blkAddr != fblData->imgAddr)
+  else if( (0 == reqMsg->numBlks) || (reqMsg->numBlks > FBL_DIGEST_MAX_BLKS) )
   {
-    /* Invalid start address */
+    /* Invalid number of blocks */
     errCode = BCP_ERR_ID_eINVALID_DATA;
   }
-  else if(reqMsg->blkSize != fblData->imgSize)
+  else if(0 != (reqMsg->blkAddr & (FBL_BLK_SIZE - 1)))
   {
-    /* Invalid size */
+    /* Improper alignment of block address */
+    errCode = BCP_ERR_ID_eINVALID_DATA;
+  }
+  else if( (reqMsg->blkAddr < FBL_APP_START_ADDR)
+        || ((reqMsg->blkAddr - FBL_APP_START_ADDR) + (reqMsg->numBlks * FBL_BLK_SIZE) > FBL_APP_MAX_SIZE) )
+  {
+    /* Range outside of the application region */
     errCode = BCP_ERR_ID_eINVALID_DATA;
   }
   else
   {
-    uint32 logAddr = FBL_APP_ENTRY_ADDR - 0x60000000;
-    uint32 regionSize = 256 * 1024;
-
-    TRACE_FBL_INFO("FBL: Valid erase request\n");
-    (void)extflash_erase(logAddr, regionSize);
-
-    // TODO: Blank check
-    //extflash_blankCheck(logAddr, regionSize);
+    TRACE_FBL_INFO("FBL: Valid digest request\n");
   }
   return errCode;
 }
@@ -336,73 +2566,60 @@ uint32 fbl_procEraseMsg(T_FBL_DATA* fblData, T_PDU* reqPdu)
 
 /*
  ******************************************************************************
- *
+ * Function: fbl_sendDigestRsp
  ******************************************************************************
+ * @brief Send the digests of the requested blocks
  *
+ * @par Description:
+ *   The DCP hashes each block through the memory mapped flash window.
+ *   If hashing fails, the response holds the blocks hashed so far, so the
+ *   host requests the remaining ones again.
  *
  ******************************************************************************
  */
 
-uint32 fbl_procProgramMsg(T_FBL_DATA* fblData, T_PDU* reqPdu)
+void fbl_sendDigestRsp(T_PDU* reqPdu)
 {
-  T_FBL_MSG_PROGRAM_REQ* reqMsg = (T_FBL_MSG_PROGRAM_REQ*)reqPdu->data;
-  uint32 errCode = BCP_ERR_ID_eNONE;
+  T_FBL_MSG_DIGEST_REQ* reqMsg = (T_FBL_MSG_DIGEST_REQ*)reqPdu->data;
+  T_FBL_MSG_DIGEST_RSP* rspMsg = NULL;
+  T_PDU  rspPdu;
+  uint32 blkAddr = reqMsg->blkAddr;
+  uint32 blkIdx;
+  uint8  digestSize;
 
-  // TODO: Handle update sequence state checking
-  
-  /* Check for correct size of expected message */
-  if(reqPdu->len != sizeof(T_FBL_MSG_PROGRAM_REQ))
-  {
-    /* Unexpected size */
-    TRACE_FBL_INFO("FBL: Unexpected size %d\n", reqPdu->len);
-    errCode = BCP_ERR_ID_eINVALID_SIZE;
-  }
-  else if(reqMsg->blkAddr < fblData->imgAddr)
-  {
-    /* Invalid block address */
-    errCode = BCP_ERR_ID_eINVALID_DATA;
-  }
-  else if(0 != (reqMsg->blkAddr & (FBL_ALIGN_SIZE - 1)))
-  {
-    /* Improper alignment of block address */
-    errCode = BCP_ERR_ID_eINVALID_DATA;
-  }
-  else if((reqMsg->blkAddr + FBL_ALIGN_SIZE) > (fblData->imgAddr + fblData->imgSize))
+  if(STATUS_eOK != bcp_allocTxPdu(&rspPdu))
   {
-    /* Invalid block address */
-    errCode = BCP_ERR_ID_eINVALID_DATA;
+    TRACE_FBL_ERROR("FBL Error\n");
   }
   else
   {
-    uint32 logAddr = reqMsg->blkAddr - FBL_FLASH_BASE_ADDR;
+    rspMsg = (T_FBL_MSG_DIGEST_RSP*)rspPdu.data;
+    rspMsg->msgType = FBL_MSG_ID_eDIGEST_RSP;
+    rspMsg->blkAddr = blkAddr;
 
-    TRACE_FBL_INFO("FBL: Valid program request\n");
-    if(reqMsg->blkAddr > FBL_APP_ENTRY_ADDR)
-    {
-      /* Block start is beyond application entry */
-    }
-    else if((reqMsg->blkAddr + FBL_BLK_SIZE) < FBL_APP_ENTRY_ADDR)
+    for(blkIdx = 0; blkIdx < reqMsg->numBlks; blkIdx++)
     {
-      /* Block end is less then application entry */
+      digestSize = FBL_DIGEST_SIZE;
+      if(STATUS_eOK != dcp_hash(FBL_DCP_HASH_CHAN, rspMsg->digest[blkIdx], &digestSize,
+                                (const uint8*)(blkAddr + (blkIdx * FBL_BLK_SIZE)), FBL_BLK_SIZE))
+      {
+        TRACE_FBL_ERROR("FBL: Digest failed\n");
+        break;
+      }
     }
-    else
-    {
-      /* The current block contains the entry vector, which needs to be
-       * copied to a safe location and replaced by the flash blank value.
-       * 60010404 - 60010000 = 00000404;
-       * 0x4
-       */
-      uint32 entryOffs = FBL_APP_ENTRY_ADDR & (FBL_BLK_SIZE - 1);
-      uint32 blankValue = FLASH_BLANK_VALUE;
+    rspMsg->numBlks = blkIdx;
 
-      libc_memcpy(&fblData->entryVect, &reqMsg->blkData[entryOffs], sizeof(fblData->entryVect));
-      fblData->entryVectInv = (uint32)~(fblData->entryVect);
+    rspPdu.len = offsetof(T_FBL_MSG_DIGEST_RSP, digest) + (blkIdx * FBL_DIGEST_SIZE);
+  }
 
-      libc_memcpy(&reqMsg->blkData[entryOffs], &blankValue, sizeof(fblData->entryVect));
-    }
-    (void)extflash_write(logAddr, reqMsg->blkData, FBL_ALIGN_SIZE);
+  if(NULL == rspMsg)
+  {
+    /* */
+  }
+  else if(STATUS_eOK != bcp_sendMsg(&rspPdu))
+  {
+    TRACE_FBL_ERROR("FBL Error\n");
   }
-  return errCode;
 }
 
 
@@ -415,43 +2632,21 @@ uint32 fbl_procProgramMsg(T_FBL_DATA* fblData, T_PDU* reqPdu)
  ******************************************************************************
  */
 
-uint32 fbl_procActivateMsg(T_FBL_DATA* fblData, T_PDU* reqPdu)
+static void fbl_switchBaudrate(T_FBL_DATA* fblData)
 {
-  T_FBL_MSG_ACTIVATE_REQ* reqMsg = (T_FBL_MSG_ACTIVATE_REQ*)reqPdu->data;
-  uint32 errCode = BCP_ERR_ID_eNONE;
+  fblData->prevBaudrate = uart_getBaudrate(COM_UART);
 
-  // TODO: Handle update sequence state checking
-  
-  /* Check for correct size of expected message */
-  if(reqPdu->len != sizeof(T_FBL_MSG_ACTIVATE_REQ))
-  {
-    /* Unexpected size */
-    TRACE_FBL_INFO("FBL: Unexpected size %d\n", reqPdu->len);
-    errCode = BCP_ERR_ID_eINVALID_SIZE;
-  }
-  else if(reqMsg->blkAddr != fblData->imgAddr)
-  {
-    /* Invalid start address */
-    errCode = BCP_ERR_ID_eINVALID_DATA;
-  }
-  else if(reqMsg->blkSize != fblData->imgSize)
+  if(UART_OK != uart_setBaudrate(COM_UART, fblData->newBaudrate))
   {
-    /* Invalid size */
-    errCode = BCP_ERR_ID_eINVALID_DATA;
-  }
-  // TODO: Check for correct image CRC
-  else if(fblData->entryVect != ~(fblData->entryVectInv))
-  {
-    errCode = BCP_ERR_ID_eINCONSISTENT;
+    TRACE_FBL_ERROR("FBL: Baud rate switch failed\n");
   }
   else
   {
-    uint32 logAddr = FBL_APP_ENTRY_ADDR - 0x60000000;
-
-    TRACE_FBL_INFO("FBL: Valid activate request\n");
-    (void)extflash_write(logAddr, (uint8*)(void*)&fblData->entryVect, sizeof(fblData->entryVect));
+    /* Start supervision of the new baud rate */
+    fblData->baudTimeCnt = fblData->baudTimeout;
+    TRACE_FBL_INFO("FBL: Switched to %d baud\n", fblData->newBaudrate);
   }
-  return errCode;
+  fblData->newBaudrate = 0;
 }
 
 
@@ -464,24 +2659,26 @@ uint32 fbl_procActivateMsg(T_FBL_DATA* fblData, T_PDU* reqPdu)
  ******************************************************************************
  */
 
-uint32 fbl_procRestartMsg(T_FBL_DATA* fblData, T_PDU* reqPdu)
+static void fbl_superviseBaudrate(T_FBL_DATA* fblData)
 {
-  uint32 errCode = BCP_ERR_ID_eNONE;
-
-  // TODO: Handle update sequence state checking
-  
-  /* Check for correct size of expected message */
-  if(reqPdu->len != sizeof(T_FBL_MSG_RESET_REQ))
+  if(0 == fblData->baudTimeCnt)
   {
-    /* Unexpected size */
-    TRACE_FBL_INFO("FBL: Unexpected size %d\n", reqPdu->len);
-    errCode = BCP_ERR_ID_eINVALID_SIZE;
+    /* No baud rate switch pending to be confirmed */
+  }
+  else if(fblData->baudTimeCnt > 1)
+  {
+    fblData->baudTimeCnt--;
+  }
+  else if(UART_OK != uart_setBaudrate(COM_UART, fblData->prevBaudrate))
+  {
+    /* Transmitter busy, retry with next cycle */
   }
   else
   {
-    TRACE_FBL_INFO("FBL: Valid restart request\n");
+    /* No valid frame received, so fall back to the previous baud rate */
+    fblData->baudTimeCnt = 0;
+    TRACE_FBL_INFO("FBL: Fall back to %d baud\n", fblData->prevBaudrate);
   }
-  return errCode;
 }
 
 
@@ -515,6 +2712,19 @@ static void fbl_execRecvReq(T_FBL_DATA* fblData)
   if(BCP_STATUS_eIDLE != bcpStatus)
   {
     /* BCP is busy */
+#if (FBL_LAZY_ERASE == STD_ON) && (FBL_STAGE_ENA == STD_ON)
+    /* Streamed frames follow back to back without waiting for a response,
+     * so more than the single worst case frame the receive buffer is sized
+     * for may arrive while the next frame waits for an erase to complete.
+     * Nothing is erased while streaming.
+     */
+    if(FALSE == fblData->streamEna)
+    {
+      fbl_eraseAhead(fblData);
+    }
+#elif (FBL_LAZY_ERASE == STD_ON)
+    fbl_eraseAhead(fblData);
+#endif /* (FBL_LAZY_ERASE) */
   }
   /* Check for job result */
   else if(BCP_JOB_RESULT_eOK != bcp_getJobResult())
@@ -531,8 +2741,19 @@ static void fbl_execRecvReq(T_FBL_DATA* fblData)
 
     reqMsg = (T_BCP_MSG*)rxPdu.data;
 
+    /* A valid frame confirms the current baud rate */
+    fblData->baudTimeCnt = 0;
+
+#if (FBL_LAZY_ERASE == STD_ON)
+    /* The request may access the flash */
+    fbl_finishEraseAhead(fblData);
+#endif /* (FBL_LAZY_ERASE == STD_ON) */
+
     /* Dispatch message */
     msgType = reqMsg->msgType;
+#if (FBL_STAGE_ENA == STD_ON)
+    fblData->streamEna = (FBL_MSG_ID_eSTREAM_REQ == msgType);
+#endif /* (FBL_STAGE_ENA == STD_ON) */
     switch(msgType)
     {
     case FBL_MSG_ID_eBOOTSTRAP_REQ:
@@ -551,6 +2772,14 @@ static void fbl_execRecvReq(T_FBL_DATA* fblData)
       }
       break;
 
+    case FBL_MSG_ID_eCAPS_REQ:
+      errCode = fbl_procCapsMsg(fblData, &rxPdu);
+      if(BCP_ERR_ID_eNONE == errCode)
+      {
+        fbl_sendCapsRsp();
+      }
+      break;
+
     case FBL_MSG_ID_eINVALIDATE_REQ:
       errCode = fbl_procInvalidateMsg(fblData, &rxPdu);
       if(BCP_ERR_ID_eNONE == errCode)
@@ -575,6 +2804,55 @@ static void fbl_execRecvReq(T_FBL_DATA* fblData)
       }
       break;
 
+    case FBL_MSG_ID_eFILL_REQ:
+      errCode = fbl_procFillMsg(fblData, &rxPdu);
+      if(BCP_ERR_ID_eNONE == errCode)
+      {
+        bcp_sendAckRsp(msgType);
+      }
+      break;
+
+#if (FBL_WRITE_AVOID == STD_ON)
+    case FBL_MSG_ID_eKEEP_REQ:
+      errCode = fbl_procKeepMsg(fblData, &rxPdu);
+      if(BCP_ERR_ID_eNONE == errCode)
+      {
+        bcp_sendAckRsp(msgType);
+      }
+      break;
+#endif /* (FBL_WRITE_AVOID == STD_ON) */
+
+#if (FBL_STAGE_ENA == STD_ON)
+    case FBL_MSG_ID_eSTAGE_REQ:
+      errCode = fbl_procStageMsg(fblData, &rxPdu);
+      if(BCP_ERR_ID_eNONE == errCode)
+      {
+        bcp_sendAckRsp(msgType);
+      }
+      break;
+
+    case FBL_MSG_ID_eCOMMIT_REQ:
+      errCode = fbl_procCommitMsg(fblData, &rxPdu);
+      if(BCP_ERR_ID_eNONE == errCode)
+      {
+        bcp_sendAckRsp(msgType);
+      }
+      break;
+
+    case FBL_MSG_ID_eWINDOW_REQ:
+      errCode = fbl_procWindowMsg(fblData, &rxPdu);
+      if(BCP_ERR_ID_eNONE == errCode)
+      {
+        fbl_sendWindowRsp(fblData);
+      }
+      break;
+
+    case FBL_MSG_ID_eSTREAM_REQ:
+      /* Not answered */
+      errCode = fbl_procStreamMsg(fblData, &rxPdu);
+      break;
+#endif /* (FBL_STAGE_ENA == STD_ON) */
+
     case FBL_MSG_ID_eACTIVATE_REQ:
       errCode = fbl_procActivateMsg(fblData, &rxPdu);
       if(BCP_ERR_ID_eNONE == errCode)
@@ -591,6 +2869,32 @@ static void fbl_execRecvReq(T_FBL_DATA* fblData)
       }
       break;
 
+    case FBL_MSG_ID_eBAUDRATE_REQ:
+      errCode = fbl_procBaudrateMsg(fblData, &rxPdu);
+      if(BCP_ERR_ID_eNONE == errCode)
+      {
+        bcp_sendAckRsp(msgType);
+      }
+      break;
+
+    case FBL_MSG_ID_eDIGEST_REQ:
+      errCode = fbl_procDigestMsg(fblData, &rxPdu);
+      if(BCP_ERR_ID_eNONE == errCode)
+      {
+        fbl_sendDigestRsp(&rxPdu);
+      }
+      break;
+
+#if (FBL_RESUME_ENA == STD_ON)
+    case FBL_MSG_ID_eRESUME_REQ:
+      errCode = fbl_procResumeMsg(fblData, &rxPdu);
+      if(BCP_ERR_ID_eNONE == errCode)
+      {
+        fbl_sendResumeRsp();
+      }
+      break;
+#endif /* (FBL_RESUME_ENA == STD_ON) */
+
     default:
       TRACE_FBL_INFO("FBL: Unexpected msgType\n");
       errCode = BCP_ERR_ID_eINVALID_TYPE;
@@ -598,6 +2902,17 @@ static void fbl_execRecvReq(T_FBL_DATA* fblData)
     }
   }
 
+#if (FBL_STAGE_ENA == STD_ON)
+  /* The host doesn't wait for a response while streaming. A frame failing
+   * the CRC may be any request, so it's answered even while streaming.
+   */
+  if( (BCP_ERR_ID_eNONE != errCode) && (BCP_ERR_ID_eINVALID_CRC != errCode) && (FALSE != fblData->streamEna) )
+  {
+    /* Block dropped, it's reported missing by the window request */
+    (void)bcp_listen();
+  }
+  else
+#endif /* (FBL_STAGE_ENA == STD_ON) */
   /* Check for error code */
   if(BCP_ERR_ID_eNONE != errCode)
   {
@@ -617,6 +2932,13 @@ static void fbl_execRecvReq(T_FBL_DATA* fblData)
     fblData->state = FBL_STATE_eEXIT;
     TRACE_FBL_STATE("FBL: RECV_REQ -> EXIT\n");
   }
+#if (FBL_STAGE_ENA == STD_ON)
+  else if(FBL_MSG_ID_eSTREAM_REQ == msgType)
+  {
+    /* No response, so receive the next block */
+    (void)bcp_listen();
+  }
+#endif /* (FBL_STAGE_ENA == STD_ON) */
   else
   {
     /* Other command */
@@ -650,12 +2972,31 @@ static void fbl_execSendRsp(T_FBL_DATA* fblData)
   /* Check for job result */
   else if(BCP_JOB_RESULT_eOK != bcp_getJobResult())
   {
-    // TODO: Retransmit
+    /* Response lost, the host repeats the request on its timeout */
     TRACE_FBL_INFO("FBL: Transmission failed\n");
+
+    /* The baud rate request wasn't confirmed */
+    fblData->newBaudrate = 0;
+
+    fblData->state = FBL_STATE_eRECV_REQ;
+    TRACE_FBL_STATE("FBL: SEND_RSP -> RECV_REQ\n");
+
+    bcp_listen();
+  }
+  /* Check whether the response has left the transmitter completely */
+  else if( (0 != fblData->newBaudrate) && (FALSE != uart_isTxBusy(COM_UART)) )
+  {
+    /* Wait before switching the baud rate */
   }
   /* Boot Control Protocol transmitted complete frame. */
   else
   {
+    if(0 != fblData->newBaudrate)
+    {
+      /* Recent request was a baud rate request, which has been ACKed */
+      fbl_switchBaudrate(fblData);
+    }
+
     /* The recent request was not a restart request */
     fblData->state = FBL_STATE_eRECV_REQ;
     TRACE_FBL_STATE("FBL: SEND_RSP -> RECV_REQ\n");
@@ -712,7 +3053,7 @@ static void fbl_execReboot(T_FBL_DATA* fblData)
 
   if(fblData->timeCnt > 0)
   {
-    fblData->timeCnt--;
+    /* Delay counted by fbl_tick() */
   }
   else if(BCP_STATUS_eIDLE != bcp_getStatus())
   {
@@ -744,12 +3085,43 @@ void fbl_init(void)
   /* Initialize FBL data */
   libc_memset(fblData, 0, sizeof(T_FBL_DATA));
 
+  /* Set up the DCP channel for the block digests */
+  dcp_initDev(0);
+  dcp_configDev(0, &fbl_dcpCfg);
+  dcp_configChannel(FBL_DCP_HASH_CHAN, &fbl_dcpHashCfg);
+
   /* Initialize state and flags */
   fblData->state = FBL_STATE_eINIT;
   TRACE_FBL_STATE("FBL: RESET -> INIT\n");
 }
 
 
+/*
+ ******************************************************************************
+ * Function: fbl_tick
+ ******************************************************************************
+ * @brief Count the FBL timeouts
+ *
+ * @par Description:
+ *   Called on every system tick, while fbl_run() is called on received or
+ *   transmitted frames as well.
+ *
+ ******************************************************************************
+ */
+
+void fbl_tick(void)
+{
+  T_FBL_DATA* fblData = fbl_dataTbl;
+
+  fbl_superviseBaudrate(fblData);
+
+  if( (FBL_STATE_eREBOOT == fblData->state) && (fblData->timeCnt > 0) )
+  {
+    fblData->timeCnt--;
+  }
+}
+
+
 /*
  ******************************************************************************
  *
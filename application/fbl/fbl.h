@@ -3,6 +3,7 @@
 
 extern void fbl_init(void);
 extern void fbl_run(void);
+extern void fbl_tick(void);
 
 extern void fbl_enter(void);
 
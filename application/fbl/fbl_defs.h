@@ -5,6 +5,40 @@
 #define FBL_ALIGN_SIZE 0x400
 #define FBL_BLK_SIZE   0x400
 
+/* Leading bytes of a block's SHA-256 returned by the digest request */
+#define FBL_DIGEST_SIZE     8
+/* Blocks per digest request, limited by the response buffer */
+#define FBL_DIGEST_MAX_BLKS 128
+
+/* Commit flag: erase the sectors of the window still pending at once */
+#define FBL_COMMIT_FLAG_BULK_ERASE 0x00000001
+
+/* Blocks of a streamed window, at most the staging arena */
+#define FBL_WINDOW_MAX_BLKS    256
+#define FBL_WINDOW_MAP_WORDS   ((FBL_WINDOW_MAX_BLKS + 31) / 32)
+
+/* Blocks of the application region tracked by the resume journal */
+#define FBL_RESUME_MAX_BLKS    1920
+#define FBL_RESUME_MAP_WORDS   ((FBL_RESUME_MAX_BLKS + 31) / 32)
+/* Size of the image digest identifying a resumable download */
+#define FBL_RESUME_DIGEST_SIZE 32
+
+/* Protocol version announced by the capabilities, major in the high byte */
+#define FBL_PROTO_VERSION      0x0100
+
+/* Maximum length of the capability TLVs */
+#define FBL_CAPS_MAX_LEN       128
+
+/* Feature flags of the capabilities */
+#define FBL_CAP_FEAT_BAUDRATE    0x00000001 /* Baud rate request */
+#define FBL_CAP_FEAT_DIGEST      0x00000002 /* Digest request */
+#define FBL_CAP_FEAT_FILL        0x00000004 /* Fill request */
+#define FBL_CAP_FEAT_STAGE       0x00000008 /* Stage and commit requests */
+#define FBL_CAP_FEAT_STREAM      0x00000010 /* Window and stream requests */
+#define FBL_CAP_FEAT_RESUME      0x00000020 /* Resume request */
+#define FBL_CAP_FEAT_LAZY_ERASE  0x00000040 /* Sectors erased on the first program */
+#define FBL_CAP_FEAT_WRITE_AVOID 0x00000080 /* Blocks matching the flash are skipped, keep request */
+
 #define FBL_BOOTSTRAP_TOKEN  {'B', 'O', 'O', 'T'}
 
 //#define FBL_BOOTSTRAP_TOKEN (('B' << 24) | ('O' << 16) | ('O' << 8) | ('T' << 0))
@@ -25,6 +59,37 @@ enum FBL_MSG_ID
   FBL_MSG_ID_eACK_RSP,
   FBL_MSG_ID_eNAK_RSP,
   FBL_MSG_ID_eSWINFO_RSP,
+  FBL_MSG_ID_eBAUDRATE_REQ,
+  FBL_MSG_ID_eDIGEST_REQ,
+  FBL_MSG_ID_eDIGEST_RSP,
+  FBL_MSG_ID_eFILL_REQ,
+  FBL_MSG_ID_eSTAGE_REQ,
+  FBL_MSG_ID_eCOMMIT_REQ,
+  FBL_MSG_ID_eRESUME_REQ,
+  FBL_MSG_ID_eRESUME_RSP,
+  FBL_MSG_ID_eWINDOW_REQ,
+  FBL_MSG_ID_eWINDOW_RSP,
+  FBL_MSG_ID_eSTREAM_REQ,
+  FBL_MSG_ID_eCAPS_REQ,
+  FBL_MSG_ID_eCAPS_RSP,
+  FBL_MSG_ID_eKEEP_REQ,
+};
+
+/* Tags of the capability TLVs */
+enum FBL_CAP_TAG
+{
+  FBL_CAP_TAG_eINVALID = 0,
+  FBL_CAP_TAG_ePROTO_VERSION,  /* FBL_PROTO_VERSION */
+  FBL_CAP_TAG_eFEATURES,       /* FBL_CAP_FEAT_* */
+  FBL_CAP_TAG_eBLK_SIZE,       /* Block size of program, stage and stream requests */
+  FBL_CAP_TAG_eWINDOW_SIZE,    /* Size of the staging arena */
+  FBL_CAP_TAG_eDIGEST_SIZE,    /* Bytes of a block digest */
+  FBL_CAP_TAG_eDIGEST_MAX_BLKS,/* Blocks per digest request */
+  FBL_CAP_TAG_eAPP_START,      /* Start of the application region */
+  FBL_CAP_TAG_eAPP_MAX_SIZE,   /* Size of the application region */
+  FBL_CAP_TAG_eERASE_SIZE,     /* Erase sector size */
+  FBL_CAP_TAG_ePAGE_SIZE,      /* Program page size */
+  FBL_CAP_TAG_eMAX_BAUDRATE,   /* Highest baud rate */
 };
 
 enum BCP_ERR_ID
@@ -169,6 +234,109 @@ typedef struct
 }T_FBL_MSG_PROGRAM_REQ;
 
 
+/*
+ * Blocks filled by a repeated pattern aren't transferred. Blank blocks are
+ * left to the erase, so a blank fill follows the erase request. It's
+ * refused for blocks neither blank nor pending to be erased. Other
+ * patterns are programmed. The block holding the application entry can't
+ * be filled.
+ */
+typedef struct
+{
+  uint32 msgType;
+  uint32 blkAddr;  /* Block aligned start of the range */
+  uint32 blkSize;  /* Multiple of the block size */
+  uint32 pattern;  /* Word repeated over the range */
+}T_FBL_MSG_FILL_REQ;
+
+
+/*
+ * Blocks of a window are staged in RAM first. Staged blocks are contiguous
+ * and may be staged again. The commit checks the SHA-256 of the window and
+ * programs it. A bulk erase requires a sector aligned window.
+ */
+typedef struct
+{
+   uint32 msgType;
+   uint32 blkAddr;
+   uint8  blkData[FBL_BLK_SIZE];
+}T_FBL_MSG_STAGE_REQ;
+
+
+typedef struct
+{
+  uint32 msgType;
+  uint32 blkAddr;  /* Start of the staged window */
+  uint32 blkSize;  /* Size of the staged window */
+  uint32 flags;    /* FBL_COMMIT_FLAG_* */
+  uint8  digest[32]; /* SHA-256 of the window */
+}T_FBL_MSG_COMMIT_REQ;
+
+
+/*
+ * Blocks of a window are streamed into the staging arena without waiting
+ * for responses. Stream requests aren't answered. Frames failing the CRC
+ * are answered by a NAK of FBL_MSG_ID_eINVALID, as their request is
+ * unknown. The host ignores it while streaming, the blocks lost are
+ * reported missing. The window request opens a window and reports the
+ * blocks missing from it, so the host streams only those again. Blocks
+ * are reported for the open window only, windows are streamed one after
+ * the other. A complete window is committed by the commit request.
+ * Window and stream requests require FBL_STAGE_ENA, announced by
+ * FBL_CAP_FEAT_STREAM.
+ */
+typedef struct
+{
+  uint32 msgType;
+  uint32 blkAddr;  /* Block aligned start of the window */
+  uint32 blkSize;  /* Multiple of the block size, at most the staging arena */
+}T_FBL_MSG_WINDOW_REQ;
+
+
+typedef struct
+{
+  uint32 msgType;
+  uint32 blkAddr;
+  uint32 blkSize;
+  uint32 missMap[FBL_WINDOW_MAP_WORDS]; /* Bit set for each block missing, bit 0 at blkAddr */
+}T_FBL_MSG_WINDOW_RSP;
+
+
+typedef struct
+{
+   uint32 msgType;
+   uint32 blkAddr;
+   uint8  blkData[FBL_BLK_SIZE];
+}T_FBL_MSG_STREAM_REQ;
+
+
+/*
+ * A download is resumed, if session ID, image range and image digest match
+ * the journal of an interrupted download. The response lists the blocks
+ * verified so far and the host continues by programming the others,
+ * without an erase request. Otherwise a new journal is started, no block
+ * is listed and the host starts by the invalidate request. Blank fills
+ * aren't journaled, so they are repeated on a resume.
+ */
+typedef struct
+{
+  uint32 msgType;
+  uint32 sessionID; /* Chosen by the host for each download */
+  uint32 imgAddr;
+  uint32 imgSize;
+  uint8  imgDigest[FBL_RESUME_DIGEST_SIZE]; /* SHA-256 of the image */
+}T_FBL_MSG_RESUME_REQ;
+
+
+typedef struct
+{
+  uint32 msgType;
+  uint32 sessionID;
+  uint32 numBlks;  /* Blocks of the image */
+  uint32 blkMap[FBL_RESUME_MAP_WORDS]; /* Bit set for each verified block, bit 0 at imgAddr */
+}T_FBL_MSG_RESUME_RSP;
+
+
 typedef struct
 {
   uint32 msgType;
@@ -183,6 +351,76 @@ typedef struct
 }T_FBL_MSG_RESET_REQ;
 
 
+typedef struct
+{
+  uint32 msgType;
+  uint32 baudrate; /* New baud rate, applied after the ACK has been sent */
+  uint32 timeout;  /* Time in ms to confirm the new baud rate, 0 for default */
+}T_FBL_MSG_BAUDRATE_REQ;
+
+
+/*
+ * The host compares the block digests against its image and programs only
+ * the blocks differing. The block holding the application entry is to be
+ * programmed always, as its entry vector is taken from the program request.
+ * Blocks not programmed are kept by the keep request, otherwise the erase
+ * at the activation leaves them blank.
+ */
+typedef struct
+{
+  uint32 msgType;
+  uint32 blkAddr;  /* Block aligned address of the first block */
+  uint32 numBlks;  /* Number of blocks, 1 to FBL_DIGEST_MAX_BLKS */
+}T_FBL_MSG_DIGEST_REQ;
+
+
+typedef struct
+{
+  uint32 msgType;
+  uint32 blkAddr;
+  uint32 numBlks;
+  uint8  digest[FBL_DIGEST_MAX_BLKS][FBL_DIGEST_SIZE]; /* numBlks digests are sent */
+}T_FBL_MSG_DIGEST_RSP;
+
+
+/*
+ * Ranges holding the image already are kept with write avoidance. The
+ * request sequence is:
+ * invalidate, erase, digest, keep of each matching range, program of the
+ * other blocks, activate.
+ * The erase request is required, as it defers the erase of the image
+ * sectors. Keep requests precede the program requests, as sectors may be
+ * erased ahead of the programmed blocks. The SHA-256 of the range is
+ * checked against the flash, a mismatch is answered by INVALID_DATA and
+ * the range is to be programmed instead. Kept blocks are journaled.
+ */
+typedef struct
+{
+  uint32 msgType;
+  uint32 blkAddr;  /* Block aligned start of the range */
+  uint32 blkSize;  /* Multiple of the block size */
+  uint8  digest[32]; /* SHA-256 of the range */
+}T_FBL_MSG_KEEP_REQ;
+
+
+typedef struct
+{
+  uint32 msgType;
+}T_FBL_MSG_CAPS_REQ;
+
+
+/*
+ * Each capability is a TLV of a uint8 tag, a uint8 length and a little
+ * endian value of that length. Hosts skip unknown tags, a feature not
+ * listed isn't supported.
+ */
+typedef struct
+{
+  uint32 msgType;
+  uint8  tlv[FBL_CAPS_MAX_LEN];
+}T_FBL_MSG_CAPS_RSP;
+
+
 typedef struct
 {
   uint32 msgType;
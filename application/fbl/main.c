@@ -6,13 +6,24 @@
 #include "config.h"
 #include "irqc.h"
 #include "iomux.h"
+#include "gpio.h"
+#include "cpu_cyc.h"
+#include "cpu_cache.h"
+#include "cpu_mpu.h"
 #include "uart.h"
 #include "cpu_irq.h"
 #include "cmdl.h"
 #include "trace_pub.h"
 #include "bmgr.h"
+#include "pdu.h"
+#include "bcp.h"
+#include "fbl.h"
+#include "sched.h"
+#include "prof.h"
+#include "btl.h"
 #include "arm_nvic.h"
 #include "arm_sys_timer.h"
+#include "edma.h"
 
 
 void cpu_init(void)
@@ -33,6 +44,48 @@ void print_startMsg(void)
 }
 
 
+/* Sys timer callback, signals the 1ms tick */
+static void main_handleSysTick(void)
+{
+  sched_setEvent(SCHED_EVT_TICK);
+}
+
+
+/* UART event callback, signals received data or a drained transmit buffer */
+static void main_handleUartEvent(uint32 devID, uint32 evt)
+{
+  uint32 schedEvt = SCHED_EVT_NONE;
+
+  if(COM_UART == devID)
+  {
+    if(0 != (evt & UART_EVT_RX))
+    {
+      schedEvt |= SCHED_EVT_COM_RX;
+    }
+    if(0 != (evt & UART_EVT_TX_EMPTY))
+    {
+      schedEvt |= SCHED_EVT_COM_TX;
+    }
+  }
+  else if(STD_UART == devID)
+  {
+    if(0 != (evt & UART_EVT_RX))
+    {
+      schedEvt |= SCHED_EVT_STD_RX;
+    }
+  }
+  sched_setEvent(schedEvt);
+}
+
+
+/* BCP event callback, signals a received or transmitted frame */
+static void main_handleBcpEvent(uint32 evt)
+{
+  (void)evt;
+  sched_setEvent(SCHED_EVT_BCP_FRAME);
+}
+
+
 /* Pad configuration value for the LED pad */
 #define GPIO_PAD_CONF (0                            \
   | BF_SET(PADCONF_eHYS_SCHMITT, PADCONF_HYS_BF)    \
@@ -60,10 +113,97 @@ T_IOMUX_DESC gpio_pinCfg[] =
 };
 
 
+#if (FBL_CACHE_ENA == STD_ON)
+
+/* Memory attributes, later regions take precedence. Internal and flash
+ * memory is cached write-through, so buffers shared with DMA masters only
+ * need to be invalidated after the transfer.
+ */
+const T_CPU_MPU_REGION main_mpuRegionTbl[] =
+{
+  /* Whole address space: device memory, no execution */
+  { 0x00000000, MPU_RASR(32, MPU_RASR_MEM_DEVICE,      MPU_AP_eRW, 1) },
+  /* ITCM */
+  { 0x00000000, MPU_RASR(19, MPU_RASR_MEM_NORMAL_NC,   MPU_AP_eRW, 0) },
+  /* Boot ROM, provides ROM API and HAB */
+  { 0x00200000, MPU_RASR(17, MPU_RASR_MEM_NORMAL_WT,   MPU_AP_eRO, 0) },
+  /* DTCM */
+  { 0x20000000, MPU_RASR(19, MPU_RASR_MEM_NORMAL_NC,   MPU_AP_eRW, 1) },
+  /* OCRAM, holds the FBL code */
+  { 0x20200000, MPU_RASR(20, MPU_RASR_MEM_NORMAL_WT,   MPU_AP_eRW, 0) },
+  /* FlexSPI window, only programmed by IP commands */
+  { 0x60000000, MPU_RASR(29, MPU_RASR_MEM_NORMAL_WT,   MPU_AP_eRO, 0) },
+};
+
+#endif /* (FBL_CACHE_ENA == STD_ON) */
+
+
+#if (FBL_FAST_BOOT == STD_ON)
+
+/* COM_UART's RX pad as GPIO input for the line activity probe */
+#define MAIN_COM_RX_PROBE_PIN GPIO_PIN_ID(0, 13)
+
+const T_IOMUX_DESC main_comRxProbePinCfg[] =
+{
+  /* GPIO01_IO13 */
+  [0] =
+  {
+    .padConf = PAD_CNF_DEF(PADCONF_GPIO1_IO13__GPIO_AD_B0_13_ALT5_OFFS, GPIO_PAD_CONF),
+    .muxConf = MUX_CNF_DEF(MUXCONF_GPIO1_IO13__GPIO_AD_B0_13_ALT5_OFFS, 5, 0),
+    .inpConf = INP_CNF_DEF(0, 0),
+  },
+  { 0 },
+};
+
+
+/* Probe the idle high COM_UART RX line for a start bit or break of a host.
+ * The pad is muxed back to the UART by uart_initDev().
+ */
+static boolean main_isComHostActive(void)
+{
+  boolean result = FALSE;
+  uint32 cycStart;
+  uint32 cycProbe = FBL_FAST_BOOT_PROBE_TIME * (CPU_CORE_CLK_FREQ / 1000000u);
+
+  iomux_setupMultiplePads(main_comRxProbePinCfg);
+  gpio_setPinDirIn(MAIN_COM_RX_PROBE_PIN);
+
+  cycStart = cpu_getCycleCount();
+  while( (FALSE == result) && ((cpu_getCycleCount() - cycStart) < cycProbe) )
+  {
+    if(0 == gpio_getPin(MAIN_COM_RX_PROBE_PIN))
+    {
+      /* Line driven low */
+      result = !FALSE;
+    }
+  }
+  return result;
+}
+
+#endif /* (FBL_FAST_BOOT == STD_ON) */
+
+
 int main(void)
 {
 //  int cnt = 0;
 
+  /* Start boot timeline */
+  btl_init();
+
+#if (FBL_CACHE_ENA == STD_ON)
+  /* Set up memory attributes and enable the caches */
+  cpu_initMpu(main_mpuRegionTbl, sizeof(main_mpuRegionTbl) / sizeof(main_mpuRegionTbl[0]));
+  cpu_enableICache();
+  cpu_enableDCache();
+#endif /* (FBL_CACHE_ENA == STD_ON) */
+
+#if (FBL_FAST_BOOT == STD_ON)
+  /* Enter a valid application before any loader peripheral is set up,
+   * returns if the loader is needed or a host was detected.
+   */
+  bmgr_fastBoot(main_isComHostActive());
+#endif /* (FBL_FAST_BOOT == STD_ON) */
+
   /* Setup NVIC */
   nvic_setPriorityGrouping(3);
 
@@ -73,18 +213,39 @@ int main(void)
   /* Initialize debug uart */
   uart_initDev(STD_UART);
   uart_configCtl(STD_UART, &uart_ctlDevCfgTbl[0]);
+  btl_mark(NOINIT_BTL_EVT_eSTD_UART_INIT);
 
   trace_init();
+  btl_mark(NOINIT_BTL_EVT_eTRACE_INIT);
   
+#if (COM_UART_DMA == STD_ON)
+  /* Initialize DMA controller used by communication uart */
+  edma_initDev();
+#endif /* (COM_UART_DMA == STD_ON) */
+
   /* Initialize communication uart */
   uart_initDev(COM_UART);
   uart_configCtl(COM_UART, &uart_ctlDevCfgTbl[1]);
+  btl_mark(NOINIT_BTL_EVT_eCOM_UART_INIT);
+
+  /* Initialize profiling probes */
+  prof_init();
+
+  /* Initialize scheduler */
+  sched_init();
 
   /* Initialize system timer for 1ms interval */
-  arm_initSysTimer(0, 396000000/1000);
+  arm_initSysTimer(0, CPU_CORE_CLK_FREQ/1000);
+  arm_setSystTimerCallback(&main_handleSysTick);
+  arm_enableSysTimerIrq();
+
+  /* Signal UART events to the scheduler */
+  uart_setEventCallback(STD_UART, &main_handleUartEvent);
+  uart_setEventCallback(COM_UART, &main_handleUartEvent);
 
   /* Initialize CPU and print start message */
   cpu_init();
+  btl_mark(NOINIT_BTL_EVT_eSYS_INIT);
   print_startMsg();
 
 
@@ -93,18 +254,30 @@ int main(void)
 
   /* Initialize boot control protocol */
   bcp_init();
+  bcp_setEventCallback(&main_handleBcpEvent);
+
+  /* Initialize flash bootloader */
+  fbl_init();
 
   /* Initialize boot manager */
   bmgr_init();
+  btl_mark(NOINIT_BTL_EVT_eINIT_DONE);
+
+  /* Register tasks in order of execution. BMGR and FBL are run once BCP
+   * received or transmitted a frame, which is the pass following BCP's.
+   * Their timeouts count ticks, so they are counted on the tick only.
+   */
+  sched_addTask("bcp", &bcp_run, SCHED_EVT_TICK | SCHED_EVT_COM_RX | SCHED_EVT_COM_TX);
+  sched_addTask("bmgrTick", &bmgr_tick, SCHED_EVT_TICK);
+  sched_addTask("bmgr", &bmgr_run, SCHED_EVT_TICK | SCHED_EVT_BCP_FRAME);
+  sched_addTask("fblTick", &fbl_tick, SCHED_EVT_TICK);
+  sched_addTask("fbl", &fbl_run, SCHED_EVT_TICK | SCHED_EVT_BCP_FRAME);
+  sched_addTask("cmdl", &cmdl_run, SCHED_EVT_TICK | SCHED_EVT_STD_RX);
 
   while(1)
   {
-    /* Check for timer expiration */
-    if(0 != arm_pollSysTimer())
-    {
-    }
-
-    cmdl_run();
+    /* Run tasks on pending events or sleep until the next interrupt */
+    sched_run();
   }
 }
 
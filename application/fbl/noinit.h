@@ -3,16 +3,62 @@
 
 /* Data structure to hold the boot strap request from the application.
  * it is intended to be located to a RAM section which is not initialized
- * by the startup
+ * by the startup.
+ * The section is linked to the start of OCRAM, so the application finds
+ * it at NOINIT_DATA_ADDR.
  */
 
+#define NOINIT_DATA_ADDR    0x20208000
+
+#if !defined(__ASSEMBLER__)
+
+/* Boot timeline tag "BTL1" */
+#define NOINIT_BTL_TAG      0x314C5442
+#define NOINIT_BTL_MAX_EVTS 16
+
+/* Boot milestones */
+enum NOINIT_BTL_EVT_ID
+{
+  NOINIT_BTL_EVT_eMAIN = 0,       /* Entered main() */
+  NOINIT_BTL_EVT_eSTD_UART_INIT,  /* STD_UART initialized */
+  NOINIT_BTL_EVT_eTRACE_INIT,     /* Trace initialized */
+  NOINIT_BTL_EVT_eCOM_UART_INIT,  /* COM_UART initialized */
+  NOINIT_BTL_EVT_eSYS_INIT,       /* Scheduler, timer and IRQs set up */
+  NOINIT_BTL_EVT_eAPP_CHECKED,    /* Application image checked */
+  NOINIT_BTL_EVT_eINIT_DONE,      /* All modules initialized */
+  NOINIT_BTL_EVT_eWAIT_CMD_END,   /* Command wait window expired */
+  NOINIT_BTL_EVT_eAPP_AUTH,       /* Application image authenticated */
+  NOINIT_BTL_EVT_eENTER_APP,      /* Jumping into the application */
+  NOINIT_BTL_EVT_eENTER_FBL,      /* Entering the flash bootloader */
+  MAX_NOINIT_BTL_EVT_ID,
+};
+
+/* Boot timeline entry, cycles are counted since the previous entry */
+typedef struct
+{
+   uint32 evtID;
+   uint32 cycles;
+}T_NOINIT_BTL_EVT;
+
+/* Boot timeline */
+typedef struct
+{
+   uint32 tag;
+   uint32 numEvts;
+   uint32 cpuFreq;
+   uint32 lastCycCnt;
+   T_NOINIT_BTL_EVT evts[NOINIT_BTL_MAX_EVTS];
+}T_NOINIT_BTL;
+
 typedef struct
 {
    uint32 entryReqLo;
    uint32 entryReqHi;
    uint8  reserved[8];
+   T_NOINIT_BTL bootTl;
 }T_NOINIT_DATA;
 
 T_NOINIT_DATA* noinit_getData(void);
+#endif /* !defined(__ASSEMBLER__) */
 
 #endif /* NOINIT_H */
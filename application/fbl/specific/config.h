@@ -4,7 +4,46 @@
 #define STD_UART 2
 #define COM_UART 0
 
+/* Transfer COM_UART data by eDMA instead of interrupts */
+#define COM_UART_DMA STD_OFF
+
 #define MAIN_STACK_SIZE 1024
 
+/* Core clock as set up by the boot ROM */
+#define CPU_CORE_CLK_FREQ 396000000u
+
+/* Enable MPU regions, I- and D-cache */
+#define FBL_CACHE_ENA STD_ON
+
+/* Jump into a valid application before the loader peripherals are set up */
+#define FBL_FAST_BOOT STD_ON
+
+/* Time the COM_UART RX line is probed for a host [us] */
+#define FBL_FAST_BOOT_PROBE_TIME 2000
+
+/* Time to wait for a bootstrap request once a host was detected [ms] */
+#define FBL_FAST_BOOT_CMD_TIMEOUT 1000
+
+/* Erase sectors on the first program into them instead of on the erase request */
+#define FBL_LAZY_ERASE STD_ON
+
+/* Number of sectors erased ahead of the write pointer while receiving */
+#define FBL_ERASE_AHEAD_SECTORS 2
+
+/* Skip blocks matching the flash and program without erase, if no bit is to be set */
+#define FBL_WRITE_AVOID STD_ON
+
+/* Stage image windows in the FlexRAM OCRAM and program them on commit */
+#define FBL_STAGE_ENA STD_ON
+
+/* Size of the staging arena, at most the FlexRAM OCRAM */
+#define FBL_STAGE_SIZE (256 * 1024)
+
+/* Journal the download progress in flash, so a resume request continues an interrupted download */
+#define FBL_RESUME_ENA STD_ON
+
+/* Highest COM_UART baud rate announced to the host, UART reference clock / minimum oversampling */
+#define FBL_MAX_BAUDRATE 6000000u
+
 #endif /* CONFIG_H */
 
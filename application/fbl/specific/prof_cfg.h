@@ -0,0 +1,36 @@
+#ifndef PROF_CFG_H
+#define PROF_CFG_H
+
+/* Enable cycle counter probes */
+#define PROF_ENA STD_ON
+
+/*!
+ * Define the probes to be passed to the
+ * PROF_START() and PROF_STOP() macros
+ */
+enum PROF_ID
+{
+  PROF_ID_eDLCF_RX_BYTE = 0,  /* dlcf_procRxByte() */
+  PROF_ID_eBCP_FRAME_CRC,     /* bcp_isFrameCrcValid() */
+  PROF_ID_eFLASH_WRITE,       /* extflash_write() */
+  PROF_ID_eFLASH_ERASE,       /* extflash_erase() */
+  PROF_ID_eFLASH_OPEN,        /* extflash_open() */
+  PROF_ID_eDCP_HASH,          /* dcp_hash() */
+  MAX_PROF_ID,                /* Number of probes */
+};
+
+
+/* List of probe names */
+#ifdef PROF_C
+const char* prof_nameList[MAX_PROF_ID] =
+{
+  [PROF_ID_eDLCF_RX_BYTE]  = "dlcfRxByte",
+  [PROF_ID_eBCP_FRAME_CRC] = "bcpFrameCrc",
+  [PROF_ID_eFLASH_WRITE]   = "flashWrite",
+  [PROF_ID_eFLASH_ERASE]   = "flashErase",
+  [PROF_ID_eFLASH_OPEN]    = "flashOpen",
+  [PROF_ID_eDCP_HASH]      = "dcpHash",
+};
+#endif /* PROF_C */
+
+#endif /* PROF_CFG_H */
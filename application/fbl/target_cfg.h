@@ -4,6 +4,7 @@
 #define FBL_FLASH_BASE_ADDR  0x60000000
 #define FBL_APP_START_ADDR   0x60010000
 #define FBL_APP_END_ADDR     0x7EFFFFFF
+#define FBL_APP_MAX_SIZE     (1920 * 1024) /* APP_CODE region of the linker map */
 
 #define FBL_APP_IVT_OFFS     (0x000)
 #define FBL_APP_SWINFO_OFFS  (0x200)
@@ -15,5 +16,9 @@
 
 #define FBL_APP_ENTRY_WORD   0x00000001
 
+/* Download journal in the last sector of the FBL region */
+#define FBL_JOURNAL_SIZE     0x1000
+#define FBL_JOURNAL_ADDR     (FBL_APP_START_ADDR - FBL_JOURNAL_SIZE)
+
 #endif /* TARGET_CFG_H */
 
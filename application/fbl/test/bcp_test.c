@@ -0,0 +1,294 @@
+#ifndef BCP_TEST_C
+#define BCP_TEST_C
+#endif /* BCP_TEST_C */
+
+#include "bsp.h"
+#include "pdu.h"
+#include "dlcf.h"
+#include "dlcf_loop.h"
+#include "fbl_defs.h"
+#include "bcp.h"
+
+#include <stdio.h>
+
+
+/*
+ * Host test of the BCP packet path
+ *
+ * BCP is bound to the DLCF loopback transport by bcp_setTransport(), so
+ * every message sent is received back by the same instance. The test
+ * plays the host sending a request and the FBL answering it.
+ */
+
+#define TEST_SLOT_SIZE 64u
+#define TEST_MAX_RUNS  8u
+
+#define TEST_CHECK(cond)                                                  \
+  do                                                                      \
+  {                                                                       \
+    if(!(cond))                                                           \
+    {                                                                     \
+      printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond);     \
+      test_numFailed++;                                                   \
+    }                                                                     \
+  }while(0)
+
+static uint8 test_slot[TEST_SLOT_SIZE];
+static T_DLCF_LOOP test_loop;
+static T_DLCF_DEV_INFO test_devInfo;
+static uint32 test_numFailed;
+static uint32 test_evtLog[TEST_MAX_RUNS];
+static uint32 test_numEvts;
+
+
+/*
+ ******************************************************************************
+ * dlcf_uart_recvByte, dlcf_uart_sendByte
+ ******************************************************************************
+ * Description:
+ *   COM_UART, as bound by bcp_init(), doesn't exist on the host.
+ *
+ ******************************************************************************
+ */
+
+boolean dlcf_uart_recvByte(void* param, uint8* byte)
+{
+  (void)param;
+  (void)byte;
+  return FALSE;
+}
+
+boolean dlcf_uart_sendByte(void* param, const uint8 byte)
+{
+  (void)param;
+  (void)byte;
+  return FALSE;
+}
+
+
+/*
+ ******************************************************************************
+ * test_handleEvent
+ ******************************************************************************
+ * Description:
+ *   BCP event callback, logs the events reported.
+ *
+ ******************************************************************************
+ */
+
+static void test_handleEvent(uint32 evt)
+{
+  if(test_numEvts < TEST_MAX_RUNS)
+  {
+    test_evtLog[test_numEvts] = evt;
+  }
+  test_numEvts++;
+}
+
+
+/*
+ ******************************************************************************
+ * test_runBcp
+ ******************************************************************************
+ * Description:
+ *   The function runs BCP until the job is done and returns its result.
+ *
+ ******************************************************************************
+ */
+
+static T_BCP_JOB_RESULT test_runBcp(void)
+{
+  uint32 numRuns = 0;
+
+  while( (BCP_STATUS_eBUSY == bcp_getStatus()) && (numRuns < TEST_MAX_RUNS) )
+  {
+    bcp_run();
+    numRuns++;
+  }
+  return bcp_getJobResult();
+}
+
+
+/*
+ ******************************************************************************
+ * test_receive
+ ******************************************************************************
+ * Description:
+ *   The function receives the next message from the loopback transport.
+ *
+ ******************************************************************************
+ */
+
+static T_BCP_JOB_RESULT test_receive(T_PDU* rxMsg)
+{
+  T_BCP_JOB_RESULT result;
+
+  TEST_CHECK(STATUS_eOK == bcp_listen());
+  result = test_runBcp();
+  if(BCP_JOB_RESULT_eOK == result)
+  {
+    TEST_CHECK(STATUS_eOK == bcp_getRxMsg(rxMsg));
+  }
+  return result;
+}
+
+
+/*
+ ******************************************************************************
+ * test_roundTrip
+ ******************************************************************************
+ * Description:
+ *   A request is sent and received, then answered by an ACK response.
+ *   The packets carry the messages unframed, followed by the CRC.
+ *
+ ******************************************************************************
+ */
+
+static void test_roundTrip(void)
+{
+  T_FBL_MSG_SWINFO_REQ* reqMsg;
+  T_FBL_MSG_ACK_RSP* rspMsg;
+  T_PDU txMsg;
+  T_PDU rxMsg;
+
+  /* Host sends the request */
+  TEST_CHECK(STATUS_eOK == bcp_allocTxPdu(&txMsg));
+  reqMsg = (T_FBL_MSG_SWINFO_REQ*)txMsg.data;
+  reqMsg->msgType = FBL_MSG_ID_eSWINFO_REQ;
+  txMsg.len = sizeof(T_FBL_MSG_SWINFO_REQ);
+  TEST_CHECK(STATUS_eOK == bcp_sendMsg(&txMsg));
+  TEST_CHECK(BCP_JOB_RESULT_eOK == test_runBcp());
+  TEST_CHECK(FALSE != test_loop.full);
+  TEST_CHECK((sizeof(T_FBL_MSG_SWINFO_REQ) + sizeof(uint16)) == test_loop.len);
+
+  /* FBL receives the request */
+  TEST_CHECK(BCP_JOB_RESULT_eOK == test_receive(&rxMsg));
+  TEST_CHECK(FALSE == test_loop.full);
+  TEST_CHECK(sizeof(T_FBL_MSG_SWINFO_REQ) == rxMsg.len);
+  reqMsg = (T_FBL_MSG_SWINFO_REQ*)rxMsg.data;
+  TEST_CHECK(FBL_MSG_ID_eSWINFO_REQ == reqMsg->msgType);
+
+  /* FBL answers, host receives the response */
+  bcp_sendAckRsp(reqMsg->msgType);
+  TEST_CHECK(BCP_JOB_RESULT_eOK == test_runBcp());
+  TEST_CHECK(BCP_JOB_RESULT_eOK == test_receive(&rxMsg));
+  TEST_CHECK(sizeof(T_FBL_MSG_ACK_RSP) == rxMsg.len);
+  rspMsg = (T_FBL_MSG_ACK_RSP*)rxMsg.data;
+  TEST_CHECK(FBL_MSG_ID_eACK_RSP == rspMsg->msgType);
+  TEST_CHECK(FBL_MSG_ID_eSWINFO_REQ == rspMsg->reqType);
+
+  TEST_CHECK(0 == test_loop.dropped);
+}
+
+
+/*
+ ******************************************************************************
+ * test_crcError
+ ******************************************************************************
+ * Description:
+ *   A message corrupted on the transport fails the CRC check.
+ *
+ ******************************************************************************
+ */
+
+static void test_crcError(void)
+{
+  T_PDU rxMsg;
+
+  bcp_sendNakRsp(FBL_MSG_ID_eERASE_REQ, 1);
+  TEST_CHECK(BCP_JOB_RESULT_eOK == test_runBcp());
+  TEST_CHECK(FALSE != test_loop.full);
+
+  test_loop.buffer[0] ^= 0x01;
+  TEST_CHECK(BCP_JOB_RESULT_eFAILED == test_receive(&rxMsg));
+  TEST_CHECK(FALSE == test_loop.full);
+}
+
+
+/*
+ ******************************************************************************
+ * test_transport
+ ******************************************************************************
+ * Description:
+ *   The transport can't be changed while a job is pending.
+ *
+ ******************************************************************************
+ */
+
+static void test_transport(void)
+{
+  TEST_CHECK(STATUS_eOK == bcp_listen());
+  TEST_CHECK(BCP_JOB_RESULT_ePENDING == test_runBcp());
+  TEST_CHECK(STATUS_eOK != bcp_setTransport(&test_devInfo));
+
+  bcp_cancel();
+  TEST_CHECK(BCP_JOB_RESULT_eCANCELLED == bcp_getJobResult());
+  TEST_CHECK(STATUS_eOK != bcp_setTransport(NULL));
+}
+
+
+/*
+ ******************************************************************************
+ * test_event
+ ******************************************************************************
+ * Description:
+ *   Every frame transmitted or received is reported once by the event
+ *   callback, a frame failing the CRC check as well. A cancelled job isn't
+ *   reported.
+ *
+ ******************************************************************************
+ */
+
+static void test_event(void)
+{
+  T_PDU rxMsg;
+
+  test_numEvts = 0;
+  bcp_setEventCallback(&test_handleEvent);
+
+  bcp_sendAckRsp(FBL_MSG_ID_eSWINFO_REQ);
+  TEST_CHECK(BCP_JOB_RESULT_eOK == test_runBcp());
+  TEST_CHECK(BCP_JOB_RESULT_eOK == test_receive(&rxMsg));
+
+  bcp_sendAckRsp(FBL_MSG_ID_eSWINFO_REQ);
+  TEST_CHECK(BCP_JOB_RESULT_eOK == test_runBcp());
+  test_loop.buffer[0] ^= 0x01;
+  TEST_CHECK(BCP_JOB_RESULT_eFAILED == test_receive(&rxMsg));
+
+  TEST_CHECK(STATUS_eOK == bcp_listen());
+  TEST_CHECK(BCP_JOB_RESULT_ePENDING == test_runBcp());
+  bcp_cancel();
+
+  TEST_CHECK(4 == test_numEvts);
+  TEST_CHECK(BCP_EVT_FRAME_TX == test_evtLog[0]);
+  TEST_CHECK(BCP_EVT_FRAME_RX == test_evtLog[1]);
+  TEST_CHECK(BCP_EVT_FRAME_TX == test_evtLog[2]);
+  TEST_CHECK(BCP_EVT_FRAME_RX == test_evtLog[3]);
+
+  bcp_setEventCallback(NULL);
+}
+
+
+int main(void)
+{
+  bcp_init();
+
+  dlcf_loop_init(&test_loop, test_slot, sizeof(test_slot));
+  dlcf_loop_setDevInfo(&test_devInfo, &test_loop);
+  TEST_CHECK(STATUS_eOK == bcp_setTransport(&test_devInfo));
+
+  test_roundTrip();
+  test_crcError();
+  test_event();
+  test_transport();
+
+  if(0 != test_numFailed)
+  {
+    printf("bcp_test: %u check(s) failed\n", test_numFailed);
+  }
+  else
+  {
+    printf("bcp_test: passed\n");
+  }
+  return (0 != test_numFailed) ? 1 : 0;
+}
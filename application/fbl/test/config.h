@@ -0,0 +1,9 @@
+#ifndef CONFIG_H
+#define CONFIG_H
+
+/* COM_UART is replaced by the loopback transport */
+#define COM_UART 0
+
+#define COM_UART_DMA STD_OFF
+
+#endif /* CONFIG_H */
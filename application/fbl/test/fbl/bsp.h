@@ -0,0 +1,13 @@
+#ifndef BSP_TEST_H
+#define BSP_TEST_H
+
+/*
+ * The host build has no SoC headers, so the register macros used by the
+ * ROM API headers are added to the generic platform here.
+ */
+
+#include "../../../../common/bsp.h"
+
+#include "reg.h"
+
+#endif /* BSP_TEST_H */
@@ -0,0 +1,18 @@
+#ifndef CONFIG_H
+#define CONFIG_H
+
+/* COM_UART is replaced by the BCP model of the test */
+#define COM_UART 0
+
+#define COM_UART_DMA STD_OFF
+
+/* Download features of the target configuration */
+#define FBL_LAZY_ERASE STD_ON
+#define FBL_ERASE_AHEAD_SECTORS 2
+#define FBL_WRITE_AVOID STD_ON
+#define FBL_STAGE_ENA STD_ON
+#define FBL_STAGE_SIZE (64 * 1024)
+#define FBL_RESUME_ENA STD_ON
+#define FBL_MAX_BAUDRATE 6000000u
+
+#endif /* CONFIG_H */
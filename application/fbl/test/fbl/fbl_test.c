@@ -0,0 +1,881 @@
+#ifndef FBL_TEST_C
+#define FBL_TEST_C
+#endif /* FBL_TEST_C */
+
+#include "bsp.h"
+#include "config.h"
+#include "pdu.h"
+#include "ext_flash.h"
+#include "ext_flash_cfg.h"
+#include "dcp.h"
+#include "uart.h"
+#include "rom_api.h"
+#include "swinfo.h"
+#include "bcp.h"
+#include "fbl_defs.h"
+#include "target_cfg.h"
+#include "fbl.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+
+
+/*
+ * Host test of the FBL download sequences
+ *
+ * The FBL is run against models of the BCP and the flash. The flash model
+ * is mapped at the target address, so the FBL reads it over the mapped
+ * window as on the target. Programming clears bits only and an erase sets
+ * the sectors blank, so sectors the FBL fails to erase show up in the
+ * image. The test plays the host sending a request and checks the
+ * response.
+ */
+
+#define TEST_FLASH_SIZE ((FBL_APP_START_ADDR - FBL_FLASH_BASE_ADDR) + FBL_APP_MAX_SIZE)
+#define TEST_PAGE_SIZE  256u
+
+/* Image of four sectors at the start of the application region */
+#define TEST_IMG_ADDR   FBL_APP_START_ADDR
+#define TEST_IMG_SIZE   (4 * FLASH_ERASE_SECTOR_SIZE)
+#define TEST_IMG_BLKS   (TEST_IMG_SIZE / FBL_BLK_SIZE)
+
+/* Steps of fbl_run() to answer a request at most */
+#define TEST_MAX_RUNS   4u
+
+#define TEST_CHECK(cond)                                                  \
+  do                                                                      \
+  {                                                                       \
+    if(!(cond))                                                           \
+    {                                                                     \
+      printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond);     \
+      test_numFailed++;                                                   \
+    }                                                                     \
+  }while(0)
+
+static uint8* test_flash;
+static uint32 test_numFailed;
+
+static uint32 test_img[TEST_IMG_SIZE / sizeof(uint32)];
+
+/* BCP model */
+static uint32 test_reqBuf[(sizeof(T_FBL_MSG_PROGRAM_REQ) + sizeof(uint32) - 1) / sizeof(uint32)];
+static uint32 test_rspBuf[(sizeof(T_FBL_MSG_DIGEST_RSP) + sizeof(uint32) - 1) / sizeof(uint32)];
+static uint32 test_reqLen;
+static uint32 test_rspLen;
+static uint32 test_numRsps;
+static boolean test_listenEna;
+static boolean test_reqPending;
+static T_BCP_JOB_RESULT test_jobResult;
+static T_BCP_JOB_RESULT test_txResult;
+
+
+/*
+ ******************************************************************************
+ * Flash model
+ ******************************************************************************
+ * Description:
+ *   Jobs complete when started, so the job result is always OK.
+ *
+ ******************************************************************************
+ */
+
+T_STATUS extflash_open(void)
+{
+  return STATUS_eOK;
+}
+
+T_STATUS extflash_write(uint32 dstAddr, uint8 srcBuf[], uint32 numBytes)
+{
+  T_STATUS result = STATUS_eNOK;
+  uint32 i;
+
+  if((dstAddr + numBytes) <= TEST_FLASH_SIZE)
+  {
+    for(i = 0; i < numBytes; i++)
+    {
+      test_flash[dstAddr + i] &= srcBuf[i];
+    }
+    result = STATUS_eOK;
+  }
+  return result;
+}
+
+T_STATUS extflash_erase(uint32 logAddr, uint32 numBytes)
+{
+  T_STATUS result = STATUS_eNOK;
+
+  if( (0 == (logAddr & (FLASH_ERASE_SECTOR_SIZE - 1)))
+   && (0 == (numBytes & (FLASH_ERASE_SECTOR_SIZE - 1)))
+   && ((logAddr + numBytes) <= TEST_FLASH_SIZE) )
+  {
+    memset(&test_flash[logAddr], 0xFF, numBytes);
+    result = STATUS_eOK;
+  }
+  return result;
+}
+
+boolean extflash_isBlank(uint32 logAddr, uint32 numBytes)
+{
+  boolean result = !FALSE;
+  uint32 i;
+
+  for(i = 0; (i < numBytes) && (FALSE != result); i++)
+  {
+    result = (0xFF == test_flash[logAddr + i]);
+  }
+  return result;
+}
+
+uint32 extflash_getPageSize(void)
+{
+  return TEST_PAGE_SIZE;
+}
+
+T_STATUS extflash_startWrite(uint32 logAddr, const uint8 srcBuf[])
+{
+  return extflash_write(logAddr, (uint8*)srcBuf, TEST_PAGE_SIZE);
+}
+
+T_STATUS extflash_startErase(uint32 logAddr, uint32 numBytes)
+{
+  return extflash_erase(logAddr, numBytes);
+}
+
+void extflash_run(void)
+{
+}
+
+T_EXTFLASH_STATUS extflash_getStatus(void)
+{
+  return EXTFLASH_STATUS_eIDLE;
+}
+
+T_EXTFLASH_JOB_RESULT extflash_getJobResult(void)
+{
+  return EXTFLASH_JOB_RESULT_eOK;
+}
+
+
+/*
+ ******************************************************************************
+ * DCP model
+ ******************************************************************************
+ * Description:
+ *   The FBL compares digests only, so a 64 bit FNV-1a stretched to the
+ *   digest size stands in for SHA-256. Segments are hashed as a single
+ *   message.
+ *
+ ******************************************************************************
+ */
+
+void dcp_initDev(uint32 devID)
+{
+  (void)devID;
+}
+
+void dcp_configDev(uint32 devID, T_DCP_CFG* devCfg)
+{
+  (void)devID;
+  (void)devCfg;
+}
+
+void dcp_configChannel(uint32 chanID, T_DCP_CHAN_CFG* chCfg)
+{
+  (void)chanID;
+  (void)chCfg;
+}
+
+T_STATUS dcp_hashSeg(uint32 chanID, uint8* digest, uint8* outSize, const T_DCP_MSG_SEG segTbl[], uint32 numSegs)
+{
+  unsigned long long hash = 0xCBF29CE484222325ull;
+  uint32 segIdx;
+  uint32 i;
+
+  (void)chanID;
+
+  for(segIdx = 0; segIdx < numSegs; segIdx++)
+  {
+    for(i = 0; i < segTbl[segIdx].msgLen; i++)
+    {
+      hash = (hash ^ segTbl[segIdx].msgText[i]) * 0x100000001B3ull;
+    }
+  }
+
+  for(i = 0; i < *outSize; i++)
+  {
+    hash = (hash ^ i) * 0x100000001B3ull;
+    digest[i] = (uint8)(hash >> 56);
+  }
+  return STATUS_eOK;
+}
+
+T_STATUS dcp_hash(uint32 chanID, uint8* digest, uint8* outSize, const uint8* msgText, uint32 msgLen)
+{
+  T_DCP_MSG_SEG seg;
+
+  seg.msgText = msgText;
+  seg.msgLen = msgLen;
+  return dcp_hashSeg(chanID, digest, outSize, &seg, 1);
+}
+
+
+/*
+ ******************************************************************************
+ * BCP model
+ ******************************************************************************
+ * Description:
+ *   A request queued by the test is received by the next listen. The
+ *   response sent is kept in test_rspBuf, its job result is taken from
+ *   test_txResult.
+ *
+ ******************************************************************************
+ */
+
+T_STATUS bcp_listen(void)
+{
+  test_listenEna = !FALSE;
+  return STATUS_eOK;
+}
+
+T_BCP_STATUS bcp_getStatus(void)
+{
+  return ( (FALSE != test_listenEna) && (FALSE == test_reqPending) ) ? BCP_STATUS_eBUSY : BCP_STATUS_eIDLE;
+}
+
+T_BCP_JOB_RESULT bcp_getJobResult(void)
+{
+  return test_jobResult;
+}
+
+T_STATUS bcp_getRxMsg(T_PDU* rxMsg)
+{
+  rxMsg->data = (uint8*)test_reqBuf;
+  rxMsg->size = sizeof(test_reqBuf);
+  rxMsg->len = test_reqLen;
+  test_listenEna = FALSE;
+  test_reqPending = FALSE;
+  return STATUS_eOK;
+}
+
+T_STATUS bcp_allocTxPdu(T_PDU* txMsg)
+{
+  txMsg->data = (uint8*)test_rspBuf;
+  txMsg->size = sizeof(test_rspBuf);
+  txMsg->len = 0;
+  return STATUS_eOK;
+}
+
+T_STATUS bcp_sendMsg(T_PDU* txMsg)
+{
+  test_rspLen = txMsg->len;
+  test_numRsps++;
+  test_listenEna = FALSE;
+  test_reqPending = FALSE;
+  test_jobResult = test_txResult;
+  return STATUS_eOK;
+}
+
+void bcp_sendAckRsp(uint32 cmd)
+{
+  T_FBL_MSG_ACK_RSP* rspMsg = (T_FBL_MSG_ACK_RSP*)test_rspBuf;
+  T_PDU rspPdu;
+
+  rspMsg->msgType = FBL_MSG_ID_eACK_RSP;
+  rspMsg->reqType = cmd;
+  rspPdu.len = sizeof(T_FBL_MSG_ACK_RSP);
+  (void)bcp_sendMsg(&rspPdu);
+}
+
+void bcp_sendNakRsp(uint32 cmd, uint32 errorCode)
+{
+  T_FBL_MSG_NAK_RSP* rspMsg = (T_FBL_MSG_NAK_RSP*)test_rspBuf;
+  T_PDU rspPdu;
+
+  rspMsg->msgType = FBL_MSG_ID_eNAK_RSP;
+  rspMsg->reqType = cmd;
+  rspMsg->errCode = errorCode;
+  rspPdu.len = sizeof(T_FBL_MSG_NAK_RSP);
+  (void)bcp_sendMsg(&rspPdu);
+}
+
+
+/*
+ ******************************************************************************
+ * Stubs
+ ******************************************************************************
+ * Description:
+ *   Baud rate, software info and reboot aren't part of the test.
+ *
+ ******************************************************************************
+ */
+
+T_STATUS uart_checkBaudrate(uint32 devID, uint32 baudrate)
+{
+  (void)devID;
+  (void)baudrate;
+  return UART_OK;
+}
+
+T_STATUS uart_setBaudrate(uint32 devID, uint32 baudrate)
+{
+  (void)devID;
+  (void)baudrate;
+  return UART_OK;
+}
+
+uint32 uart_getBaudrate(uint32 devID)
+{
+  (void)devID;
+  return 115200u;
+}
+
+boolean uart_isTxBusy(uint32 devID)
+{
+  (void)devID;
+  return FALSE;
+}
+
+T_ROM_API* romApi_getAddr(void)
+{
+  return NULL;
+}
+
+const T_SWINFO* swinfo_getOwnSwInfo(void)
+{
+  return NULL;
+}
+
+
+/*
+ ******************************************************************************
+ * test_request
+ ******************************************************************************
+ * Description:
+ *   The function passes a request to the FBL and runs it until it listens
+ *   again. A request failing the CRC is passed by a failed job result.
+ *   Returns the number of responses sent.
+ *
+ ******************************************************************************
+ */
+
+static uint32 test_request(const void* reqMsg, uint32 reqLen, T_BCP_JOB_RESULT rxResult)
+{
+  uint32 numRsps = test_numRsps;
+  uint32 numRuns = 0;
+
+  memcpy(test_reqBuf, reqMsg, reqLen);
+  test_reqLen = reqLen;
+  test_jobResult = rxResult;
+  test_reqPending = !FALSE;
+
+  do
+  {
+    fbl_run();
+    numRuns++;
+  }while( (FALSE == test_listenEna) && (numRuns < TEST_MAX_RUNS) );
+
+  TEST_CHECK(FALSE != test_listenEna);
+  TEST_CHECK(FALSE == test_reqPending);
+  return test_numRsps - numRsps;
+}
+
+
+/*
+ ******************************************************************************
+ * test_send
+ ******************************************************************************
+ * Description:
+ *   The function sends a request answered by an ACK or a NAK and returns
+ *   the error code of the NAK, BCP_ERR_ID_eNONE for an ACK.
+ *
+ ******************************************************************************
+ */
+
+static uint32 test_send(const void* reqMsg, uint32 reqLen)
+{
+  T_FBL_MSG_NAK_RSP* rspMsg = (T_FBL_MSG_NAK_RSP*)test_rspBuf;
+  uint32 errCode = BCP_ERR_ID_eNONE;
+
+  TEST_CHECK(1 == test_request(reqMsg, reqLen, BCP_JOB_RESULT_eOK));
+  TEST_CHECK(*(const uint32*)reqMsg == rspMsg->reqType);
+  if(FBL_MSG_ID_eNAK_RSP == rspMsg->msgType)
+  {
+    errCode = rspMsg->errCode;
+  }
+  else
+  {
+    TEST_CHECK(FBL_MSG_ID_eACK_RSP == rspMsg->msgType);
+  }
+  return errCode;
+}
+
+
+/*
+ ******************************************************************************
+ * Request helpers
+ ******************************************************************************
+ * Description:
+ *   The functions send a request of the download sequence for the image
+ *   of the test.
+ *
+ ******************************************************************************
+ */
+
+static uint32 test_sendResume(uint32 sessionID, uint32 imgAddr, uint32 imgSize)
+{
+  T_FBL_MSG_RESUME_REQ reqMsg;
+  T_FBL_MSG_RESUME_RSP* rspMsg = (T_FBL_MSG_RESUME_RSP*)test_rspBuf;
+  uint8  digestSize = sizeof(reqMsg.imgDigest);
+  uint32 errCode = BCP_ERR_ID_eNONE;
+
+  reqMsg.msgType = FBL_MSG_ID_eRESUME_REQ;
+  reqMsg.sessionID = sessionID;
+  reqMsg.imgAddr = imgAddr;
+  reqMsg.imgSize = imgSize;
+  (void)dcp_hash(0, reqMsg.imgDigest, &digestSize, (const uint8*)test_img, sizeof(test_img));
+
+  TEST_CHECK(1 == test_request(&reqMsg, sizeof(reqMsg), BCP_JOB_RESULT_eOK));
+  if(FBL_MSG_ID_eNAK_RSP == rspMsg->msgType)
+  {
+    errCode = ((T_FBL_MSG_NAK_RSP*)test_rspBuf)->errCode;
+  }
+  else
+  {
+    TEST_CHECK(FBL_MSG_ID_eRESUME_RSP == rspMsg->msgType);
+    TEST_CHECK(test_rspLen <= sizeof(T_FBL_MSG_RESUME_RSP));
+  }
+  return errCode;
+}
+
+static uint32 test_sendRange(uint32 msgType, uint32 blkAddr, uint32 blkSize)
+{
+  T_FBL_MSG_ERASE_REQ reqMsg;
+
+  reqMsg.msgType = msgType;
+  reqMsg.blkAddr = blkAddr;
+  reqMsg.blkSize = blkSize;
+  return test_send(&reqMsg, sizeof(reqMsg));
+}
+
+static uint32 test_sendProgram(uint32 blkIdx)
+{
+  static T_FBL_MSG_PROGRAM_REQ reqMsg;
+
+  reqMsg.msgType = FBL_MSG_ID_ePROGRAM_REQ;
+  reqMsg.blkAddr = TEST_IMG_ADDR + (blkIdx * FBL_BLK_SIZE);
+  memcpy(reqMsg.blkData, &((const uint8*)test_img)[blkIdx * FBL_BLK_SIZE], FBL_BLK_SIZE);
+  return test_send(&reqMsg, sizeof(reqMsg));
+}
+
+
+static uint32 test_sendKeep(uint32 blkIdx, uint32 numBlks)
+{
+  T_FBL_MSG_KEEP_REQ reqMsg;
+  uint8 digestSize = sizeof(reqMsg.digest);
+
+  reqMsg.msgType = FBL_MSG_ID_eKEEP_REQ;
+  reqMsg.blkAddr = TEST_IMG_ADDR + (blkIdx * FBL_BLK_SIZE);
+  reqMsg.blkSize = numBlks * FBL_BLK_SIZE;
+  (void)dcp_hash(0, reqMsg.digest, &digestSize, &((const uint8*)test_img)[blkIdx * FBL_BLK_SIZE], reqMsg.blkSize);
+  return test_send(&reqMsg, sizeof(reqMsg));
+}
+
+
+/*
+ ******************************************************************************
+ * test_setup
+ ******************************************************************************
+ * Description:
+ *   The function starts the FBL over flash holding the given content, as
+ *   if the target was reset.
+ *
+ ******************************************************************************
+ */
+
+static void test_setup(const void* content)
+{
+  memset(test_flash, 0xFF, TEST_FLASH_SIZE);
+  if(NULL != content)
+  {
+    memcpy(&test_flash[TEST_IMG_ADDR - FBL_FLASH_BASE_ADDR], content, TEST_IMG_SIZE);
+  }
+
+  fbl_init();
+  fbl_enter();
+}
+
+
+/*
+ ******************************************************************************
+ * test_reset
+ ******************************************************************************
+ * Description:
+ *   The function restarts the FBL keeping the flash content.
+ *
+ ******************************************************************************
+ */
+
+static void test_reset(void)
+{
+  fbl_init();
+  fbl_enter();
+}
+
+
+/*
+ ******************************************************************************
+ * test_isImage
+ ******************************************************************************
+ * Description:
+ *   The function checks, if the flash holds the image of the test.
+ *
+ ******************************************************************************
+ */
+
+static boolean test_isImage(void)
+{
+  return (0 == memcmp(&test_flash[TEST_IMG_ADDR - FBL_FLASH_BASE_ADDR], test_img, TEST_IMG_SIZE));
+}
+
+
+/*
+ ******************************************************************************
+ * test_partialImage
+ ******************************************************************************
+ * Description:
+ *   Flash holding the image already, but only the first sector of it is
+ *   downloaded. The other sectors are still pending to be erased, so the
+ *   activation is refused. It succeeds, once the remaining blocks have
+ *   been downloaded.
+ *
+ ******************************************************************************
+ */
+
+static void test_partialImage(void)
+{
+  uint32 blkIdx;
+
+  test_setup(test_img);
+
+  TEST_CHECK(BCP_ERR_ID_eNONE == test_sendResume(1, TEST_IMG_ADDR, TEST_IMG_SIZE));
+  TEST_CHECK(BCP_ERR_ID_eNONE == test_sendRange(FBL_MSG_ID_eINVALIDATE_REQ, TEST_IMG_ADDR, TEST_IMG_SIZE));
+  TEST_CHECK(BCP_ERR_ID_eNONE == test_sendRange(FBL_MSG_ID_eERASE_REQ, TEST_IMG_ADDR, TEST_IMG_SIZE));
+
+  for(blkIdx = 0; blkIdx < (FLASH_ERASE_SECTOR_SIZE / FBL_BLK_SIZE); blkIdx++)
+  {
+    TEST_CHECK(BCP_ERR_ID_eNONE == test_sendProgram(blkIdx));
+  }
+
+  TEST_CHECK(BCP_ERR_ID_eINCONSISTENT == test_sendRange(FBL_MSG_ID_eACTIVATE_REQ, TEST_IMG_ADDR, TEST_IMG_SIZE));
+  TEST_CHECK(FLASH_BLANK_VALUE == *(const uint32*)FBL_APP_ENTRY_ADDR);
+
+  for(; blkIdx < TEST_IMG_BLKS; blkIdx++)
+  {
+    TEST_CHECK(BCP_ERR_ID_eNONE == test_sendProgram(blkIdx));
+  }
+
+  TEST_CHECK(BCP_ERR_ID_eNONE == test_sendRange(FBL_MSG_ID_eACTIVATE_REQ, TEST_IMG_ADDR, TEST_IMG_SIZE));
+  TEST_CHECK(test_isImage());
+}
+
+
+/*
+ ******************************************************************************
+ * test_resume
+ ******************************************************************************
+ * Description:
+ *   Download interrupted by a reset after half of the image. The resume
+ *   response lists the blocks verified, the host programs the others.
+ *
+ ******************************************************************************
+ */
+
+static void test_resume(void)
+{
+  T_FBL_MSG_RESUME_RSP* rspMsg = (T_FBL_MSG_RESUME_RSP*)test_rspBuf;
+  uint32 blkIdx;
+
+  test_setup(NULL);
+
+  TEST_CHECK(BCP_ERR_ID_eNONE == test_sendResume(2, TEST_IMG_ADDR, TEST_IMG_SIZE));
+  TEST_CHECK(0 == rspMsg->blkMap[0]);
+  TEST_CHECK(BCP_ERR_ID_eNONE == test_sendRange(FBL_MSG_ID_eINVALIDATE_REQ, TEST_IMG_ADDR, TEST_IMG_SIZE));
+  TEST_CHECK(BCP_ERR_ID_eNONE == test_sendRange(FBL_MSG_ID_eERASE_REQ, TEST_IMG_ADDR, TEST_IMG_SIZE));
+
+  for(blkIdx = 0; blkIdx < (TEST_IMG_BLKS / 2); blkIdx++)
+  {
+    TEST_CHECK(BCP_ERR_ID_eNONE == test_sendProgram(blkIdx));
+  }
+
+  test_reset();
+
+  TEST_CHECK(BCP_ERR_ID_eNONE == test_sendResume(2, TEST_IMG_ADDR, TEST_IMG_SIZE));
+  TEST_CHECK(TEST_IMG_BLKS == rspMsg->numBlks);
+  TEST_CHECK(((1u << (TEST_IMG_BLKS / 2)) - 1) == rspMsg->blkMap[0]);
+
+  for(; blkIdx < TEST_IMG_BLKS; blkIdx++)
+  {
+    TEST_CHECK(BCP_ERR_ID_eNONE == test_sendProgram(blkIdx));
+  }
+
+  TEST_CHECK(BCP_ERR_ID_eNONE == test_sendRange(FBL_MSG_ID_eACTIVATE_REQ, TEST_IMG_ADDR, TEST_IMG_SIZE));
+  TEST_CHECK(test_isImage());
+}
+
+
+/*
+ ******************************************************************************
+ * test_resumeRange
+ ******************************************************************************
+ * Description:
+ *   An image wrapping around the address space is refused, so the journal
+ *   and the resume response stay within the application region.
+ *
+ ******************************************************************************
+ */
+
+static void test_resumeRange(void)
+{
+  test_setup(NULL);
+
+  TEST_CHECK(BCP_ERR_ID_eINVALID_DATA == test_sendResume(3, TEST_IMG_ADDR + FBL_BLK_SIZE, 0u - FBL_BLK_SIZE));
+  TEST_CHECK(BCP_ERR_ID_eINVALID_DATA == test_sendResume(3, TEST_IMG_ADDR + FBL_BLK_SIZE, FBL_APP_MAX_SIZE));
+  TEST_CHECK(BCP_ERR_ID_eNONE == test_sendResume(3, TEST_IMG_ADDR + FBL_BLK_SIZE, FBL_APP_MAX_SIZE - FBL_BLK_SIZE));
+}
+
+
+/*
+ ******************************************************************************
+ * test_keep
+ ******************************************************************************
+ * Description:
+ *   Flash holding an image differing in two blocks. The host keeps the
+ *   blocks whose digests match and programs the others along with the
+ *   block holding the entry vector.
+ *
+ ******************************************************************************
+ */
+
+static void test_keep(void)
+{
+  static uint32 prevImg[TEST_IMG_SIZE / sizeof(uint32)];
+  T_FBL_MSG_DIGEST_REQ reqMsg;
+  T_FBL_MSG_DIGEST_RSP* rspMsg = (T_FBL_MSG_DIGEST_RSP*)test_rspBuf;
+  uint8  digest[FBL_DIGEST_SIZE];
+  uint8  digestSize;
+  boolean diffTbl[TEST_IMG_BLKS];
+  uint32 entryBlk = (FBL_APP_ENTRY_ADDR - TEST_IMG_ADDR) / FBL_BLK_SIZE;
+  uint32 runIdx;
+  uint32 blkIdx;
+
+  memcpy(prevImg, test_img, sizeof(prevImg));
+  prevImg[(5 * FBL_BLK_SIZE) / sizeof(uint32)] ^= 0xFFu;
+  prevImg[(9 * FBL_BLK_SIZE) / sizeof(uint32)] ^= 0xFFu;
+  test_setup(prevImg);
+
+  TEST_CHECK(BCP_ERR_ID_eNONE == test_sendResume(4, TEST_IMG_ADDR, TEST_IMG_SIZE));
+  TEST_CHECK(BCP_ERR_ID_eNONE == test_sendRange(FBL_MSG_ID_eINVALIDATE_REQ, TEST_IMG_ADDR, TEST_IMG_SIZE));
+  TEST_CHECK(BCP_ERR_ID_eUNEXPECTED == test_sendKeep(2, 1));
+  TEST_CHECK(BCP_ERR_ID_eNONE == test_sendRange(FBL_MSG_ID_eERASE_REQ, TEST_IMG_ADDR, TEST_IMG_SIZE));
+
+  reqMsg.msgType = FBL_MSG_ID_eDIGEST_REQ;
+  reqMsg.blkAddr = TEST_IMG_ADDR;
+  reqMsg.numBlks = TEST_IMG_BLKS;
+  TEST_CHECK(1 == test_request(&reqMsg, sizeof(reqMsg), BCP_JOB_RESULT_eOK));
+  TEST_CHECK(FBL_MSG_ID_eDIGEST_RSP == rspMsg->msgType);
+  TEST_CHECK(TEST_IMG_BLKS == rspMsg->numBlks);
+
+  for(blkIdx = 0; blkIdx < TEST_IMG_BLKS; blkIdx++)
+  {
+    digestSize = sizeof(digest);
+    (void)dcp_hash(0, digest, &digestSize, &((const uint8*)test_img)[blkIdx * FBL_BLK_SIZE], FBL_BLK_SIZE);
+    diffTbl[blkIdx] = (0 != memcmp(digest, rspMsg->digest[blkIdx], sizeof(digest))) || (entryBlk == blkIdx);
+  }
+  TEST_CHECK(FALSE != diffTbl[5]);
+  TEST_CHECK(FALSE != diffTbl[9]);
+
+  TEST_CHECK(BCP_ERR_ID_eINVALID_DATA == test_sendKeep(entryBlk, 1));
+  TEST_CHECK(BCP_ERR_ID_eINVALID_DATA == test_sendKeep(4, 2));
+
+  /* Keep the runs of matching blocks first */
+  runIdx = 0;
+  for(blkIdx = 0; blkIdx <= TEST_IMG_BLKS; blkIdx++)
+  {
+    if( (blkIdx == TEST_IMG_BLKS) || (FALSE != diffTbl[blkIdx]) )
+    {
+      if(runIdx < blkIdx)
+      {
+        TEST_CHECK(BCP_ERR_ID_eNONE == test_sendKeep(runIdx, blkIdx - runIdx));
+      }
+      runIdx = blkIdx + 1;
+    }
+  }
+
+  for(blkIdx = 0; blkIdx < TEST_IMG_BLKS; blkIdx++)
+  {
+    if(FALSE != diffTbl[blkIdx])
+    {
+      TEST_CHECK(BCP_ERR_ID_eNONE == test_sendProgram(blkIdx));
+    }
+  }
+
+  TEST_CHECK(BCP_ERR_ID_eNONE == test_sendRange(FBL_MSG_ID_eACTIVATE_REQ, TEST_IMG_ADDR, TEST_IMG_SIZE));
+  TEST_CHECK(test_isImage());
+}
+
+
+/*
+ ******************************************************************************
+ * test_fill
+ ******************************************************************************
+ * Description:
+ *   Image with a blank sector downloaded over flash holding another image.
+ *   The blank sector is filled rather than programmed, so its erase is
+ *   left to the activation.
+ *
+ ******************************************************************************
+ */
+
+static void test_fill(void)
+{
+  static uint32 prevImg[TEST_IMG_SIZE / sizeof(uint32)];
+  static uint32 imgCopy[TEST_IMG_SIZE / sizeof(uint32)];
+  T_FBL_MSG_FILL_REQ reqMsg;
+  uint32 fillBlk = (2 * FLASH_ERASE_SECTOR_SIZE) / FBL_BLK_SIZE;
+  uint32 numFillBlks = FLASH_ERASE_SECTOR_SIZE / FBL_BLK_SIZE;
+  uint32 wordIdx;
+  uint32 blkIdx;
+
+  memcpy(imgCopy, test_img, sizeof(imgCopy));
+  memset(&((uint8*)test_img)[fillBlk * FBL_BLK_SIZE], 0xFF, numFillBlks * FBL_BLK_SIZE);
+  for(wordIdx = 0; wordIdx < (sizeof(prevImg) / sizeof(uint32)); wordIdx++)
+  {
+    prevImg[wordIdx] = ~test_img[wordIdx];
+  }
+  test_setup(prevImg);
+
+  reqMsg.msgType = FBL_MSG_ID_eFILL_REQ;
+  reqMsg.blkAddr = TEST_IMG_ADDR + (fillBlk * FBL_BLK_SIZE);
+  reqMsg.blkSize = numFillBlks * FBL_BLK_SIZE;
+  reqMsg.pattern = FLASH_BLANK_VALUE;
+
+  TEST_CHECK(BCP_ERR_ID_eNONE == test_sendResume(5, TEST_IMG_ADDR, TEST_IMG_SIZE));
+  TEST_CHECK(BCP_ERR_ID_eNONE == test_sendRange(FBL_MSG_ID_eINVALIDATE_REQ, TEST_IMG_ADDR, TEST_IMG_SIZE));
+  TEST_CHECK(BCP_ERR_ID_eUNEXPECTED == test_send(&reqMsg, sizeof(reqMsg)));
+  TEST_CHECK(BCP_ERR_ID_eNONE == test_sendRange(FBL_MSG_ID_eERASE_REQ, TEST_IMG_ADDR, TEST_IMG_SIZE));
+
+  for(blkIdx = 0; blkIdx < TEST_IMG_BLKS; blkIdx++)
+  {
+    if( (blkIdx >= fillBlk) && (blkIdx < (fillBlk + numFillBlks)) )
+    {
+      /* Filled */
+    }
+    else
+    {
+      TEST_CHECK(BCP_ERR_ID_eNONE == test_sendProgram(blkIdx));
+    }
+  }
+  TEST_CHECK(BCP_ERR_ID_eNONE == test_send(&reqMsg, sizeof(reqMsg)));
+
+  TEST_CHECK(BCP_ERR_ID_eNONE == test_sendRange(FBL_MSG_ID_eACTIVATE_REQ, TEST_IMG_ADDR, TEST_IMG_SIZE));
+  TEST_CHECK(test_isImage());
+
+  memcpy(test_img, imgCopy, sizeof(imgCopy));
+}
+
+
+/*
+ ******************************************************************************
+ * test_stream
+ ******************************************************************************
+ * Description:
+ *   Window streamed with a frame failing the CRC. The frame is answered by
+ *   a NAK, a lost response is dropped and the window request reports the
+ *   block lost.
+ *
+ ******************************************************************************
+ */
+
+static void test_stream(void)
+{
+  static T_FBL_MSG_STREAM_REQ streamMsg;
+  T_FBL_MSG_WINDOW_REQ reqMsg;
+  T_FBL_MSG_WINDOW_RSP* rspMsg = (T_FBL_MSG_WINDOW_RSP*)test_rspBuf;
+  T_FBL_MSG_NAK_RSP* nakMsg = (T_FBL_MSG_NAK_RSP*)test_rspBuf;
+  uint32 blkIdx;
+
+  test_setup(NULL);
+
+  TEST_CHECK(BCP_ERR_ID_eNONE == test_sendRange(FBL_MSG_ID_eINVALIDATE_REQ, TEST_IMG_ADDR, TEST_IMG_SIZE));
+  TEST_CHECK(BCP_ERR_ID_eNONE == test_sendRange(FBL_MSG_ID_eERASE_REQ, TEST_IMG_ADDR, TEST_IMG_SIZE));
+
+  reqMsg.msgType = FBL_MSG_ID_eWINDOW_REQ;
+  reqMsg.blkAddr = TEST_IMG_ADDR;
+  reqMsg.blkSize = 4 * FBL_BLK_SIZE;
+  TEST_CHECK(1 == test_request(&reqMsg, sizeof(reqMsg), BCP_JOB_RESULT_eOK));
+  TEST_CHECK(FBL_MSG_ID_eWINDOW_RSP == rspMsg->msgType);
+  TEST_CHECK(0xFu == rspMsg->missMap[0]);
+
+  streamMsg.msgType = FBL_MSG_ID_eSTREAM_REQ;
+  for(blkIdx = 0; blkIdx < 4; blkIdx++)
+  {
+    streamMsg.blkAddr = TEST_IMG_ADDR + (blkIdx * FBL_BLK_SIZE);
+    memcpy(streamMsg.blkData, &((const uint8*)test_img)[blkIdx * FBL_BLK_SIZE], FBL_BLK_SIZE);
+    if(2 == blkIdx)
+    {
+      TEST_CHECK(1 == test_request(&streamMsg, sizeof(streamMsg), BCP_JOB_RESULT_eFAILED));
+      TEST_CHECK(FBL_MSG_ID_eNAK_RSP == nakMsg->msgType);
+      TEST_CHECK(FBL_MSG_ID_eINVALID == nakMsg->reqType);
+      TEST_CHECK(BCP_ERR_ID_eINVALID_CRC == nakMsg->errCode);
+    }
+    else
+    {
+      TEST_CHECK(0 == test_request(&streamMsg, sizeof(streamMsg), BCP_JOB_RESULT_eOK));
+    }
+  }
+
+  test_txResult = BCP_JOB_RESULT_eFAILED;
+  TEST_CHECK(1 == test_request(&reqMsg, sizeof(reqMsg), BCP_JOB_RESULT_eOK));
+  test_txResult = BCP_JOB_RESULT_eOK;
+
+  TEST_CHECK(1 == test_request(&reqMsg, sizeof(reqMsg), BCP_JOB_RESULT_eOK));
+  TEST_CHECK(FBL_MSG_ID_eWINDOW_RSP == rspMsg->msgType);
+  TEST_CHECK(0x4u == rspMsg->missMap[0]);
+}
+
+
+int main(void)
+{
+  uint32 wordIdx;
+
+  test_flash = mmap((void*)FBL_FLASH_BASE_ADDR, TEST_FLASH_SIZE, PROT_READ | PROT_WRITE,
+                    MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+  if((void*)FBL_FLASH_BASE_ADDR != test_flash)
+  {
+    printf("fbl_test: flash model not mapped at 0x%08X\n", FBL_FLASH_BASE_ADDR);
+    return 1;
+  }
+
+  for(wordIdx = 0; wordIdx < (sizeof(test_img) / sizeof(uint32)); wordIdx++)
+  {
+    test_img[wordIdx] = (wordIdx * 0x9E3779B9u) ^ 0x5A5A5A5Au;
+  }
+
+  test_partialImage();
+  test_resume();
+  test_resumeRange();
+  test_keep();
+  test_fill();
+  test_stream();
+
+  if(0 != test_numFailed)
+  {
+    printf("fbl_test: %u check(s) failed\n", test_numFailed);
+  }
+  else
+  {
+    printf("fbl_test: passed\n");
+  }
+  return (0 != test_numFailed) ? 1 : 0;
+}
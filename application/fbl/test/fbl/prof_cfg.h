@@ -0,0 +1,7 @@
+#ifndef PROF_CFG_H
+#define PROF_CFG_H
+
+/* No cycle counter on the host */
+#define PROF_ENA STD_OFF
+
+#endif /* PROF_CFG_H */
@@ -0,0 +1,8 @@
+#ifndef TRACE_CFG_H
+#define TRACE_CFG_H
+
+#include "bsp.h"
+
+/* TRACE_MODE is left undefined, so all traces are empty */
+
+#endif /* TRACE_CFG_H */
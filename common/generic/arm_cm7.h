@@ -2,6 +2,8 @@
 #define ARM_CM7_H
 
 #include "armv7m_scb.h"
+#include "armv7m_dwt.h"
+#include "armv7m_mpu.h"
 
 
 #define CM7_VTOR        (ARMV7_M_SCB_BASE + SCB_VTOR_OFFS) /* Vector Table Offset Register address */
@@ -45,6 +47,13 @@
     : /* inputs */          \
   )
 
+#define CPU_WFI()           \
+  __asm__ __volatile__ (    \
+    " WFI "    "\r\n"       \
+    : /* outputs */         \
+    : /* inputs */          \
+  )
+
 #else /* defined(__ASSEMBLER__) */
 
 #define CPU_DMB(opt)        \
@@ -62,6 +71,9 @@
 #define CPU_SEV()           \
   SEV
 
+#define CPU_WFI()           \
+  WFI
+
 #endif /* defined(__ASSEMBLER__) */
 
 #include "armv7m_nvic.h"
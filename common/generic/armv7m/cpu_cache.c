@@ -0,0 +1,227 @@
+#ifndef CPU_CACHE_C
+#define CPU_CACHE_C
+#endif /* CPU_CACHE_C */
+
+#include "bsp.h"
+#include "reg.h"
+#include "cpu_cache.h"
+
+
+/*
+ ******************************************************************************
+ * Function: cpu_opDCacheSetWay
+ ******************************************************************************
+ * @brief Apply a set/way maintenance operation to the whole L1 D-cache
+ *
+ * @param [in] opOffs - SCB offset of the set/way operation
+ *
+ ******************************************************************************
+ */
+
+static void cpu_opDCacheSetWay(uint32 opOffs)
+{
+  uint32 ccsidr;
+  uint32 numSets;
+  uint32 numWays;
+  uint32 lineShift;
+  uint32 wayShift;
+  uint32 set;
+  uint32 way;
+
+  /* Select L1 data cache */
+  REG32_WR_BASE_OFFS(0, ARMV7_M_SCB_BASE, SCB_CSELR_OFFS);
+  CPU_DSB(0);
+
+  REG32_RD_BASE_OFFS(ccsidr, ARMV7_M_SCB_BASE, SCB_CCSIDR_OFFS);
+  numSets = BF_GET(ccsidr, SCB_CCSIDR_NUM_SETS_BF) + 1;
+  numWays = BF_GET(ccsidr, SCB_CCSIDR_ASSOCIATIVITY_BF) + 1;
+  lineShift = BF_GET(ccsidr, SCB_CCSIDR_LINE_SIZE_BF) + 4;
+  wayShift = __builtin_clz(numWays - 1);
+
+  for(set = 0; set < numSets; set++)
+  {
+    for(way = 0; way < numWays; way++)
+    {
+      REG32_WR_BASE_OFFS((way << wayShift) | (set << lineShift), ARMV7_M_SCB_BASE, opOffs);
+    }
+  }
+  CPU_DSB(0);
+}
+
+
+/*
+ ******************************************************************************
+ * Function: cpu_opDCacheRange
+ ******************************************************************************
+ * @brief Apply an address based maintenance operation to a memory range
+ *
+ * @param [in] opOffs - SCB offset of the address based operation
+ * @param [in] addr - Start address of the range
+ * @param [in] len - Length of the range in bytes
+ *
+ ******************************************************************************
+ */
+
+static void cpu_opDCacheRange(uint32 opOffs, uint32 addr, uint32 len)
+{
+  uint32 lineAddr = addr & ~(CPU_CACHE_LINE_SIZE - 1);
+  uint32 endAddr = addr + len;
+
+  CPU_DSB(0);
+  while(lineAddr < endAddr)
+  {
+    REG32_WR_BASE_OFFS(lineAddr, ARMV7_M_SCB_BASE, opOffs);
+    lineAddr += CPU_CACHE_LINE_SIZE;
+  }
+  CPU_DSB(0);
+  CPU_ISB(0);
+}
+
+
+/*
+ ******************************************************************************
+ * Function: cpu_enableICache
+ ******************************************************************************
+ * @brief Invalidate and enable the instruction cache
+ *
+ ******************************************************************************
+ */
+
+void cpu_enableICache(void)
+{
+  cpu_invalidateICache();
+  REG32_WRBF_BASE_OFFS(1, ARMV7_M_SCB_BASE, SCB_CCR_OFFS, SCB_CCR_IC_BF);
+  CPU_DSB(0);
+  CPU_ISB(0);
+}
+
+
+/*
+ ******************************************************************************
+ * Function: cpu_disableICache
+ ******************************************************************************
+ * @brief Disable and invalidate the instruction cache
+ *
+ ******************************************************************************
+ */
+
+void cpu_disableICache(void)
+{
+  CPU_DSB(0);
+  CPU_ISB(0);
+  REG32_WRBF_BASE_OFFS(0, ARMV7_M_SCB_BASE, SCB_CCR_OFFS, SCB_CCR_IC_BF);
+  cpu_invalidateICache();
+}
+
+
+/*
+ ******************************************************************************
+ * Function: cpu_invalidateICache
+ ******************************************************************************
+ * @brief Invalidate the whole instruction cache
+ *
+ ******************************************************************************
+ */
+
+void cpu_invalidateICache(void)
+{
+  CPU_DSB(0);
+  CPU_ISB(0);
+  REG32_WR_BASE_OFFS(0, ARMV7_M_SCB_BASE, SCB_ICIALLU_OFFS);
+  CPU_DSB(0);
+  CPU_ISB(0);
+}
+
+
+/*
+ ******************************************************************************
+ * Function: cpu_enableDCache
+ ******************************************************************************
+ * @brief Invalidate and enable the data cache
+ *
+ * @par Description:
+ *   The cache contents are undefined after reset, so all lines are
+ *   invalidated before the cache is enabled.
+ *
+ ******************************************************************************
+ */
+
+void cpu_enableDCache(void)
+{
+  cpu_opDCacheSetWay(SCB_DCISW_OFFS);
+  REG32_WRBF_BASE_OFFS(1, ARMV7_M_SCB_BASE, SCB_CCR_OFFS, SCB_CCR_DC_BF);
+  CPU_DSB(0);
+  CPU_ISB(0);
+}
+
+
+/*
+ ******************************************************************************
+ * Function: cpu_disableDCache
+ ******************************************************************************
+ * @brief Disable the data cache and write back its contents
+ *
+ ******************************************************************************
+ */
+
+void cpu_disableDCache(void)
+{
+  CPU_DSB(0);
+  REG32_WRBF_BASE_OFFS(0, ARMV7_M_SCB_BASE, SCB_CCR_OFFS, SCB_CCR_DC_BF);
+  CPU_DSB(0);
+  cpu_opDCacheSetWay(SCB_DCCISW_OFFS);
+  CPU_ISB(0);
+}
+
+
+/*
+ ******************************************************************************
+ * Function: cpu_cleanDCacheRange
+ ******************************************************************************
+ * @brief Write back cached data of a memory range
+ *
+ * @par Description:
+ *   Used before a bus master other than the core reads the range.
+ *
+ ******************************************************************************
+ */
+
+void cpu_cleanDCacheRange(uint32 addr, uint32 len)
+{
+  cpu_opDCacheRange(SCB_DCCMVAC_OFFS, addr, len);
+}
+
+
+/*
+ ******************************************************************************
+ * Function: cpu_invalidateDCacheRange
+ ******************************************************************************
+ * @brief Discard cached data of a memory range
+ *
+ * @par Description:
+ *   Used after the range was written by a bus master other than the core
+ *   or by programming flash. Partial lines at the range borders are
+ *   invalidated as a whole, so they must not hold dirty data.
+ *
+ ******************************************************************************
+ */
+
+void cpu_invalidateDCacheRange(uint32 addr, uint32 len)
+{
+  cpu_opDCacheRange(SCB_DCIMVAC_OFFS, addr, len);
+}
+
+
+/*
+ ******************************************************************************
+ * Function: cpu_cleanInvalidateDCacheRange
+ ******************************************************************************
+ * @brief Write back and discard cached data of a memory range
+ *
+ ******************************************************************************
+ */
+
+void cpu_cleanInvalidateDCacheRange(uint32 addr, uint32 len)
+{
+  cpu_opDCacheRange(SCB_DCCIMVAC_OFFS, addr, len);
+}
@@ -0,0 +1,18 @@
+#ifndef CPU_CACHE_H
+#define CPU_CACHE_H
+
+/* Cortex-M7 L1 cache line size in bytes */
+#define CPU_CACHE_LINE_SIZE 32u
+
+extern void cpu_enableICache(void);
+extern void cpu_disableICache(void);
+extern void cpu_invalidateICache(void);
+
+extern void cpu_enableDCache(void);
+extern void cpu_disableDCache(void);
+
+extern void cpu_cleanDCacheRange(uint32 addr, uint32 len);
+extern void cpu_invalidateDCacheRange(uint32 addr, uint32 len);
+extern void cpu_cleanInvalidateDCacheRange(uint32 addr, uint32 len);
+
+#endif /* CPU_CACHE_H */
@@ -0,0 +1,62 @@
+#ifndef CPU_CYC_C
+#define CPU_CYC_C
+#endif /* CPU_CYC_C */
+
+#include "bsp.h"
+#include "reg.h"
+#include "cpu_cyc.h"
+
+
+/*!
+ ******************************************************************************
+ * Function: cpu_enableCycleCounter
+ ******************************************************************************
+ * @par Description:
+ *   This function enables the DWT's cycle counter, which counts processor
+ *   clock cycles and wraps around on overflow. A counter already running
+ *   is left untouched, so several users may enable it.
+ *
+ ******************************************************************************
+ */
+
+void cpu_enableCycleCounter(void)
+{
+  uint32 ctrl;
+
+  /* Enable DWT */
+  REG32_WRBF_BASE_OFFS(1, ARMV7_M_DCB_BASE, DCB_DEMCR_OFFS, DCB_DEMCR_TRCENA_BF);
+
+  /* Unlock DWT registers */
+  REG32_WR_BASE_OFFS(DWT_LAR_KEY, ARMV7_M_DWT_BASE, DWT_LAR_OFFS);
+
+  REG32_RD_BASE_OFFS(ctrl, ARMV7_M_DWT_BASE, DWT_CTRL_OFFS);
+  if(0 != BF_GET(ctrl, DWT_CTRL_CYCCNTENA_BF))
+  {
+    /* Cycle counter already running */
+  }
+  else
+  {
+    /* Start cycle counter */
+    REG32_WR_BASE_OFFS(0, ARMV7_M_DWT_BASE, DWT_CYCCNT_OFFS);
+    REG32_WRBF_BASE_OFFS(1, ARMV7_M_DWT_BASE, DWT_CTRL_OFFS, DWT_CTRL_CYCCNTENA_BF);
+  }
+}
+
+
+/*!
+ ******************************************************************************
+ * Function: cpu_getCycleCount
+ ******************************************************************************
+ * @par Description:
+ *   This function returns the current value of the cycle counter.
+ *
+ ******************************************************************************
+ */
+
+uint32 cpu_getCycleCount(void)
+{
+  uint32 count;
+
+  REG32_RD_BASE_OFFS(count, ARMV7_M_DWT_BASE, DWT_CYCCNT_OFFS);
+  return count;
+}
@@ -0,0 +1,7 @@
+#ifndef CPU_CYC_H
+#define CPU_CYC_H
+
+extern void cpu_enableCycleCounter(void);
+extern uint32 cpu_getCycleCount(void);
+
+#endif /* CPU_CYC_H */
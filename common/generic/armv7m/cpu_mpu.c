@@ -0,0 +1,73 @@
+#ifndef CPU_MPU_C
+#define CPU_MPU_C
+#endif /* CPU_MPU_C */
+
+#include "bsp.h"
+#include "reg.h"
+#include "cpu_mpu.h"
+
+
+/*
+ ******************************************************************************
+ * Function: cpu_initMpu
+ ******************************************************************************
+ * @brief Program and enable the MPU
+ *
+ * @param [in] regionTbl - Regions, in ascending priority
+ * @param [in] numRegions - Number of regions in the table
+ *
+ * @par Description:
+ *   Regions beyond the table are disabled. The default memory map stays
+ *   active as background region for privileged accesses.
+ *
+ ******************************************************************************
+ */
+
+void cpu_initMpu(const T_CPU_MPU_REGION* regionTbl, uint32 numRegions)
+{
+  uint32 typeReg;
+  uint32 maxRegions;
+  uint32 i;
+
+  REG32_RD_BASE_OFFS(typeReg, ARMV7_M_MPU_BASE, MPU_TYPE_OFFS);
+  maxRegions = BF_GET(typeReg, MPU_TYPE_DREGION_BF);
+
+  cpu_disableMpu();
+
+  for(i = 0; i < maxRegions; i++)
+  {
+    REG32_WR_BASE_OFFS(i, ARMV7_M_MPU_BASE, MPU_RNR_OFFS);
+    if(i < numRegions)
+    {
+      REG32_WR_BASE_OFFS(regionTbl[i].baseAddr & ~BF_MASK(MPU_RBAR_VALID_BF) & ~BF_MASK(MPU_RBAR_REGION_BF), ARMV7_M_MPU_BASE, MPU_RBAR_OFFS);
+      REG32_WR_BASE_OFFS(regionTbl[i].rasr, ARMV7_M_MPU_BASE, MPU_RASR_OFFS);
+    }
+    else
+    {
+      /* Region not used */
+      REG32_WR_BASE_OFFS(0, ARMV7_M_MPU_BASE, MPU_RASR_OFFS);
+    }
+  }
+
+  REG32_WR_BASE_OFFS(BF_MASK(MPU_CTRL_PRIVDEFENA_BF) | BF_MASK(MPU_CTRL_ENABLE_BF), ARMV7_M_MPU_BASE, MPU_CTRL_OFFS);
+  CPU_DSB(0);
+  CPU_ISB(0);
+}
+
+
+/*
+ ******************************************************************************
+ * Function: cpu_disableMpu
+ ******************************************************************************
+ * @brief Disable the MPU, so the default memory map applies
+ *
+ ******************************************************************************
+ */
+
+void cpu_disableMpu(void)
+{
+  CPU_DMB(0);
+  REG32_WR_BASE_OFFS(0, ARMV7_M_MPU_BASE, MPU_CTRL_OFFS);
+  CPU_DSB(0);
+  CPU_ISB(0);
+}
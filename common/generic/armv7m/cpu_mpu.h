@@ -0,0 +1,14 @@
+#ifndef CPU_MPU_H
+#define CPU_MPU_H
+
+/*! MPU region as programmed into RBAR and RASR */
+typedef struct
+{
+  uint32 baseAddr;  /*!< Base address, aligned to the region size */
+  uint32 rasr;      /*!< Attributes and size, see MPU_RASR() */
+}T_CPU_MPU_REGION;
+
+extern void cpu_initMpu(const T_CPU_MPU_REGION* regionTbl, uint32 numRegions);
+extern void cpu_disableMpu(void);
+
+#endif /* CPU_MPU_H */
@@ -0,0 +1,18 @@
+#ifndef CPU_TCM_H
+#define CPU_TCM_H
+
+/*
+ * Placement of hot paths into the tightly coupled memories.
+ *
+ * Code tagged by __itcm_text is linked to ITCM and copied there from flash
+ * at startup. Data tagged by __dtcm_data is copied to DTCM, data tagged by
+ * __dtcm_bss is zeroed in DTCM. TCM is neither cached nor shared with the
+ * AXI bus, so accesses are single cycle and don't need cache maintenance.
+ * Calls between ITCM and OCRAM exceed the BL range and are linked via
+ * long branch veneers.
+ */
+#define __itcm_text __attribute__((section(".itcmText")))
+#define __dtcm_data __attribute__((section(".dtcmData")))
+#define __dtcm_bss  __attribute__((section(".dtcmBss")))
+
+#endif /* CPU_TCM_H */
@@ -9,6 +9,8 @@
 #include "trace_pub.h"
 #include "ccm.h"
 #include "dcp.h"
+#include "prof.h"
+#include "cpu_cache.h"
 
 
 const uint32 dcp_chBaseTbl[4] =
@@ -364,20 +366,24 @@ void dcp_configChannel(uint32 chanID, T_DCP_CHAN_CFG* chCfg)
  ******************************************************************************
  *
  ******************************************************************************
- * @brief Hashes arbitrary length data.
+ * @brief Hashes data scattered over several memory segments.
+ *
+ * Each segment is hashed by a work packet of its own, the running hash is
+ * kept in the channel's context between the packets. All segments but the
+ * last one need to be a multiple of the algorithm's block size (64 bytes).
  *
  * @param chanID - channel ID
  * @param digest - pointer to output digest
  * @param outSize - Size of output data in bytes.
- * @param msgText - pointer to input message
- * @param msgLen - Size of input message in bytes.
+ * @param segTbl - segments of the input message, in order
+ * @param numSegs - Number of segments
  *
  * @return Status of hash operation
  *
  ******************************************************************************
  */
 
-T_STATUS dcp_hash(uint32 chanID, uint8* digest, uint8* outSize, const uint8* msgText, uint16 msgLen)
+T_STATUS dcp_hashSeg(uint32 chanID, uint8* digest, uint8* outSize, const T_DCP_MSG_SEG segTbl[], uint32 numSegs)
 {
   T_STATUS result = STATUS_eINVALID_ARG;
 
@@ -385,34 +391,49 @@ T_STATUS dcp_hash(uint32 chanID, uint8* digest, uint8* outSize, const uint8* msg
   T_DCP_JOB_DATA dcpJobData = {0};
   T_DCP_JOB_DATA* dcpJob = &dcpJobData;
   uint8 algDigLen = dcp_digestLenTbl[chData->algoSelect];
+  uint32 segIdx;
 
-  dcpJob->srcMemAddr = (uint32)(void*)msgText;
-  dcpJob->dstMemAddr = (uint32)NULL;
-  dcpJob->bufSize = msgLen;
-  dcpJob->payloadPtr = (uint32)(void*)chData->hashPayload.digest;
-
-  dcpJob->ctrl0 = ( 0
-                  | BF_SET(0xC3, DCP_CTRL0_TAG_BF)
-                  | BF_MASK(DCP_CTRL0_ENA_HASH_BF)
-                  | BF_MASK(DCP_CTRL0_HASH_INIT_BF)
-                  | BF_MASK(DCP_CTRL0_HASH_TERM_BF)
-                  | BF_MASK(DCP_CTRL0_DEC_SEMA_BF)
-                  | BF_SET(chData->swapCfg, DCP_CTRL0_SWAP_CONFIG_BF)
-                  );
-
-  dcpJob->ctrl1 = ( 0
-                  | BF_SET(chData->algoSelect, DCP_CTRL1_HASH_SEL_BF)
-                  );
+  PROF_START(PROF_ID_eDCP_HASH);
 
-  result = dcp_scheduleJob(chanID, dcpJob);
-
-  if(STATUS_eOK != result)
+  for(segIdx = 0; segIdx < numSegs; segIdx++)
   {
-    /* Previous error */
-  }
-  else
-  {
-    result = dcp_waitForChannelComplete(chanID);
+    dcpJob->srcMemAddr = (uint32)(void*)segTbl[segIdx].msgText;
+    dcpJob->dstMemAddr = (uint32)NULL;
+    dcpJob->bufSize = segTbl[segIdx].msgLen;
+    dcpJob->payloadPtr = (uint32)(void*)chData->hashPayload.digest;
+
+    dcpJob->ctrl0 = ( 0
+                    | BF_SET(0xC3, DCP_CTRL0_TAG_BF)
+                    | BF_MASK(DCP_CTRL0_ENA_HASH_BF)
+                    | BF_SET((0 == segIdx), DCP_CTRL0_HASH_INIT_BF)
+                    | BF_SET(((segIdx + 1) == numSegs), DCP_CTRL0_HASH_TERM_BF)
+                    | BF_MASK(DCP_CTRL0_DEC_SEMA_BF)
+                    | BF_SET(chData->swapCfg, DCP_CTRL0_SWAP_CONFIG_BF)
+                    );
+
+    dcpJob->ctrl1 = ( 0
+                    | BF_SET(chData->algoSelect, DCP_CTRL1_HASH_SEL_BF)
+                    );
+
+    /* DCP reads the message and the work packet from memory */
+    cpu_cleanDCacheRange((uint32)(void*)segTbl[segIdx].msgText, segTbl[segIdx].msgLen);
+    cpu_cleanDCacheRange((uint32)(void*)dcpJob, sizeof(T_DCP_JOB_DATA));
+
+    result = dcp_scheduleJob(chanID, dcpJob);
+
+    if(STATUS_eOK != result)
+    {
+      /* Previous error */
+      break;
+    }
+    else
+    {
+      result = dcp_waitForChannelComplete(chanID);
+      if(STATUS_eOK != result)
+      {
+        break;
+      }
+    }
   }
 
   if(STATUS_eOK != result)
@@ -422,6 +443,10 @@ T_STATUS dcp_hash(uint32 chanID, uint8* digest, uint8* outSize, const uint8* msg
   else
   {
     uint16 bytesToCopy = algDigLen;
+
+    /* DCP wrote the digest to memory */
+    cpu_invalidateDCacheRange((uint32)(void*)chData->hashPayload.digest, sizeof(chData->hashPayload.digest));
+
     if(outSize == NULL)
     {
       /* No output size given */
@@ -441,6 +466,32 @@ T_STATUS dcp_hash(uint32 chanID, uint8* digest, uint8* outSize, const uint8* msg
       digest[i] = chData->hashPayload.digest[algDigLen - i - 1];
     }
   }
+
+  PROF_STOP(PROF_ID_eDCP_HASH);
   return result;
 }
 
+
+/*!
+ ******************************************************************************
+ *
+ ******************************************************************************
+ * @brief Hashes arbitrary length data.
+ *
+ * @param chanID - channel ID
+ * @param digest - pointer to output digest
+ * @param outSize - Size of output data in bytes.
+ * @param msgText - pointer to input message
+ * @param msgLen - Size of input message in bytes.
+ *
+ * @return Status of hash operation
+ *
+ ******************************************************************************
+ */
+
+T_STATUS dcp_hash(uint32 chanID, uint8* digest, uint8* outSize, const uint8* msgText, uint32 msgLen)
+{
+  T_DCP_MSG_SEG msgSeg = { msgText, msgLen };
+
+  return dcp_hashSeg(chanID, digest, outSize, &msgSeg, 1);
+}
@@ -84,12 +84,20 @@ typedef union
 }T_DCP_DIGEST;
 
 
+typedef struct
+{
+  const uint8* msgText; /* Segment of the input message */
+  uint32 msgLen;        /* Size of the segment in bytes */
+}T_DCP_MSG_SEG;
+
+
 extern void dcp_deinitDev(uint32 devID);
 extern void dcp_initDev(uint32 devID);
 extern void dcp_configDev(uint32 devID, T_DCP_CFG* devCfg);
 extern void dcp_configChannel(uint32 chanID, T_DCP_CHAN_CFG* chCfg);
 
-extern T_STATUS dcp_hash(uint32 chanID, uint8* digest, uint8* outSize, const uint8* msgText, uint16 msgLen);
+extern T_STATUS dcp_hash(uint32 chanID, uint8* digest, uint8* outSize, const uint8* msgText, uint32 msgLen);
+extern T_STATUS dcp_hashSeg(uint32 chanID, uint8* digest, uint8* outSize, const T_DCP_MSG_SEG segTbl[], uint32 numSegs);
 
 #endif /* DCP_H */
 
@@ -0,0 +1,199 @@
+#ifndef EDMA_C
+#define EDMA_C
+#endif /* EDMA_C */
+
+
+#include "bsp.h"
+#include "reg.h"
+#include "ccm.h"
+#include "edma.h"
+
+
+const T_CCM_CLK_CFG edma_clkCfg[] =
+{
+  CLK_CNF_DEF(CCM_CCGR5_OFFS, EDMA_CLK_ENA_BF, CCM_CG_eCLK_ON_ALW), /* CG on */
+  CLK_CNF_END(),
+};
+
+
+/*
+ ******************************************************************************
+ * Function: edma_initDev
+ ******************************************************************************
+ * @par Description:
+ *   This function enables the eDMA controller's clock and disables all
+ *   channel requests.
+ *
+ * @return none
+ *
+ ******************************************************************************
+ */
+
+void edma_initDev(void)
+{
+  ccm_setupMultipleClkProps(edma_clkCfg);
+
+  /* Disable all hardware requests */
+  REG32_WR_BASE_OFFS(0, EDMA_BASE, EDMA_ERQ_OFFS);
+  REG32_WR_BASE_OFFS(0, EDMA_BASE, EDMA_EEI_OFFS);
+
+  /* Round robin channel arbitration, stop on debug halt */
+  REG32_WR_BASE_OFFS(( 0
+                     | BF_SET(1, EDMA_CR_ERCA_BF)
+                     | BF_SET(1, EDMA_CR_EDBG_BF)
+                     ), EDMA_BASE, EDMA_CR_OFFS);
+}
+
+
+/*
+ ******************************************************************************
+ * Function: edma_setupChannel
+ ******************************************************************************
+ * @par Description:
+ *   This function routes the given request source to the channel and
+ *   loads the channel's transfer control descriptor. The channel is left
+ *   stopped, it must be started by edma_startChannel().
+ *
+ * @param chanID - eDMA channel number
+ * @param xferCfg - Transfer configuration
+ *
+ * @return status
+ *
+ ******************************************************************************
+ */
+
+T_STATUS edma_setupChannel(uint32 chanID, const T_EDMA_XFER_CFG* xferCfg)
+{
+  T_STATUS result = STATUS_eNOK;
+  uint32 tcdBase;
+  uint16 csr = 0;
+
+  if(chanID >= EDMA_NUM_CHANNELS)
+  {
+    /* Invalid channel */
+    result = STATUS_eINVALID_ARG;
+  }
+  else if(NULL == xferCfg)
+  {
+    /* Invalid configuration */
+    result = STATUS_eINVALID_ARG;
+  }
+  else if( (0 == xferCfg->numIter) || (xferCfg->numIter > BF_MASK(EDMA_TCD_CITER_CITER_BF)) )
+  {
+    /* Loop count not supported */
+    result = STATUS_eINVALID_ARG;
+  }
+  else
+  {
+    tcdBase = EDMA_BASE + EDMA_TCD_OFFS(chanID);
+
+    /* Stop channel and clear its status */
+    REG8_WR_BASE_OFFS(chanID, EDMA_BASE, EDMA_CERQ_OFFS);
+    REG8_WR_BASE_OFFS(chanID, EDMA_BASE, EDMA_CDNE_OFFS);
+    REG8_WR_BASE_OFFS(chanID, EDMA_BASE, EDMA_CINT_OFFS);
+
+    /* Route request source */
+    REG32_WR_BASE_OFFS(0, DMAMUX_BASE, DMAMUX_CHCFG_OFFS(chanID));
+    REG32_WR_BASE_OFFS(( 0
+                       | BF_SET(1, DMAMUX_CHCFG_ENBL_BF)
+                       | BF_SET(xferCfg->muxSrc, DMAMUX_CHCFG_SOURCE_BF)
+                       ), DMAMUX_BASE, DMAMUX_CHCFG_OFFS(chanID));
+
+    if(0 != (xferCfg->flags & EDMA_CHAN_FLAG_ONESHOT))
+    {
+      /* Disable request at end of major loop */
+      csr |= BF_SET(1, EDMA_TCD_CSR_DREQ_BF);
+    }
+
+    /* Load transfer control descriptor */
+    REG32_WR_BASE_OFFS(xferCfg->srcAddr, tcdBase, EDMA_TCD_SADDR_OFFS);
+    REG16_WR_BASE_OFFS(xferCfg->srcOffs, tcdBase, EDMA_TCD_SOFF_OFFS);
+    REG16_WR_BASE_OFFS(( 0
+                       | BF_SET(xferCfg->xferSize, EDMA_TCD_ATTR_SSIZE_BF)
+                       | BF_SET(xferCfg->xferSize, EDMA_TCD_ATTR_DSIZE_BF)
+                       ), tcdBase, EDMA_TCD_ATTR_OFFS);
+    REG32_WR_BASE_OFFS(xferCfg->numBytes, tcdBase, EDMA_TCD_NBYTES_OFFS);
+    REG32_WR_BASE_OFFS(xferCfg->srcLast, tcdBase, EDMA_TCD_SLAST_OFFS);
+    REG32_WR_BASE_OFFS(xferCfg->dstAddr, tcdBase, EDMA_TCD_DADDR_OFFS);
+    REG16_WR_BASE_OFFS(xferCfg->dstOffs, tcdBase, EDMA_TCD_DOFF_OFFS);
+    REG16_WR_BASE_OFFS(xferCfg->numIter, tcdBase, EDMA_TCD_CITER_OFFS);
+    REG32_WR_BASE_OFFS(xferCfg->dstLast, tcdBase, EDMA_TCD_DLAST_SGA_OFFS);
+    REG16_WR_BASE_OFFS(xferCfg->numIter, tcdBase, EDMA_TCD_BITER_OFFS);
+    REG16_WR_BASE_OFFS(csr, tcdBase, EDMA_TCD_CSR_OFFS);
+
+    result = STATUS_eOK;
+  }
+  return result;
+}
+
+
+/*
+ ******************************************************************************
+ * Function: edma_startChannel
+ ******************************************************************************
+ * @par Description:
+ *   This function enables hardware requests for the given channel.
+ *
+ ******************************************************************************
+ */
+
+void edma_startChannel(uint32 chanID)
+{
+  REG8_WR_BASE_OFFS(chanID, EDMA_BASE, EDMA_CDNE_OFFS);
+  REG8_WR_BASE_OFFS(chanID, EDMA_BASE, EDMA_SERQ_OFFS);
+}
+
+
+/*
+ ******************************************************************************
+ * Function: edma_stopChannel
+ ******************************************************************************
+ * @par Description:
+ *   This function disables hardware requests for the given channel.
+ *
+ ******************************************************************************
+ */
+
+void edma_stopChannel(uint32 chanID)
+{
+  REG8_WR_BASE_OFFS(chanID, EDMA_BASE, EDMA_CERQ_OFFS);
+}
+
+
+/*
+ ******************************************************************************
+ * Function: edma_getRemaining
+ ******************************************************************************
+ * @par Description:
+ *   This function returns the number of minor loops remaining in the
+ *   current major loop of the given channel.
+ *
+ ******************************************************************************
+ */
+
+uint16 edma_getRemaining(uint32 chanID)
+{
+  uint16 citer;
+
+  REG16_RD_BASE_OFFS(citer, EDMA_BASE + EDMA_TCD_OFFS(chanID), EDMA_TCD_CITER_OFFS);
+  return BF_GET(citer, EDMA_TCD_CITER_CITER_BF);
+}
+
+
+/*
+ ******************************************************************************
+ * Function: edma_isDone
+ ******************************************************************************
+ * @par Description:
+ *   This function checks whether the given channel completed its major loop.
+ *
+ ******************************************************************************
+ */
+
+boolean edma_isDone(uint32 chanID)
+{
+  uint16 csr;
+
+  REG16_RD_BASE_OFFS(csr, EDMA_BASE + EDMA_TCD_OFFS(chanID), EDMA_TCD_CSR_OFFS);
+  return (0 != BF_GET(csr, EDMA_TCD_CSR_DONE_BF));
+}
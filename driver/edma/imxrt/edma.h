@@ -0,0 +1,32 @@
+#ifndef EDMA_H
+#define EDMA_H
+
+
+/*! Structure for eDMA channel transfer configuration */
+typedef struct
+{
+  uint32 srcAddr;   /*!< Source address */
+  uint32 dstAddr;   /*!< Destination address */
+  sint32 srcLast;   /*!< Source address adjustment after major loop */
+  sint32 dstLast;   /*!< Destination address adjustment after major loop */
+  sint16 srcOffs;   /*!< Source address offset per minor loop */
+  sint16 dstOffs;   /*!< Destination address offset per minor loop */
+  uint16 numIter;   /*!< Number of minor loops per major loop */
+  uint8  xferSize;  /*!< Transfer size per access EDMA_TCD_ATTR_SIZE_xxx */
+  uint8  numBytes;  /*!< Number of bytes per minor loop */
+  uint8  muxSrc;    /*!< DMAMUX request source */
+  uint8  flags;     /*!< Channel flags EDMA_CHAN_FLAG_xxx */
+}T_EDMA_XFER_CFG;
+
+/* Disable hardware requests after major loop, otherwise loop circularly */
+#define EDMA_CHAN_FLAG_ONESHOT  0x01
+
+
+extern void edma_initDev(void);
+extern T_STATUS edma_setupChannel(uint32 chanID, const T_EDMA_XFER_CFG* xferCfg);
+extern void edma_startChannel(uint32 chanID);
+extern void edma_stopChannel(uint32 chanID);
+extern uint16 edma_getRemaining(uint32 chanID);
+extern boolean edma_isDone(uint32 chanID);
+
+#endif /* EDMA_H */
@@ -7,79 +7,1080 @@
 
 #include "libc.h"
 #include "rom_api.h"
+#include "cpu_cache.h"
+#include "prof.h"
+#include "cpu_tcm.h"
 
+#include "flexspi_ip.h"
+#include "sfdp.h"
 #include "ext_flash.h"
 
 
-T_STATUS extflash_write(uint32 dstAddr, uint8 srcBuf[], sint32 numBytes)
+/*
+ * The NOR configuration is probed and the device initialized once per
+ * session by extflash_open(). Write, erase and read reuse the cached
+ * configuration until extflash_close() is called.
+ *
+ * Besides the blocking functions, a single page program or erase job can
+ * be started by native FlexSPI IP commands. The job runs in the device,
+ * while extflash_run() polls the NOR status register and issues the next
+ * erase unit. The FBL code runs from RAM, so it continues while the
+ * device is busy. A running erase may be suspended for reading.
+ *
+ * The page size, the erase units and the quad read parameters are taken
+ * from the SFDP tables of the device, if available. The values of
+ * ext_flash_cfg.h are used otherwise. FLASH_PAGE_SIZE and
+ * FLASH_ERASE_SECTOR_SIZE remain the upper page size and the sector size
+ * the callers align to.
+ */
+
+typedef struct
+{
+  uint32 size;
+  uint32 seqID;
+  uint32 typTime;  /* Typical erase time [ms], 0 if unknown */
+  uint8  cmd;
+}T_EXTFLASH_ERASE_UNIT;
+
+/* Block erase units and the sector */
+#define EXTFLASH_MAX_ERASE_UNITS        3
+
+typedef struct
+{
+  boolean isOpen;
+  boolean blockEraseEna;
+  boolean suspendEna;
+  boolean quadEna;
+  boolean jobIsErase;   /* Running job is an erase, otherwise a page program */
+  boolean sfdpValid;
+  uint32 devID;
+  uint8  jedecID[3];    /* Manufacturer, memory type and capacity */
+  uint32 pageSize;      /* Program unit, at most FLASH_PAGE_SIZE */
+  uint32 numEraseUnits;
+  T_EXTFLASH_ERASE_UNIT eraseUnits[EXTFLASH_MAX_ERASE_UNITS]; /* Ordered by decreasing size */
+  T_SFDP_INFO sfdp;
+  uint32 jobAddr;       /* Next erase unit of the running job */
+  uint32 jobSize;       /* Bytes left to be erased behind the running unit */
+  uint32 jobStart;      /* Region of the running job */
+  uint32 jobLen;
+  T_EXTFLASH_STATUS status;
+  T_EXTFLASH_JOB_RESULT jobResult;
+  T_FLEXSPI_NOR_CFG norCfg;
+}T_EXTFLASH_DATA;
+
+static T_EXTFLASH_DATA extflash_dataTbl[1];
+
+
+/* LUT sequences as set up by the ROM */
+#define EXTFLASH_LUT_SEQ_READ           0
+#define EXTFLASH_LUT_SEQ_READ_STATUS    1
+#define EXTFLASH_LUT_SEQ_WRITE_ENABLE   3
+#define EXTFLASH_LUT_SEQ_ERASE_SECTOR   5
+#define EXTFLASH_LUT_SEQ_PAGE_PROGRAM   9
+#define EXTFLASH_LUT_SEQ_READ_SFDP      13  /* Reinstalled, as the ROM's dummy cycles vary */
+
+/* LUT sequences not used by the ROM */
+#define EXTFLASH_LUT_SEQ_READ_ID        2
+#define EXTFLASH_LUT_SEQ_READ_QE        4
+#define EXTFLASH_LUT_SEQ_ERASE_BLOCK1   6
+#define EXTFLASH_LUT_SEQ_ERASE_BLOCK0   7
+#define EXTFLASH_LUT_SEQ_ERASE_SUSPEND  10
+#define EXTFLASH_LUT_SEQ_ERASE_RESUME   12
+
+/* Block erase and quad commands use 3 byte addresses, limiting the flash size */
+#define EXTFLASH_MAX_3B_ADDR_SIZE       0x01000000
+
+/* The sector is erased by the sequence of the ROM */
+static const T_EXTFLASH_ERASE_UNIT extflash_sectorUnit =
+{
+  FLASH_ERASE_SECTOR_SIZE, EXTFLASH_LUT_SEQ_ERASE_SECTOR, 0, 0
+};
+
+#if (FLASH_BLOCK_ERASE_ENA == STD_ON)
+/* Block erase units of devices without SFDP, ordered by decreasing size */
+static const T_EXTFLASH_ERASE_UNIT extflash_blockUnitTbl[EXTFLASH_MAX_ERASE_UNITS - 1] =
+{
+  { FLASH_ERASE_BLOCK64_SIZE, EXTFLASH_LUT_SEQ_ERASE_BLOCK0, 0, FLASH_CMD_ERASE_BLOCK64 },
+  { FLASH_ERASE_BLOCK32_SIZE, EXTFLASH_LUT_SEQ_ERASE_BLOCK1, 0, FLASH_CMD_ERASE_BLOCK32 },
+};
+#endif /* (FLASH_BLOCK_ERASE_ENA == STD_ON) */
+
+#if (FLASH_SFDP_ENA == STD_ON)
+/* LUT sequence reading the SFDP tables */
+static const uint32 extflash_readSfdpLut[FLEXSPI_LUT_SEQ_NUM_WORDS] =
+{
+  FLEXSPI_LUT_INSTR(FLEXSPI_LUT_OPC_CMD_SDR,   FLEXSPI_LUT_PADS_e1, FLASH_CMD_READ_SFDP,
+                    FLEXSPI_LUT_OPC_RADDR_SDR, FLEXSPI_LUT_PADS_e1, 24),
+  FLEXSPI_LUT_INSTR(FLEXSPI_LUT_OPC_DUMMY_SDR, FLEXSPI_LUT_PADS_e1, 8,
+                    FLEXSPI_LUT_OPC_READ_SDR,  FLEXSPI_LUT_PADS_e1, 4),
+  0,
+  0,
+};
+
+typedef struct
+{
+  uint8 cmd;   /* Command reading the status register, 0 if none */
+  uint8 mask;  /* Quad enable bit */
+}T_EXTFLASH_QE_BIT;
+
+/* Location of the quad enable bit per quad enable requirement */
+static const T_EXTFLASH_QE_BIT extflash_qeBitTbl[] =
+{
+  [SFDP_QER_eNONE]              = { 0x00, 0x00 },
+  [SFDP_QER_eSR2_BIT1_WR2]      = { 0x35, 0x02 },
+  [SFDP_QER_eSR1_BIT6]          = { 0x05, 0x40 },
+  [SFDP_QER_eSR2_BIT7]          = { 0x3F, 0x80 },
+  [SFDP_QER_eSR2_BIT1_WR2_KEEP] = { 0x35, 0x02 },
+  [SFDP_QER_eSR2_BIT1_RD35]     = { 0x35, 0x02 },
+  [SFDP_QER_eSR2_BIT1_WR31]     = { 0x35, 0x02 },
+  [SFDP_QER_eUNKNOWN]           = { 0x00, 0x00 },
+};
+#endif /* (FLASH_SFDP_ENA == STD_ON) */
+
+#if (FLASH_ERASE_SUSPEND_ENA == STD_ON)
+/* LUT sequences for erase suspend and resume */
+static const uint32 extflash_suspendLut[FLEXSPI_LUT_SEQ_NUM_WORDS] =
+{
+  FLEXSPI_LUT_INSTR(FLEXSPI_LUT_OPC_CMD_SDR, FLEXSPI_LUT_PADS_e1, FLASH_CMD_ERASE_SUSPEND,
+                    FLEXSPI_LUT_OPC_STOP,    FLEXSPI_LUT_PADS_e1, 0),
+  0,
+  0,
+  0,
+};
+
+static const uint32 extflash_resumeLut[FLEXSPI_LUT_SEQ_NUM_WORDS] =
+{
+  FLEXSPI_LUT_INSTR(FLEXSPI_LUT_OPC_CMD_SDR, FLEXSPI_LUT_PADS_e1, FLASH_CMD_ERASE_RESUME,
+                    FLEXSPI_LUT_OPC_STOP,    FLEXSPI_LUT_PADS_e1, 0),
+  0,
+  0,
+  0,
+};
+#endif /* (FLASH_ERASE_SUSPEND_ENA == STD_ON) */
+
+#if (FLASH_SFDP_ENA == STD_ON)
+/*
+ ******************************************************************************
+ * Function: extflash_readSfdp
+ ******************************************************************************
+ * @brief Read from the SFDP address space of the device
+ *
+ ******************************************************************************
+ */
+
+static T_STATUS extflash_readSfdp(uint32 sfdpAddr, uint8 dstBuf[], uint32 numBytes)
+{
+  return flexspi_readData(sfdpAddr, EXTFLASH_LUT_SEQ_READ_SFDP, dstBuf, numBytes);
+}
+
+
+/*
+ ******************************************************************************
+ * Function: extflash_getSfdpBlockUnits
+ ******************************************************************************
+ * @brief Select the block erase units among the SFDP erase types
+ *
+ * @par Description:
+ *   Erase types larger than a sector are ordered by decreasing size. A type
+ *   not erasing faster than the sectors it covers is dropped, if both
+ *   typical times are known.
+ *
+ * @param [out] units - Block erase units, EXTFLASH_MAX_ERASE_UNITS - 1 at most
+ *
+ * @return Number of block erase units
+ *
+ ******************************************************************************
+ */
+
+static uint32 extflash_getSfdpBlockUnits(const T_SFDP_INFO* sfdp, T_EXTFLASH_ERASE_UNIT units[])
+{
+  T_EXTFLASH_ERASE_UNIT candTbl[SFDP_MAX_ERASE_TYPES];
+  T_EXTFLASH_ERASE_UNIT cand;
+  const T_SFDP_ERASE_TYPE* eraseType;
+  uint32 numCand = 0;
+  uint32 sectTime = 0;
+  uint32 typeIdx;
+  uint32 candIdx;
+
+  for(typeIdx = 0; typeIdx < sfdp->numEraseTypes; typeIdx++)
+  {
+    if(FLASH_ERASE_SECTOR_SIZE == sfdp->eraseTypes[typeIdx].size)
+    {
+      sectTime = sfdp->eraseTypes[typeIdx].typTime;
+    }
+  }
+
+  for(typeIdx = 0; typeIdx < sfdp->numEraseTypes; typeIdx++)
+  {
+    eraseType = &sfdp->eraseTypes[typeIdx];
+    if(eraseType->size <= FLASH_ERASE_SECTOR_SIZE)
+    {
+      /* Sectors are erased by the ROM sequence */
+    }
+    else if( (0 != sectTime) && (0 != eraseType->typTime)
+          && (eraseType->typTime >= ((eraseType->size / FLASH_ERASE_SECTOR_SIZE) * sectTime)) )
+    {
+      /* Not faster than erasing the sectors */
+    }
+    else
+    {
+      /* Insert ordered by decreasing size */
+      candIdx = numCand;
+      while( (candIdx > 0) && (candTbl[candIdx - 1].size < eraseType->size) )
+      {
+        candTbl[candIdx] = candTbl[candIdx - 1];
+        candIdx--;
+      }
+      cand.size = eraseType->size;
+      cand.seqID = 0;
+      cand.typTime = eraseType->typTime;
+      cand.cmd = eraseType->cmd;
+      candTbl[candIdx] = cand;
+      numCand++;
+    }
+  }
+
+  /* The largest units get the free LUT sequences */
+  if(numCand > (EXTFLASH_MAX_ERASE_UNITS - 1))
+  {
+    numCand = EXTFLASH_MAX_ERASE_UNITS - 1;
+  }
+  for(candIdx = 0; candIdx < numCand; candIdx++)
+  {
+    units[candIdx] = candTbl[candIdx];
+    units[candIdx].seqID = (0 == candIdx) ? EXTFLASH_LUT_SEQ_ERASE_BLOCK0 : EXTFLASH_LUT_SEQ_ERASE_BLOCK1;
+  }
+  return numCand;
+}
+#endif /* (FLASH_SFDP_ENA == STD_ON) */
+
+
+/*
+ ******************************************************************************
+ * Function: extflash_setupGeometry
+ ******************************************************************************
+ * @brief Set the page size and the erase units of the device
+ *
+ * @par Description:
+ *   The SFDP parameters are used, if read at open. The configured page
+ *   size and block erase units apply otherwise. Block erase units whose
+ *   sequence can't be installed are dropped, the sector is always erased
+ *   by the sequence of the ROM.
+ *
+ ******************************************************************************
+ */
+
+static void extflash_setupGeometry(T_EXTFLASH_DATA* flashData)
+{
+  T_ROM_API* romApi = romApi_getAddr();
+  T_EXTFLASH_ERASE_UNIT blockUnits[EXTFLASH_MAX_ERASE_UNITS - 1];
+  uint32 eraseLut[FLEXSPI_LUT_SEQ_NUM_WORDS] = { 0 };
+  uint32 numBlockUnits = 0;
+  uint32 unitIdx;
+
+  flashData->pageSize = FLASH_PAGE_SIZE;
+#if (FLASH_SFDP_ENA == STD_ON)
+  if( (FALSE != flashData->sfdpValid) && (flashData->sfdp.pageSize < FLASH_PAGE_SIZE) )
+  {
+    flashData->pageSize = flashData->sfdp.pageSize;
+  }
+#endif /* (FLASH_SFDP_ENA == STD_ON) */
+
+  /* The ROM programs pages of the configured size */
+  flashData->norCfg.pageSize = flashData->pageSize;
+
+#if (FLASH_BLOCK_ERASE_ENA == STD_ON)
+  if(flashData->norCfg.memCfg.sflashA1Size > EXTFLASH_MAX_3B_ADDR_SIZE)
+  {
+    /* Block erase commands can't address the whole flash */
+  }
+#if (FLASH_SFDP_ENA == STD_ON)
+  else if(FALSE != flashData->sfdpValid)
+  {
+    numBlockUnits = extflash_getSfdpBlockUnits(&flashData->sfdp, blockUnits);
+  }
+#endif /* (FLASH_SFDP_ENA == STD_ON) */
+  else
+  {
+    libc_memcpy(blockUnits, extflash_blockUnitTbl, sizeof(extflash_blockUnitTbl));
+    numBlockUnits = sizeof(extflash_blockUnitTbl) / sizeof(extflash_blockUnitTbl[0]);
+  }
+#endif /* (FLASH_BLOCK_ERASE_ENA == STD_ON) */
+
+  flashData->numEraseUnits = 0;
+  for(unitIdx = 0; unitIdx < numBlockUnits; unitIdx++)
+  {
+    eraseLut[0] = FLEXSPI_LUT_INSTR(FLEXSPI_LUT_OPC_CMD_SDR,   FLEXSPI_LUT_PADS_e1, blockUnits[unitIdx].cmd,
+                                    FLEXSPI_LUT_OPC_RADDR_SDR, FLEXSPI_LUT_PADS_e1, 24);
+    if(0 != romApi->norFlashApi->updateLut(flashData->devID, blockUnits[unitIdx].seqID, eraseLut, 1))
+    {
+      /* Failed, so erase by smaller units */
+    }
+    else
+    {
+      flashData->eraseUnits[flashData->numEraseUnits] = blockUnits[unitIdx];
+      flashData->numEraseUnits++;
+    }
+  }
+
+  flashData->eraseUnits[flashData->numEraseUnits] = extflash_sectorUnit;
+  flashData->numEraseUnits++;
+
+  flashData->blockEraseEna = (flashData->numEraseUnits > 1);
+}
+
+
+#if (FLASH_QUAD_LUT_ENA == STD_ON)
+/* LUT sequence reading the JEDEC ID */
+static const uint32 extflash_readIdLut[FLEXSPI_LUT_SEQ_NUM_WORDS] =
+{
+  FLEXSPI_LUT_INSTR(FLEXSPI_LUT_OPC_CMD_SDR,  FLEXSPI_LUT_PADS_e1, FLASH_CMD_READ_ID,
+                    FLEXSPI_LUT_OPC_READ_SDR, FLEXSPI_LUT_PADS_e1, 4),
+  0,
+  0,
+  0,
+};
+
+
+/*
+ ******************************************************************************
+ * Function: extflash_readID
+ ******************************************************************************
+ * @brief Read the JEDEC ID of the device
+ *
+ ******************************************************************************
+ */
+
+static T_STATUS extflash_readID(T_EXTFLASH_DATA* flashData)
+{
+  T_ROM_API* romApi = romApi_getAddr();
+  T_STATUS result = STATUS_eNOK;
+
+  if(0 != romApi->norFlashApi->updateLut(flashData->devID, EXTFLASH_LUT_SEQ_READ_ID, extflash_readIdLut, 1))
+  {
+    /* Failed */
+  }
+  else
+  {
+    result = flexspi_readData(0, EXTFLASH_LUT_SEQ_READ_ID, flashData->jedecID, sizeof(flashData->jedecID));
+  }
+  return result;
+}
+
+
+/*
+ ******************************************************************************
+ * Function: extflash_isQuadEnabled
+ ******************************************************************************
+ * @brief Check the quad enable bit of the device
+ *
+ * @par Description:
+ *   The status register holding the bit is given by the quad enable
+ *   requirement of the SFDP tables. Without SFDP or a known requirement
+ *   the quad mode is assumed to be enabled by the boot configuration.
+ *
+ ******************************************************************************
+ */
+
+static boolean extflash_isQuadEnabled(T_EXTFLASH_DATA* flashData)
+{
+  boolean isEnabled = !FALSE;
+#if (FLASH_SFDP_ENA == STD_ON)
+  T_ROM_API* romApi = romApi_getAddr();
+  const T_EXTFLASH_QE_BIT* qeBit;
+  uint32 statusLut[FLEXSPI_LUT_SEQ_NUM_WORDS] = { 0 };
+  uint8 status = 0;
+
+  if(FALSE == flashData->sfdpValid)
+  {
+    /* Requirement unknown */
+  }
+  else if(0 == extflash_qeBitTbl[flashData->sfdp.quadEnableReq].cmd)
+  {
+    /* No quad enable bit */
+  }
+  else
+  {
+    qeBit = &extflash_qeBitTbl[flashData->sfdp.quadEnableReq];
+    statusLut[0] = FLEXSPI_LUT_INSTR(FLEXSPI_LUT_OPC_CMD_SDR,  FLEXSPI_LUT_PADS_e1, qeBit->cmd,
+                                     FLEXSPI_LUT_OPC_READ_SDR, FLEXSPI_LUT_PADS_e1, 1);
+
+    if(0 != romApi->norFlashApi->updateLut(flashData->devID, EXTFLASH_LUT_SEQ_READ_QE, statusLut, 1))
+    {
+      isEnabled = FALSE;
+    }
+    else if(STATUS_eOK != flexspi_readData(0, EXTFLASH_LUT_SEQ_READ_QE, &status, 1))
+    {
+      isEnabled = FALSE;
+    }
+    else
+    {
+      isEnabled = (0 != (status & qeBit->mask));
+    }
+  }
+#endif /* (FLASH_SFDP_ENA == STD_ON) */
+  return isEnabled;
+}
+
+
+/*
+ ******************************************************************************
+ * Function: extflash_setupQuad
+ ******************************************************************************
+ * @brief Install the quad page program and fast read sequences
+ *
+ * @par Description:
+ *   The program sequence is taken from the quad configuration of the
+ *   device's manufacturer. The read sequence is taken from the SFDP
+ *   tables, if available, and from the quad configuration otherwise.
+ *   Devices not listed and devices with the quad mode disabled keep the
+ *   sequences of the ROM.
+ *
+ * @return STATUS_eOK if the sequences were installed, STATUS_eNOK otherwise
+ *
+ ******************************************************************************
+ */
+
+static T_STATUS extflash_setupQuad(T_EXTFLASH_DATA* flashData)
+{
+  T_ROM_API* romApi = romApi_getAddr();
+  const T_EXTFLASH_QUAD_CFG* quadCfg = NULL;
+  T_STATUS result = STATUS_eNOK;
+  uint32 progLut[FLEXSPI_LUT_SEQ_NUM_WORDS] = { 0 };
+  uint32 readLut[FLEXSPI_LUT_SEQ_NUM_WORDS] = { 0 };
+  uint32 readAddrPads = FLEXSPI_LUT_PADS_e4;
+  uint32 readDummy;
+  uint8  readCmd;
+  uint32 cfgIdx;
+
+  for(cfgIdx = 0; cfgIdx < (sizeof(extflash_quadCfgTbl) / sizeof(extflash_quadCfgTbl[0])); cfgIdx++)
+  {
+    if(extflash_quadCfgTbl[cfgIdx].mfrID == flashData->jedecID[0])
+    {
+      quadCfg = &extflash_quadCfgTbl[cfgIdx];
+    }
+  }
+
+  if(NULL == quadCfg)
+  {
+    /* Unknown manufacturer */
+  }
+  else if(FALSE == extflash_isQuadEnabled(flashData))
+  {
+    /* Quad data lines not enabled */
+  }
+  else
+  {
+    readCmd = quadCfg->readCmd;
+    readDummy = quadCfg->readDummy;
+#if (FLASH_SFDP_ENA == STD_ON)
+    if( (FALSE != flashData->sfdpValid) && (0 != flashData->sfdp.quadReadCmd) )
+    {
+      readCmd = flashData->sfdp.quadReadCmd;
+      readAddrPads = (4 == flashData->sfdp.quadReadAddrPads) ? FLEXSPI_LUT_PADS_e4 : FLEXSPI_LUT_PADS_e1;
+      readDummy = flashData->sfdp.quadReadDummy;
+    }
+#endif /* (FLASH_SFDP_ENA == STD_ON) */
+
+    progLut[0] = FLEXSPI_LUT_INSTR(FLEXSPI_LUT_OPC_CMD_SDR,   FLEXSPI_LUT_PADS_e1, quadCfg->progCmd,
+                                   FLEXSPI_LUT_OPC_RADDR_SDR, quadCfg->progAddrPads, 24);
+    progLut[1] = FLEXSPI_LUT_INSTR(FLEXSPI_LUT_OPC_WRITE_SDR, FLEXSPI_LUT_PADS_e4, 4,
+                                   FLEXSPI_LUT_OPC_STOP,      FLEXSPI_LUT_PADS_e1, 0);
+
+    readLut[0] = FLEXSPI_LUT_INSTR(FLEXSPI_LUT_OPC_CMD_SDR,   FLEXSPI_LUT_PADS_e1, readCmd,
+                                   FLEXSPI_LUT_OPC_RADDR_SDR, readAddrPads, 24);
+    readLut[1] = FLEXSPI_LUT_INSTR(FLEXSPI_LUT_OPC_DUMMY_SDR, FLEXSPI_LUT_PADS_e4, readDummy,
+                                   FLEXSPI_LUT_OPC_READ_SDR,  FLEXSPI_LUT_PADS_e4, 4);
+
+    if(0 != romApi->norFlashApi->updateLut(flashData->devID, EXTFLASH_LUT_SEQ_PAGE_PROGRAM, progLut, 1))
+    {
+      /* Failed */
+    }
+    else if(0 != romApi->norFlashApi->updateLut(flashData->devID, EXTFLASH_LUT_SEQ_READ, readLut, 1))
+    {
+      /* Failed */
+    }
+    else
+    {
+      result = STATUS_eOK;
+    }
+
+    /* Data prefetched by the previous read sequence is dropped */
+    flexspi_clearAhbBuffers();
+  }
+  return result;
+}
+#endif /* (FLASH_QUAD_LUT_ENA == STD_ON) */
+
+
+/*
+ ******************************************************************************
+ * Function: extflash_open
+ ******************************************************************************
+ * @brief Open a session on the serial NOR flash
+ *
+ * @par Description:
+ *   Gets the NOR configuration from the ROM and initializes the device,
+ *   if no session has been opened yet. Otherwise the cached configuration
+ *   is kept.
+ *
+ * @return STATUS_eOK if the session is open, STATUS_eNOK otherwise
+ *
+ ******************************************************************************
+ */
+
+T_STATUS extflash_open(void)
+{
+  T_EXTFLASH_DATA* flashData = extflash_dataTbl;
+  T_ROM_API* romApi;
+  T_SER_NOR_ONFIG_OPTION cfgOpt =
+  {
+    .option0.U = 0xC0000008,
+    .option1.U = 0,
+  };
+  T_STATUS result = STATUS_eNOK;
+
+  if(FALSE != flashData->isOpen)
+  {
+    /* Session already open */
+    result = STATUS_eOK;
+  }
+  else
+  {
+    PROF_START(PROF_ID_eFLASH_OPEN);
+
+    romApi = romApi_getAddr();
+    flashData->devID = 0;
+
+    /* Get the flash configuration block */
+    if(0 != romApi->norFlashApi->getConfig(flashData->devID, &flashData->norCfg, &cfgOpt))
+    {
+      /* Failed */
+    }
+    /* Initialize the serial NOR device */
+    else if(0 != romApi->norFlashApi->init(flashData->devID, &flashData->norCfg))
+    {
+      /* Failed */
+    }
+    else
+    {
+      /* IP commands are issued to the controller set up by the ROM */
+      flexspi_init(FLEXSPI_BASE);
+      flashData->status = EXTFLASH_STATUS_eIDLE;
+      flashData->jobResult = EXTFLASH_JOB_RESULT_eOK;
+      flashData->isOpen = !FALSE;
+      result = STATUS_eOK;
+    }
+
+#if (FLASH_SFDP_ENA == STD_ON)
+    flashData->sfdpValid = FALSE;
+    if(STATUS_eOK != result)
+    {
+      /* Not initialized */
+    }
+    /* Install the SFDP read sequence */
+    else if(0 != romApi->norFlashApi->updateLut(flashData->devID, EXTFLASH_LUT_SEQ_READ_SFDP, extflash_readSfdpLut, 1))
+    {
+      /* Failed, so keep the configured parameters */
+    }
+    else if(STATUS_eOK != sfdp_parse(extflash_readSfdp, &flashData->sfdp))
+    {
+      /* No SFDP, so keep the configured parameters */
+    }
+    else
+    {
+      flashData->sfdpValid = !FALSE;
+    }
+#endif /* (FLASH_SFDP_ENA == STD_ON) */
+
+    if(STATUS_eOK == result)
+    {
+      extflash_setupGeometry(flashData);
+    }
+
+#if (FLASH_ERASE_SUSPEND_ENA == STD_ON)
+    flashData->suspendEna = FALSE;
+    if(STATUS_eOK != result)
+    {
+      /* Not initialized */
+    }
+    /* Install the erase suspend and resume sequences */
+    else if(0 != romApi->norFlashApi->updateLut(flashData->devID, EXTFLASH_LUT_SEQ_ERASE_SUSPEND, extflash_suspendLut, 1))
+    {
+      /* Failed, so erase can't be suspended */
+    }
+    else if(0 != romApi->norFlashApi->updateLut(flashData->devID, EXTFLASH_LUT_SEQ_ERASE_RESUME, extflash_resumeLut, 1))
+    {
+      /* Failed, so erase can't be suspended */
+    }
+    else
+    {
+      flashData->suspendEna = !FALSE;
+    }
+#endif /* (FLASH_ERASE_SUSPEND_ENA == STD_ON) */
+
+#if (FLASH_QUAD_LUT_ENA == STD_ON)
+    flashData->quadEna = FALSE;
+    if(STATUS_eOK != result)
+    {
+      /* Not initialized */
+    }
+    else if(flashData->norCfg.memCfg.sflashA1Size > EXTFLASH_MAX_3B_ADDR_SIZE)
+    {
+      /* Quad sequences can't address the whole flash */
+    }
+    else if(STATUS_eOK != extflash_readID(flashData))
+    {
+      /* Device not identified, keep the sequences of the ROM */
+    }
+    else if(STATUS_eOK != extflash_setupQuad(flashData))
+    {
+      /* Keep the sequences of the ROM */
+    }
+    else
+    {
+      flashData->quadEna = !FALSE;
+    }
+#endif /* (FLASH_QUAD_LUT_ENA == STD_ON) */
+
+    PROF_STOP(PROF_ID_eFLASH_OPEN);
+  }
+  return result;
+}
+
+
+/*
+ ******************************************************************************
+ * Function: extflash_close
+ ******************************************************************************
+ * @brief Close the session on the serial NOR flash
+ *
+ * @par Description:
+ *   Drops the cached configuration, so the next access probes the device
+ *   again. This is required, if the FlexSPI has been reconfigured.
+ *
+ ******************************************************************************
+ */
+
+void extflash_close(void)
+{
+  T_EXTFLASH_DATA* flashData = extflash_dataTbl;
+
+  flashData->isOpen = FALSE;
+}
+
+
+/*
+ ******************************************************************************
+ * Function: extflash_read
+ ******************************************************************************
+ * @brief Read from flash by IP commands
+ *
+ * @param [in]  logAddr  - Flash address relative to the flash start
+ * @param [out] dstBuf   - Buffer receiving the data
+ * @param [in]  numBytes - Number of bytes to read
+ *
+ * @return STATUS_eOK on success, STATUS_eNOK otherwise
+ *
+ ******************************************************************************
+ */
+
+T_STATUS extflash_read(uint32 logAddr, uint8 dstBuf[], uint32 numBytes)
+{
+  T_EXTFLASH_DATA* flashData = extflash_dataTbl;
+  T_ROM_API* romApi;
+  T_STATUS result = STATUS_eNOK;
+
+  romApi = romApi_getAddr();
+  if(STATUS_eOK != extflash_open())
+  {
+    /* Failed */
+  }
+  else if(EXTFLASH_STATUS_eBUSY == flashData->status)
+  {
+    /* Device busy by a job */
+  }
+  else if(0 != romApi->norFlashApi->read(flashData->devID, &flashData->norCfg, dstBuf, logAddr, numBytes))
+  {
+    /* Failed */
+  }
+  else
+  {
+    result = STATUS_eOK;
+  }
+  return result;
+}
+
+
+/*
+ ******************************************************************************
+ * Function: extflash_write
+ ******************************************************************************
+ * @brief Program the specified region of flash
+ *
+ * @par Description:
+ *   Function is used to program the flash page wise. Full pages of a word
+ *   aligned source are handed to the ROM without copying, partial pages
+ *   are copied to a page buffer padded by the flash blank value.
+ *
+ ******************************************************************************
+ */
+
+__itcm_text T_STATUS extflash_write(uint32 dstAddr, uint8 srcBuf[], uint32 numBytes)
+{
+  T_EXTFLASH_DATA* flashData = extflash_dataTbl;
+  T_ROM_API* romApi;
+  T_STATUS result = STATUS_eNOK;
+  uint32 pageSize;
+  uint32 pageAddr;
+  uint32 pageOffs;
+  uint32 bytesToCopyToBuffer;
+  uint32 bytesWritten;
+  uint32 pageBuffer[FLASH_PAGE_SIZE / sizeof(uint32)];
+  uint8* pagePtr = (uint8*)(void*)pageBuffer;
+  const uint8* pageSrc;
+
+  PROF_START(PROF_ID_eFLASH_WRITE);
+
+  romApi = romApi_getAddr();
+  if(STATUS_eOK != extflash_open())
+  {
+    /* Failed */
+  }
+  else if(EXTFLASH_STATUS_eIDLE != flashData->status)
+  {
+    /* Device busy by a job */
+  }
+  else
+  {
+    pageSize = flashData->pageSize;
+    pageOffs = dstAddr & (pageSize - 1);
+    pageAddr = dstAddr - pageOffs;
+
+    for(bytesWritten = 0; bytesWritten < numBytes; bytesWritten += bytesToCopyToBuffer)
+    {
+      if(pageOffs > 0)
+      {
+        bytesToCopyToBuffer = pageSize - pageOffs;
+      }
+      else
+      {
+        bytesToCopyToBuffer = pageSize;
+      }
+
+      if( (numBytes - bytesWritten) < bytesToCopyToBuffer)
+      {
+        bytesToCopyToBuffer = numBytes - bytesWritten;
+      }
+
+      if( (bytesToCopyToBuffer == pageSize)
+       && (0 == ((uint32)(void*)&srcBuf[bytesWritten] & (sizeof(uint32) - 1))) )
+      {
+        /* Full page from a word aligned source, program it in place */
+        pageSrc = &srcBuf[bytesWritten];
+      }
+      else
+      {
+        if(bytesToCopyToBuffer != pageSize)
+        {
+          libc_memset(pageBuffer, FLASH_BLANK_VALUE, pageSize);
+        }
+
+        libc_memcpy(&pagePtr[pageOffs], &srcBuf[bytesWritten], bytesToCopyToBuffer);
+        pageSrc = pagePtr;
+      }
+
+      if(0 != romApi->norFlashApi->writePage(flashData->devID, &flashData->norCfg, pageAddr, pageSrc))
+      {
+        /* Fail */
+        result = STATUS_eNOK;
+        break;
+      }
+      else
+      {
+        /* Success */
+        pageAddr += pageSize;
+        pageOffs = 0;
+        result = STATUS_eOK;
+      }
+    }
+  }
+
+  /* Drop stale cached data of the programmed range */
+  cpu_invalidateDCacheRange(FLASH_AHB_BASE_ADDR + dstAddr, numBytes);
+
+  PROF_STOP(PROF_ID_eFLASH_WRITE);
+  return result;
+}
+
+
+/*
+ ******************************************************************************
+ * Function: extflash_isBusy
+ ******************************************************************************
+ * @brief Read the NOR status register and check the busy bit
+ *
+ * @param [out] isBusy - !FALSE while the device programs or erases
+ *
+ * @return STATUS_eOK if the status was read, STATUS_eNOK otherwise
+ *
+ ******************************************************************************
+ */
+
+__itcm_text static T_STATUS extflash_isBusy(T_EXTFLASH_DATA* flashData, boolean* isBusy)
+{
+  T_FLEXSPI_MEM_CFG* memCfg = &flashData->norCfg.memCfg;
+  T_STATUS result;
+  uint8 status = 0;
+
+  result = flexspi_readData(0, EXTFLASH_LUT_SEQ_READ_STATUS, &status, 1);
+
+  /* The busy bit is active low, if the polarity is set */
+  *isBusy = (((status >> memCfg->busyOffset) & 1) == (memCfg->busyBitPolarity ? 0 : 1));
+  return result;
+}
+
+
+/*
+ ******************************************************************************
+ * Function: extflash_waitReady
+ ******************************************************************************
+ * @brief Poll the NOR status register until the device is ready
+ *
+ ******************************************************************************
+ */
+
+__itcm_text static T_STATUS extflash_waitReady(T_EXTFLASH_DATA* flashData)
+{
+  T_STATUS result = STATUS_eOK;
+  boolean isBusy = !FALSE;
+
+  while( (FALSE != isBusy) && (STATUS_eOK == result) )
+  {
+    result = extflash_isBusy(flashData, &isBusy);
+  }
+  return result;
+}
+
+
+/*
+ ******************************************************************************
+ * Function: extflash_planErase
+ ******************************************************************************
+ * @brief Get the largest erase unit fitting at the given address
+ *
+ * @param [in]  logAddr  - Sector aligned start of the remaining region
+ * @param [in]  numBytes - Sector aligned size of the remaining region
+ * @param [out] seqID    - LUT sequence erasing the unit
+ *
+ * @return Size of the erase unit
+ *
+ ******************************************************************************
+ */
+
+__itcm_text static uint32 extflash_planErase(T_EXTFLASH_DATA* flashData, uint32 logAddr, uint32 numBytes, uint32* seqID)
+{
+  const T_EXTFLASH_ERASE_UNIT* unit = flashData->eraseUnits;
+
+  /* The sector, being the smallest unit, always fits into a sector aligned region */
+  while( (EXTFLASH_LUT_SEQ_ERASE_SECTOR != unit->seqID)
+      && ( (FALSE == flashData->blockEraseEna)
+        || (0 != (logAddr & (unit->size - 1)))
+        || (numBytes < unit->size) ) )
+  {
+    unit++;
+  }
+  *seqID = unit->seqID;
+  return unit->size;
+}
+
+
+/*
+ ******************************************************************************
+ * Function: extflash_startEraseUnit
+ ******************************************************************************
+ * @brief Start erasing the next unit of the running erase job
+ *
+ ******************************************************************************
+ */
+
+__itcm_text static T_STATUS extflash_startEraseUnit(T_EXTFLASH_DATA* flashData)
+{
+  T_STATUS result = STATUS_eNOK;
+  uint32 unitSize;
+  uint32 seqID;
+
+  unitSize = extflash_planErase(flashData, flashData->jobAddr, flashData->jobSize, &seqID);
+
+  if(STATUS_eOK != flexspi_execCmd(flashData->jobAddr, EXTFLASH_LUT_SEQ_WRITE_ENABLE))
+  {
+    /* Failed */
+  }
+  else if(STATUS_eOK != flexspi_execCmd(flashData->jobAddr, seqID))
+  {
+    /* Failed */
+  }
+  else
+  {
+    result = STATUS_eOK;
+  }
+  flashData->jobAddr += unitSize;
+  flashData->jobSize -= unitSize;
+  return result;
+}
+
+
+/*
+ ******************************************************************************
+ * Function: extflash_finishJob
+ ******************************************************************************
+ * @brief Finish the running job and drop stale data of its region
+ *
+ ******************************************************************************
+ */
+
+__itcm_text static void extflash_finishJob(T_EXTFLASH_DATA* flashData, T_EXTFLASH_JOB_RESULT jobResult)
+{
+  /* Drop the prefetched data of the AHB buffers and the D-cache */
+  flexspi_clearAhbBuffers();
+  cpu_invalidateDCacheRange(FLASH_AHB_BASE_ADDR + flashData->jobStart, flashData->jobLen);
+
+  flashData->jobResult = jobResult;
+  flashData->status = EXTFLASH_STATUS_eIDLE;
+}
+
+
+#if (FLASH_BLOCK_ERASE_ENA == STD_ON)
+/*
+ ******************************************************************************
+ * Function: extflash_eraseBlocks
+ ******************************************************************************
+ * @brief Erase a sector aligned region by the fewest erase commands
+ *
+ * @par Description:
+ *   64 KiB blocks are erased where aligned, 32 KiB blocks and 4 KiB
+ *   sectors at the edges of the region. The units are issued as an erase
+ *   job, which is polled until done.
+ *
+ ******************************************************************************
+ */
+
+__itcm_text static T_STATUS extflash_eraseBlocks(T_EXTFLASH_DATA* flashData, uint32 logAddr, uint32 numBytes)
 {
-  T_ROM_API* romApi;
-  T_FLEXSPI_NOR_CFG norCfg;
-  T_SER_NOR_ONFIG_OPTION cfgOpt =
+  T_STATUS result = STATUS_eOK;
+
+  flashData->jobAddr = logAddr;
+  flashData->jobSize = numBytes;
+
+  while( (flashData->jobSize > 0) && (STATUS_eOK == result) )
   {
-    .option0.U = 0xC0000008,
-    .option1.U = 0,
-  };
+    result = extflash_startEraseUnit(flashData);
+    if(STATUS_eOK == result)
+    {
+      result = extflash_waitReady(flashData);
+    }
+  }
+
+  /* Drop the prefetched data of the AHB buffers */
+  flexspi_clearAhbBuffers();
+  return result;
+}
+#endif /* (FLASH_BLOCK_ERASE_ENA == STD_ON) */
+
 
+/*
+ ******************************************************************************
+ *
+ ******************************************************************************
+ * @brief Erase specified region of flash
+ *
+ * @par Description:
+ *   Function is used to erase the specified flash region where the minimum
+ *   erase unit is one erase sector.
+ *
+ ******************************************************************************
+ */
+
+__itcm_text T_STATUS extflash_erase(uint32 logAddr, uint32 numBytes)
+{
+  T_EXTFLASH_DATA* flashData = extflash_dataTbl;
+  T_ROM_API* romApi;
   T_STATUS result = STATUS_eNOK;
-  uint32 pageAddr = dstAddr & ~(FLASH_PAGE_SIZE - 1);
-  uint32 pageOffs = dstAddr & (FLASH_PAGE_SIZE - 1);
-  uint32 bytesToCopyToBuffer;
-  uint32 bytesWritten;
-  uint32 pageBuffer[FLASH_PAGE_SIZE / sizeof(uint32)];
-  uint8* pagePtr = (uint8*)(void*)pageBuffer;
-  uint32 devID = 0;
+  uint32 sectAddr = logAddr & ~(FLASH_ERASE_SECTOR_SIZE - 1);
+  uint32 endAddr = (logAddr + numBytes + FLASH_ERASE_SECTOR_SIZE - 1) & ~(FLASH_ERASE_SECTOR_SIZE - 1);
+  uint32 regionSize  = endAddr - sectAddr;
 
-  romApi = romApi_getAddr(); 
-  if(0 != romApi->norFlashApi->getConfig(devID, &norCfg, &cfgOpt))
+  PROF_START(PROF_ID_eFLASH_ERASE);
+
+  romApi = romApi_getAddr();
+
+  /* Open the session, if not yet done */
+  if(STATUS_eOK != extflash_open())
   {
     /* Failed */
   }
-  else if(0 != romApi->norFlashApi->init(devID, &norCfg))
+  else if(EXTFLASH_STATUS_eIDLE != flashData->status)
+  {
+    /* Device busy by a job */
+  }
+#if (FLASH_BLOCK_ERASE_ENA == STD_ON)
+  /* Erase requested region by block erase commands */
+  else if(FALSE != flashData->blockEraseEna)
+  {
+    result = extflash_eraseBlocks(flashData, sectAddr, regionSize);
+  }
+#endif /* (FLASH_BLOCK_ERASE_ENA == STD_ON) */
+  /* Erase requested region by the ROM */
+  else if(0 != romApi->norFlashApi->erase(flashData->devID, &flashData->norCfg, sectAddr, regionSize))
   {
     /* Failed */
   }
   else
   {
-    pageOffs = dstAddr & (FLASH_PAGE_SIZE - 1);
-    pageAddr = dstAddr - pageOffs;
+    result = STATUS_eOK;
+  }
 
-    for(bytesWritten = 0; bytesWritten < numBytes; bytesWritten += bytesToCopyToBuffer)
-    {
-      if(pageOffs > 0)
-      {
-        bytesToCopyToBuffer = FLASH_PAGE_SIZE - pageOffs;
-      }
-      else
-      {
-        bytesToCopyToBuffer = FLASH_PAGE_SIZE;
-      }
+  /* Drop stale cached data of the erased sectors */
+  cpu_invalidateDCacheRange(FLASH_AHB_BASE_ADDR + sectAddr, regionSize);
 
-      if( (numBytes - bytesWritten) < bytesToCopyToBuffer)
-      {
-        bytesToCopyToBuffer = numBytes - bytesWritten;
-      }
+  PROF_STOP(PROF_ID_eFLASH_ERASE);
+  return result;
+}
 
-      if(bytesToCopyToBuffer != FLASH_PAGE_SIZE)
-      {
-        libc_memset(pageBuffer, FLASH_BLANK_VALUE, sizeof(pageBuffer));
-      }
 
-      libc_memcpy(&pagePtr[pageOffs], &srcBuf[bytesWritten], bytesToCopyToBuffer);
-      if(0 != romApi->norFlashApi->writePage(devID, &norCfg, pageAddr, (uint8*)pageBuffer))
-      {
-        /* Fail */
-        result = STATUS_eNOK;
-        break;
-      }
-      else
-      {
-        /* Success */
-        pageAddr += FLASH_PAGE_SIZE;
-        pageOffs = 0;
-        result = STATUS_eOK;
-      }
+/*
+ ******************************************************************************
+ * Function: extflash_isBlank
+ ******************************************************************************
+ * @brief Check whether the specified region of flash is blank
+ *
+ * @par Description:
+ *   The region is read word wise through the memory mapped FlexSPI window,
+ *   which is much faster than erasing it. The check stops at the first
+ *   word differing from the flash blank value.
+ *
+ * @param [in] logAddr  - Word aligned flash address relative to the flash start
+ * @param [in] numBytes - Number of bytes to check, multiple of a word
+ *
+ * @return !FALSE if all words are blank, FALSE otherwise
+ *
+ ******************************************************************************
+ */
+
+boolean extflash_isBlank(uint32 logAddr, uint32 numBytes)
+{
+  const volatile uint32* wordPtr = (const volatile uint32*)(FLASH_AHB_BASE_ADDR + logAddr);
+  uint32 numWords = numBytes / sizeof(uint32);
+  boolean result = !FALSE;
+
+  while( (numWords > 0) && (FALSE != result) )
+  {
+    if(FLASH_BLANK_VALUE != *wordPtr)
+    {
+      result = FALSE;
     }
+    wordPtr++;
+    numWords--;
   }
   return result;
 }
@@ -87,53 +1088,301 @@ T_STATUS extflash_write(uint32 dstAddr, uint8 srcBuf[], sint32 numBytes)
 
 /*
  ******************************************************************************
- *
+ * Function: extflash_startWrite
  ******************************************************************************
- * @brief Erase specified region of flash
+ * @brief Start programming a page by a native IP command
  *
  * @par Description:
- *   Function is used to erase the specified flash region where the minimum
- *   erase unit is one erase sector.
+ *   The page data is moved into the device before the function returns,
+ *   so the source buffer may be reused right away. The program completes
+ *   in the background and is polled by extflash_run().
+ *
+ * @param [in] logAddr - Page aligned flash address relative to the flash start
+ * @param [in] srcBuf  - Page data of extflash_getPageSize() bytes
+ *
+ * @return STATUS_eOK if the job was started, STATUS_eNOK otherwise
  *
  ******************************************************************************
  */
 
-T_STATUS extflash_erase(uint32 logAddr, uint32 numBytes)
+__itcm_text T_STATUS extflash_startWrite(uint32 logAddr, const uint8 srcBuf[])
 {
-  T_ROM_API* romApi;
-  T_FLEXSPI_NOR_CFG norCfg;
-  T_SER_NOR_ONFIG_OPTION cfgOpt =
+  T_EXTFLASH_DATA* flashData = extflash_dataTbl;
+  T_STATUS result = STATUS_eNOK;
+
+  if(STATUS_eOK != extflash_open())
   {
-    .option0.U = 0xC0000008,
-    .option1.U = 0,
-  };
+    /* Failed */
+  }
+  else if(EXTFLASH_STATUS_eIDLE != flashData->status)
+  {
+    /* Device busy by a job */
+  }
+  else if(0 != (logAddr & (flashData->pageSize - 1)))
+  {
+    /* Improper alignment of the page */
+  }
+  else if(STATUS_eOK != flexspi_execCmd(logAddr, EXTFLASH_LUT_SEQ_WRITE_ENABLE))
+  {
+    /* Failed */
+  }
+  else if(STATUS_eOK != flexspi_writeData(logAddr, EXTFLASH_LUT_SEQ_PAGE_PROGRAM, srcBuf, flashData->pageSize))
+  {
+    /* Failed */
+  }
+  else
+  {
+    flashData->jobIsErase = FALSE;
+    flashData->jobStart = logAddr;
+    flashData->jobLen = flashData->pageSize;
+    flashData->jobSize = 0;
+    flashData->jobResult = EXTFLASH_JOB_RESULT_ePENDING;
+    flashData->status = EXTFLASH_STATUS_eBUSY;
+    result = STATUS_eOK;
+  }
+  return result;
+}
+
+
+/*
+ ******************************************************************************
+ * Function: extflash_startErase
+ ******************************************************************************
+ * @brief Start erasing a region by native IP commands
+ *
+ * @par Description:
+ *   The region is rounded to sectors and erased by the largest erase units
+ *   fitting. Only the first unit is issued here, the following ones are
+ *   issued by extflash_run(), once the device is ready again.
+ *
+ * @return STATUS_eOK if the job was started, STATUS_eNOK otherwise
+ *
+ ******************************************************************************
+ */
 
+__itcm_text T_STATUS extflash_startErase(uint32 logAddr, uint32 numBytes)
+{
+  T_EXTFLASH_DATA* flashData = extflash_dataTbl;
   T_STATUS result = STATUS_eNOK;
   uint32 sectAddr = logAddr & ~(FLASH_ERASE_SECTOR_SIZE - 1);
-  uint32 sectOffs = logAddr &  (FLASH_ERASE_SECTOR_SIZE - 1);
-  uint32 regionSize  = sectOffs + numBytes;
-  uint32 devID = 0;
+  uint32 endAddr = (logAddr + numBytes + FLASH_ERASE_SECTOR_SIZE - 1) & ~(FLASH_ERASE_SECTOR_SIZE - 1);
 
-  romApi = romApi_getAddr();
+  if(STATUS_eOK != extflash_open())
+  {
+    /* Failed */
+  }
+  else if(EXTFLASH_STATUS_eIDLE != flashData->status)
+  {
+    /* Device busy by a job */
+  }
+  else if(sectAddr == endAddr)
+  {
+    /* Nothing to erase */
+    result = STATUS_eOK;
+  }
+  else
+  {
+    flashData->jobIsErase = !FALSE;
+    flashData->jobStart = sectAddr;
+    flashData->jobLen = endAddr - sectAddr;
+    flashData->jobAddr = sectAddr;
+    flashData->jobSize = endAddr - sectAddr;
+    flashData->jobResult = EXTFLASH_JOB_RESULT_ePENDING;
+    flashData->status = EXTFLASH_STATUS_eBUSY;
+
+    result = extflash_startEraseUnit(flashData);
+    if(STATUS_eOK != result)
+    {
+      extflash_finishJob(flashData, EXTFLASH_JOB_RESULT_eFAILED);
+    }
+  }
+  return result;
+}
+
+
+/*
+ ******************************************************************************
+ * Function: extflash_run
+ ******************************************************************************
+ * @brief Poll the progress of the running job
+ *
+ * @par Description:
+ *   Reads the NOR status register once. When the device is ready, the
+ *   next erase unit is issued or the job is finished. A suspended job is
+ *   left alone until it is resumed.
+ *
+ ******************************************************************************
+ */
+
+__itcm_text void extflash_run(void)
+{
+  T_EXTFLASH_DATA* flashData = extflash_dataTbl;
+  boolean isBusy = !FALSE;
+
+  if(EXTFLASH_STATUS_eBUSY != flashData->status)
+  {
+    /* No job running */
+  }
+  else if(STATUS_eOK != extflash_isBusy(flashData, &isBusy))
+  {
+    extflash_finishJob(flashData, EXTFLASH_JOB_RESULT_eFAILED);
+  }
+  else if(FALSE != isBusy)
+  {
+    /* Device still programming or erasing */
+  }
+  else if(0 == flashData->jobSize)
+  {
+    extflash_finishJob(flashData, EXTFLASH_JOB_RESULT_eOK);
+  }
+  else if(STATUS_eOK != extflash_startEraseUnit(flashData))
+  {
+    extflash_finishJob(flashData, EXTFLASH_JOB_RESULT_eFAILED);
+  }
+  else
+  {
+    /* Next erase unit started */
+  }
+}
 
-  /* Get the flash configuration block */
-  if(0 != romApi->norFlashApi->getConfig(devID, &norCfg, &cfgOpt))
+
+/*
+ ******************************************************************************
+ * Function: extflash_suspend
+ ******************************************************************************
+ * @brief Suspend the running erase job for reading the flash
+ *
+ * @par Description:
+ *   Waits for the device to accept the suspend, which takes some
+ *   microseconds. Sectors not being erased may be read afterwards.
+ *
+ * @return STATUS_eOK if the job is suspended, STATUS_eNOK otherwise
+ *
+ ******************************************************************************
+ */
+
+__itcm_text T_STATUS extflash_suspend(void)
+{
+  T_EXTFLASH_DATA* flashData = extflash_dataTbl;
+  T_STATUS result = STATUS_eNOK;
+
+  if(EXTFLASH_STATUS_eBUSY != flashData->status)
+  {
+    /* No job running */
+  }
+  else if( (FALSE == flashData->jobIsErase) || (FALSE == flashData->suspendEna) )
+  {
+    /* Only erase jobs can be suspended */
+  }
+  else if(STATUS_eOK != flexspi_execCmd(0, EXTFLASH_LUT_SEQ_ERASE_SUSPEND))
   {
     /* Failed */
   }
-  /* Initialize the serial NOR device */
-  else if(0 != romApi->norFlashApi->init(devID, &norCfg))
+  else if(STATUS_eOK != extflash_waitReady(flashData))
   {
     /* Failed */
   }
-  /* Erase requested region */
-  else if(0 != romApi->norFlashApi->erase(devID, &norCfg, sectAddr, regionSize))
+  else
+  {
+    /* Prefetched data may be stale */
+    flexspi_clearAhbBuffers();
+    flashData->status = EXTFLASH_STATUS_eSUSPENDED;
+    result = STATUS_eOK;
+  }
+  return result;
+}
+
+
+/*
+ ******************************************************************************
+ * Function: extflash_resume
+ ******************************************************************************
+ * @brief Resume a suspended erase job
+ *
+ * @par Description:
+ *   A device, which completed the erase before the suspend, ignores the
+ *   resume and the job proceeds with its next unit.
+ *
+ * @return STATUS_eOK if the job is running again, STATUS_eNOK otherwise
+ *
+ ******************************************************************************
+ */
+
+__itcm_text T_STATUS extflash_resume(void)
+{
+  T_EXTFLASH_DATA* flashData = extflash_dataTbl;
+  T_STATUS result = STATUS_eNOK;
+
+  if(EXTFLASH_STATUS_eSUSPENDED != flashData->status)
+  {
+    /* No job suspended */
+  }
+  else if(STATUS_eOK != flexspi_execCmd(0, EXTFLASH_LUT_SEQ_ERASE_RESUME))
   {
     /* Failed */
   }
   else
   {
+    flashData->status = EXTFLASH_STATUS_eBUSY;
     result = STATUS_eOK;
   }
   return result;
 }
+
+
+/*
+ ******************************************************************************
+ * Function: extflash_getStatus
+ ******************************************************************************
+ * @brief Get the status of the job handling
+ *
+ ******************************************************************************
+ */
+
+T_EXTFLASH_STATUS extflash_getStatus(void)
+{
+  T_EXTFLASH_DATA* flashData = extflash_dataTbl;
+
+  return flashData->status;
+}
+
+
+/*
+ ******************************************************************************
+ * Function: extflash_getJobResult
+ ******************************************************************************
+ * @brief Get the result of the recent job
+ *
+ ******************************************************************************
+ */
+
+T_EXTFLASH_JOB_RESULT extflash_getJobResult(void)
+{
+  T_EXTFLASH_DATA* flashData = extflash_dataTbl;
+
+  return flashData->jobResult;
+}
+
+
+/*
+ ******************************************************************************
+ * Function: extflash_getPageSize
+ ******************************************************************************
+ * @brief Get the program unit of the device
+ *
+ * @return Page size in bytes, a power of two up to FLASH_PAGE_SIZE
+ *
+ ******************************************************************************
+ */
+
+uint32 extflash_getPageSize(void)
+{
+  T_EXTFLASH_DATA* flashData = extflash_dataTbl;
+  uint32 pageSize = FLASH_PAGE_SIZE;
+
+  if(STATUS_eOK == extflash_open())
+  {
+    pageSize = flashData->pageSize;
+  }
+  return pageSize;
+}
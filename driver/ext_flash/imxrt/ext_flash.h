@@ -2,9 +2,37 @@
 #define EXT_FLASH_H
 
 
+typedef enum EXTFLASH_STATUS
+{
+  EXTFLASH_STATUS_eIDLE = 0,
+  EXTFLASH_STATUS_eBUSY,
+  EXTFLASH_STATUS_eSUSPENDED,
+}T_EXTFLASH_STATUS;
+
+typedef enum EXTFLASH_JOB_RESULT
+{
+  EXTFLASH_JOB_RESULT_eOK = 0,
+  EXTFLASH_JOB_RESULT_eFAILED,
+  EXTFLASH_JOB_RESULT_ePENDING,
+}T_EXTFLASH_JOB_RESULT;
+
+
 extern void extflash_init(void);
-extern T_STATUS extflash_write(uint32 dstLogAddr, uint8 srcBuf[], sint32 numBytes);
+extern T_STATUS extflash_open(void);
+extern void extflash_close(void);
+extern T_STATUS extflash_read(uint32 logAddr, uint8 dstBuf[], uint32 numBytes);
+extern T_STATUS extflash_write(uint32 dstLogAddr, uint8 srcBuf[], uint32 numBytes);
 extern T_STATUS extflash_erase(uint32 logAddr, uint32 numBytes);
+extern boolean extflash_isBlank(uint32 logAddr, uint32 numBytes);
+extern uint32 extflash_getPageSize(void);
+
+extern T_STATUS extflash_startWrite(uint32 logAddr, const uint8 srcBuf[]);
+extern T_STATUS extflash_startErase(uint32 logAddr, uint32 numBytes);
+extern void extflash_run(void);
+extern T_STATUS extflash_suspend(void);
+extern T_STATUS extflash_resume(void);
+extern T_EXTFLASH_STATUS extflash_getStatus(void);
+extern T_EXTFLASH_JOB_RESULT extflash_getJobResult(void);
 
 typedef struct
 {
@@ -12,6 +40,15 @@ typedef struct
   uint32 sectSize;
 }T_SECTOR_INFO;
 
+typedef struct
+{
+  uint8 mfrID;        /* JEDEC manufacturer ID */
+  uint8 progCmd;      /* Quad page program command */
+  uint8 progAddrPads; /* Address pads of the page program, as of FLEXSPI_LUT_PADS_e* */
+  uint8 readCmd;      /* Quad I/O fast read command */
+  uint8 readDummy;    /* Dummy cycles of the fast read, including the mode bits */
+}T_EXTFLASH_QUAD_CFG;
+
 
 #include "ext_flash_cfg.h"
 
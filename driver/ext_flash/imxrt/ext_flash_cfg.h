@@ -7,10 +7,41 @@
 /* Define blank flash value */
 #define FLASH_BLANK_VALUE       (0xFFFFFFFFUL)
 
+/* Largest page size, smaller pages reported by SFDP are used instead */
 #define FLASH_PAGE_SIZE         (0x100)  /* 256 Byte */
 
 #define FLASH_ERASE_SECTOR_SIZE (0x1000) /* 4 KiB */
 
+/* Erase aligned regions by block erase commands, by default of 32 KiB and 64 KiB */
+#define FLASH_BLOCK_ERASE_ENA   STD_ON
+
+#define FLASH_ERASE_BLOCK32_SIZE (0x8000)  /* 32 KiB */
+#define FLASH_ERASE_BLOCK64_SIZE (0x10000) /* 64 KiB */
+
+/* Serial NOR block erase commands using 3 byte addresses */
+#define FLASH_CMD_ERASE_BLOCK32 0x52
+#define FLASH_CMD_ERASE_BLOCK64 0xD8
+
+/* Suspend a running erase job for reading */
+#define FLASH_ERASE_SUSPEND_ENA STD_ON
+
+/* Serial NOR erase suspend and resume commands */
+#define FLASH_CMD_ERASE_SUSPEND 0x75
+#define FLASH_CMD_ERASE_RESUME  0x7A
+
+/* Program and read by quad sequences selected by the JEDEC ID */
+#define FLASH_QUAD_LUT_ENA      STD_ON
+
+#define FLASH_CMD_READ_ID       0x9F
+
+/* Take page size, erase types and quad read from the SFDP tables */
+#define FLASH_SFDP_ENA          STD_ON
+
+#define FLASH_CMD_READ_SFDP     0x5A
+
+/* Start of the memory mapped FlexSPI window */
+#define FLASH_AHB_BASE_ADDR     (0x60000000)
+
 
 #if defined(EXT_FLASH_C)
 static const T_SECTOR_INFO flash_sectorMap[1] =
@@ -21,6 +52,26 @@ static const T_SECTOR_INFO flash_sectorMap[1] =
 	.sectSize = 0x00001000,
   },
 };
+
+#if (FLASH_QUAD_LUT_ENA == STD_ON)
+/*
+ * Quad sequences per manufacturer. The quad enable bit is expected to be
+ * set already, as the boot configuration block reads by quad I/O.
+ */
+static const T_EXTFLASH_QUAD_CFG extflash_quadCfgTbl[] =
+{
+  /* Winbond W25Q */
+  { 0xEF, 0x32, FLEXSPI_LUT_PADS_e1, 0xEB,  6 },
+  /* GigaDevice GD25Q */
+  { 0xC8, 0x32, FLEXSPI_LUT_PADS_e1, 0xEB,  6 },
+  /* ISSI IS25LP/WP */
+  { 0x9D, 0x32, FLEXSPI_LUT_PADS_e1, 0xEB,  6 },
+  /* Macronix MX25L, 4PP with quad address */
+  { 0xC2, 0x38, FLEXSPI_LUT_PADS_e4, 0xEB,  6 },
+  /* Micron MT25Q */
+  { 0x20, 0x32, FLEXSPI_LUT_PADS_e1, 0xEB, 10 },
+};
+#endif /* (FLASH_QUAD_LUT_ENA == STD_ON) */
 #else /* !defined(EXT_FLASH_C) */
 #endif /* (EXT_FLASH_C) */
 #endif /* EXT_FLASH_CFG_H */
\ No newline at end of file
@@ -0,0 +1,311 @@
+#ifndef FLEXSPI_IP_C
+#define FLEXSPI_IP_C
+#endif /* FLEXSPI_IP_C */
+
+
+#include "bsp.h"
+#include "reg.h"
+
+#include "libc.h"
+#include "cpu_tcm.h"
+
+#include "flexspi_ip.h"
+
+
+/*
+ * IP command access to the serial flash by the FlexSPI controller
+ *
+ * A command executes a LUT sequence at a serial flash address and moves
+ * optional data through the IP TX or RX FIFO with a watermark of a single
+ * FIFO unit. The registers are accessed relative to the base address
+ * passed to flexspi_init(), so the sequencing may run against a register
+ * model as well.
+ */
+
+/* Number of polls until the controller is considered hung */
+#define FLEXSPI_POLL_MAX 100000u
+
+/* Error flags of IP commands */
+#define FLEXSPI_INTR_IP_ERR_MASK ( BF_MASK(FLEXSPI_INTR_IPCMDERR_BF) \
+                                 | BF_MASK(FLEXSPI_INTR_IPCMDGE_BF)  \
+                                 | BF_MASK(FLEXSPI_INTR_SEQTIMEOUT_BF) )
+
+typedef struct
+{
+  uint32 regBase;
+}T_FLEXSPI_DATA;
+
+static T_FLEXSPI_DATA flexspi_dataTbl[1];
+
+
+/*
+ ******************************************************************************
+ * Function: flexspi_waitFlag
+ ******************************************************************************
+ * @brief Poll the interrupt register until one of the given flags is set
+ *
+ * @return STATUS_eOK if a flag was set, STATUS_eNOK on an error or timeout
+ *
+ ******************************************************************************
+ */
+
+__itcm_text static T_STATUS flexspi_waitFlag(T_FLEXSPI_DATA* flexspiData, uint32 flagMask)
+{
+  T_STATUS result = STATUS_eNOK;
+  uint32 pollCnt = FLEXSPI_POLL_MAX;
+  uint32 intr = 0;
+
+  while( (pollCnt > 0) && (0 == (intr & (flagMask | FLEXSPI_INTR_IP_ERR_MASK))) )
+  {
+    REG32_RD_BASE_OFFS(intr, flexspiData->regBase, FLEXSPI_INTR_OFFS);
+    pollCnt--;
+  }
+
+  if(0 != (intr & FLEXSPI_INTR_IP_ERR_MASK))
+  {
+    /* Command failed */
+  }
+  else if(0 == (intr & flagMask))
+  {
+    /* Timeout */
+  }
+  else
+  {
+    result = STATUS_eOK;
+  }
+  return result;
+}
+
+
+/*
+ ******************************************************************************
+ * Function: flexspi_startCmd
+ ******************************************************************************
+ * @brief Set up and trigger an IP command
+ *
+ ******************************************************************************
+ */
+
+__itcm_text static void flexspi_startCmd(T_FLEXSPI_DATA* flexspiData, uint32 logAddr, uint32 seqID, uint32 numBytes)
+{
+  uint32 base = flexspiData->regBase;
+
+  /* Clear the flags of a previous command */
+  REG32_WR_BASE_OFFS( BF_MASK(FLEXSPI_INTR_IPCMDDONE_BF)
+                    | BF_MASK(FLEXSPI_INTR_IPRXWA_BF)
+                    | FLEXSPI_INTR_IP_ERR_MASK, base, FLEXSPI_INTR_OFFS);
+
+  /* Flush both FIFOs and set the watermarks to a single FIFO unit */
+  REG32_WR_BASE_OFFS(BF_SET(1, FLEXSPI_IPTXFCR_CLRIPTXF_BF), base, FLEXSPI_IPTXFCR_OFFS);
+  REG32_WR_BASE_OFFS(BF_SET(1, FLEXSPI_IPRXFCR_CLRIPRXF_BF), base, FLEXSPI_IPRXFCR_OFFS);
+
+  REG32_WR_BASE_OFFS(logAddr, base, FLEXSPI_IPCR0_OFFS);
+  REG32_WR_BASE_OFFS( BF_SET(seqID, FLEXSPI_IPCR1_ISEQID_BF)
+                    | BF_SET(numBytes, FLEXSPI_IPCR1_IDATSZ_BF), base, FLEXSPI_IPCR1_OFFS);
+
+  REG32_WR_BASE_OFFS(BF_SET(1, FLEXSPI_IPCMD_TRG_BF), base, FLEXSPI_IPCMD_OFFS);
+}
+
+
+/*
+ ******************************************************************************
+ * Function: flexspi_init
+ ******************************************************************************
+ * @brief Set the FlexSPI controller used for IP commands
+ *
+ * @param [in] regBase - Base address of the FlexSPI registers
+ *
+ ******************************************************************************
+ */
+
+void flexspi_init(uint32 regBase)
+{
+  T_FLEXSPI_DATA* flexspiData = flexspi_dataTbl;
+
+  flexspiData->regBase = regBase;
+}
+
+
+/*
+ ******************************************************************************
+ * Function: flexspi_execCmd
+ ******************************************************************************
+ * @brief Execute a LUT sequence without data
+ *
+ * @param [in] logAddr - Serial flash address
+ * @param [in] seqID   - Index of the LUT sequence
+ *
+ * @return STATUS_eOK when the command is done, STATUS_eNOK otherwise
+ *
+ ******************************************************************************
+ */
+
+__itcm_text T_STATUS flexspi_execCmd(uint32 logAddr, uint32 seqID)
+{
+  T_FLEXSPI_DATA* flexspiData = flexspi_dataTbl;
+
+  flexspi_startCmd(flexspiData, logAddr, seqID, 0);
+  return flexspi_waitFlag(flexspiData, BF_MASK(FLEXSPI_INTR_IPCMDDONE_BF));
+}
+
+
+/*
+ ******************************************************************************
+ * Function: flexspi_writeData
+ ******************************************************************************
+ * @brief Execute a LUT sequence sending data by the IP TX FIFO
+ *
+ * @par Description:
+ *   The data is pushed by FIFO units, whenever the watermark flag signals
+ *   free space. The last unit is padded by zeros.
+ *
+ * @param [in] logAddr  - Serial flash address
+ * @param [in] seqID    - Index of the LUT sequence
+ * @param [in] srcBuf   - Data to be sent, no alignment required
+ * @param [in] numBytes - Number of bytes to send
+ *
+ * @return STATUS_eOK when the command is done, STATUS_eNOK otherwise
+ *
+ ******************************************************************************
+ */
+
+__itcm_text T_STATUS flexspi_writeData(uint32 logAddr, uint32 seqID, const uint8 srcBuf[], uint32 numBytes)
+{
+  T_FLEXSPI_DATA* flexspiData = flexspi_dataTbl;
+  uint32 base = flexspiData->regBase;
+  T_STATUS result = STATUS_eOK;
+  uint32 unit[FLEXSPI_FIFO_WMRK_UNIT / sizeof(uint32)];
+  uint32 bytesSent = 0;
+  uint32 unitSize;
+  uint32 wordIdx;
+
+  flexspi_startCmd(flexspiData, logAddr, seqID, numBytes);
+
+  while( (bytesSent < numBytes) && (STATUS_eOK == result) )
+  {
+    unitSize = numBytes - bytesSent;
+    if(unitSize > FLEXSPI_FIFO_WMRK_UNIT)
+    {
+      unitSize = FLEXSPI_FIFO_WMRK_UNIT;
+    }
+
+    /* Wait for free space in the TX FIFO */
+    result = flexspi_waitFlag(flexspiData, BF_MASK(FLEXSPI_INTR_IPTXWE_BF));
+    if(STATUS_eOK == result)
+    {
+      libc_memset(unit, 0, sizeof(unit));
+      libc_memcpy(unit, &srcBuf[bytesSent], unitSize);
+      for(wordIdx = 0; wordIdx < (FLEXSPI_FIFO_WMRK_UNIT / sizeof(uint32)); wordIdx++)
+      {
+        REG32_WR_BASE_OFFS(unit[wordIdx], base, FLEXSPI_TFDR_OFFS + (wordIdx * sizeof(uint32)));
+      }
+
+      /* Push the unit into the FIFO */
+      REG32_WR_BASE_OFFS(BF_MASK(FLEXSPI_INTR_IPTXWE_BF), base, FLEXSPI_INTR_OFFS);
+      bytesSent += unitSize;
+    }
+  }
+
+  if(STATUS_eOK == result)
+  {
+    result = flexspi_waitFlag(flexspiData, BF_MASK(FLEXSPI_INTR_IPCMDDONE_BF));
+  }
+  return result;
+}
+
+
+/*
+ ******************************************************************************
+ * Function: flexspi_readData
+ ******************************************************************************
+ * @brief Execute a LUT sequence receiving data by the IP RX FIFO
+ *
+ * @par Description:
+ *   Full FIFO units are popped, whenever the watermark flag signals them
+ *   available. A remainder shorter than a unit is read once the command
+ *   is done.
+ *
+ * @param [in]  logAddr  - Serial flash address
+ * @param [in]  seqID    - Index of the LUT sequence
+ * @param [out] dstBuf   - Buffer receiving the data, no alignment required
+ * @param [in]  numBytes - Number of bytes to receive
+ *
+ * @return STATUS_eOK when the command is done, STATUS_eNOK otherwise
+ *
+ ******************************************************************************
+ */
+
+__itcm_text T_STATUS flexspi_readData(uint32 logAddr, uint32 seqID, uint8 dstBuf[], uint32 numBytes)
+{
+  T_FLEXSPI_DATA* flexspiData = flexspi_dataTbl;
+  uint32 base = flexspiData->regBase;
+  T_STATUS result = STATUS_eOK;
+  uint32 unit[FLEXSPI_FIFO_WMRK_UNIT / sizeof(uint32)];
+  uint32 bytesRecv = 0;
+  uint32 wordIdx;
+
+  flexspi_startCmd(flexspiData, logAddr, seqID, numBytes);
+
+  while( ((numBytes - bytesRecv) >= FLEXSPI_FIFO_WMRK_UNIT) && (STATUS_eOK == result) )
+  {
+    /* Wait for a unit in the RX FIFO */
+    result = flexspi_waitFlag(flexspiData, BF_MASK(FLEXSPI_INTR_IPRXWA_BF));
+    if(STATUS_eOK == result)
+    {
+      for(wordIdx = 0; wordIdx < (FLEXSPI_FIFO_WMRK_UNIT / sizeof(uint32)); wordIdx++)
+      {
+        REG32_RD_BASE_OFFS(unit[wordIdx], base, FLEXSPI_RFDR_OFFS + (wordIdx * sizeof(uint32)));
+      }
+      libc_memcpy(&dstBuf[bytesRecv], unit, FLEXSPI_FIFO_WMRK_UNIT);
+
+      /* Pop the unit from the FIFO */
+      REG32_WR_BASE_OFFS(BF_MASK(FLEXSPI_INTR_IPRXWA_BF), base, FLEXSPI_INTR_OFFS);
+      bytesRecv += FLEXSPI_FIFO_WMRK_UNIT;
+    }
+  }
+
+  if(STATUS_eOK == result)
+  {
+    result = flexspi_waitFlag(flexspiData, BF_MASK(FLEXSPI_INTR_IPCMDDONE_BF));
+  }
+
+  if( (STATUS_eOK == result) && (bytesRecv < numBytes) )
+  {
+    /* Remainder below the watermark */
+    for(wordIdx = 0; wordIdx < (FLEXSPI_FIFO_WMRK_UNIT / sizeof(uint32)); wordIdx++)
+    {
+      REG32_RD_BASE_OFFS(unit[wordIdx], base, FLEXSPI_RFDR_OFFS + (wordIdx * sizeof(uint32)));
+    }
+    libc_memcpy(&dstBuf[bytesRecv], unit, numBytes - bytesRecv);
+  }
+  return result;
+}
+
+
+/*
+ ******************************************************************************
+ * Function: flexspi_clearAhbBuffers
+ ******************************************************************************
+ * @brief Drop the data prefetched into the AHB RX buffers
+ *
+ * @par Description:
+ *   A software reset of the controller flushes the AHB buffers and keeps
+ *   the configuration registers and the LUT.
+ *
+ ******************************************************************************
+ */
+
+__itcm_text void flexspi_clearAhbBuffers(void)
+{
+  T_FLEXSPI_DATA* flexspiData = flexspi_dataTbl;
+  uint32 base = flexspiData->regBase;
+  uint32 pollCnt = FLEXSPI_POLL_MAX;
+  uint32 mcr0;
+
+  REG32_SETBF_BASE_OFFS(1, base, FLEXSPI_MCR0_OFFS, FLEXSPI_MCR0_SWRESET_BF);
+  do
+  {
+    REG32_RD_BASE_OFFS(mcr0, base, FLEXSPI_MCR0_OFFS);
+    pollCnt--;
+  }while( (pollCnt > 0) && (0 != BF_GET(mcr0, FLEXSPI_MCR0_SWRESET_BF)) );
+}
@@ -0,0 +1,11 @@
+#ifndef FLEXSPI_IP_H
+#define FLEXSPI_IP_H
+
+
+extern void flexspi_init(uint32 regBase);
+extern T_STATUS flexspi_execCmd(uint32 logAddr, uint32 seqID);
+extern T_STATUS flexspi_writeData(uint32 logAddr, uint32 seqID, const uint8 srcBuf[], uint32 numBytes);
+extern T_STATUS flexspi_readData(uint32 logAddr, uint32 seqID, uint8 dstBuf[], uint32 numBytes);
+extern void flexspi_clearAhbBuffers(void);
+
+#endif /* FLEXSPI_IP_H */
@@ -0,0 +1,17 @@
+#ifndef BSP_TEST_H
+#define BSP_TEST_H
+
+/*
+ * The host build has no SoC headers, so the FlexSPI definitions used by
+ * ext_flash.c are added to the generic platform here.
+ */
+
+#include "../../../../common/bsp.h"
+
+#include "reg.h"
+#include "imxrt_flexspi.h"
+
+/* Register base, not accessed by the NOR model */
+#define FLEXSPI_BASE 0x402A8000
+
+#endif /* BSP_TEST_H */
@@ -0,0 +1,731 @@
+#ifndef EXT_FLASH_TEST_C
+#define EXT_FLASH_TEST_C
+#endif /* EXT_FLASH_TEST_C */
+
+#include "bsp.h"
+#include "libc.h"
+#include "rom_api.h"
+#include "cpu_cache.h"
+#include "flexspi_ip.h"
+#include "ext_flash.h"
+
+#include <stdio.h>
+#include <string.h>
+
+
+/*
+ * Host test of the flash job handling
+ *
+ * The FlexSPI IP commands are served by a model of a serial NOR device.
+ * It executes the LUT sequences installed by the ROM and by ext_flash.c
+ * on a memory array. Like a real device, it ignores program and erase
+ * commands not preceded by a write enable and stays busy for a number
+ * of status reads after each of them. Every issued sequence is logged,
+ * so the tests check the command order seen by the device.
+ *
+ * The ROM API provides the NOR configuration and accepts LUT updates.
+ * The device has no SFDP tables and an unknown JEDEC ID, so the
+ * configured page size and erase units apply.
+ */
+
+#define TEST_FLASH_SIZE   0x40000u
+#define TEST_LOG_SIZE     64u
+
+/* LUT sequences, as used by ext_flash.c */
+#define TEST_SEQ_READ_STATUS    1
+#define TEST_SEQ_WRITE_ENABLE   3
+#define TEST_SEQ_ERASE_SECTOR   5
+#define TEST_SEQ_ERASE_BLOCK32  6
+#define TEST_SEQ_ERASE_BLOCK64  7
+#define TEST_SEQ_PAGE_PROGRAM   9
+#define TEST_SEQ_ERASE_SUSPEND  10
+#define TEST_SEQ_ERASE_RESUME   12
+
+/* Status reads until the device is ready again */
+#define TEST_BUSY_PROGRAM  1u
+#define TEST_BUSY_SECTOR   2u
+#define TEST_BUSY_BLOCK32  3u
+#define TEST_BUSY_BLOCK64  4u
+#define TEST_BUSY_SUSPEND  1u
+
+#define TEST_CHECK(cond)                                                  \
+  do                                                                      \
+  {                                                                       \
+    if(!(cond))                                                           \
+    {                                                                     \
+      printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond);     \
+      test_numFailed++;                                                   \
+    }                                                                     \
+  }while(0)
+
+typedef struct
+{
+  uint32 seqID;
+  uint32 logAddr;
+}T_TEST_CMD;
+
+typedef struct
+{
+  uint8  mem[TEST_FLASH_SIZE];
+  boolean writeEna;     /* Write enable latch */
+  boolean eraseSusp;    /* Erase suspended */
+  uint32 busyCnt;       /* Status reads left until ready */
+  uint32 suspBusyCnt;   /* Status reads of the suspended erase */
+  uint32 failSeqID;     /* Sequence failing at the controller, 0 if none */
+  uint32 numViolations; /* Commands ignored by the device */
+  uint32 numAhbClears;
+  uint32 numCmds;
+  T_TEST_CMD log[TEST_LOG_SIZE];
+}T_TEST_NOR;
+
+static T_TEST_NOR test_nor;
+static uint32 test_numFailed;
+
+
+/*
+ ******************************************************************************
+ * test_logCmd
+ ******************************************************************************
+ * Description:
+ *   The function logs a sequence issued to the device.
+ *
+ ******************************************************************************
+ */
+
+static void test_logCmd(uint32 logAddr, uint32 seqID)
+{
+  if(test_nor.numCmds < TEST_LOG_SIZE)
+  {
+    test_nor.log[test_nor.numCmds].seqID = seqID;
+    test_nor.log[test_nor.numCmds].logAddr = logAddr;
+  }
+  test_nor.numCmds++;
+}
+
+
+/*
+ ******************************************************************************
+ * test_eraseUnit
+ ******************************************************************************
+ * Description:
+ *   The function erases an aligned unit of the memory array, if the write
+ *   enable latch is set and the device is ready.
+ *
+ ******************************************************************************
+ */
+
+static void test_eraseUnit(uint32 logAddr, uint32 unitSize, uint32 busyCnt)
+{
+  if( (FALSE == test_nor.writeEna) || (0 != test_nor.busyCnt)
+   || (0 != (logAddr & (unitSize - 1))) || ((logAddr + unitSize) > TEST_FLASH_SIZE) )
+  {
+    test_nor.numViolations++;
+  }
+  else
+  {
+    libc_memset(&test_nor.mem[logAddr], 0xFF, unitSize);
+    test_nor.busyCnt = busyCnt;
+  }
+  test_nor.writeEna = FALSE;
+}
+
+
+/*
+ ******************************************************************************
+ * flexspi_init
+ ******************************************************************************
+ */
+
+void flexspi_init(uint32 regBase)
+{
+  (void)regBase;
+}
+
+
+/*
+ ******************************************************************************
+ * flexspi_execCmd
+ ******************************************************************************
+ * Description:
+ *   The model executes the commands without data.
+ *
+ ******************************************************************************
+ */
+
+T_STATUS flexspi_execCmd(uint32 logAddr, uint32 seqID)
+{
+  T_STATUS result = STATUS_eOK;
+
+  test_logCmd(logAddr, seqID);
+
+  if(seqID == test_nor.failSeqID)
+  {
+    result = STATUS_eNOK;
+  }
+  else if(TEST_SEQ_WRITE_ENABLE == seqID)
+  {
+    test_nor.writeEna = (0 == test_nor.busyCnt);
+  }
+  else if(TEST_SEQ_ERASE_SECTOR == seqID)
+  {
+    test_eraseUnit(logAddr, 0x1000, TEST_BUSY_SECTOR);
+  }
+  else if(TEST_SEQ_ERASE_BLOCK32 == seqID)
+  {
+    test_eraseUnit(logAddr, 0x8000, TEST_BUSY_BLOCK32);
+  }
+  else if(TEST_SEQ_ERASE_BLOCK64 == seqID)
+  {
+    test_eraseUnit(logAddr, 0x10000, TEST_BUSY_BLOCK64);
+  }
+  else if(TEST_SEQ_ERASE_SUSPEND == seqID)
+  {
+    /* The suspend is accepted after a short busy time */
+    if( (0 != test_nor.busyCnt) && (FALSE == test_nor.eraseSusp) )
+    {
+      test_nor.suspBusyCnt = test_nor.busyCnt;
+      test_nor.busyCnt = TEST_BUSY_SUSPEND;
+      test_nor.eraseSusp = !FALSE;
+    }
+  }
+  else if(TEST_SEQ_ERASE_RESUME == seqID)
+  {
+    if(FALSE != test_nor.eraseSusp)
+    {
+      test_nor.busyCnt = test_nor.suspBusyCnt;
+      test_nor.eraseSusp = FALSE;
+    }
+  }
+  else
+  {
+    test_nor.numViolations++;
+  }
+  return result;
+}
+
+
+/*
+ ******************************************************************************
+ * flexspi_writeData
+ ******************************************************************************
+ * Description:
+ *   The model programs a page, clearing bits only.
+ *
+ ******************************************************************************
+ */
+
+T_STATUS flexspi_writeData(uint32 logAddr, uint32 seqID, const uint8 srcBuf[], uint32 numBytes)
+{
+  T_STATUS result = STATUS_eOK;
+  uint32 idx;
+
+  test_logCmd(logAddr, seqID);
+
+  if(seqID == test_nor.failSeqID)
+  {
+    result = STATUS_eNOK;
+  }
+  else if( (TEST_SEQ_PAGE_PROGRAM != seqID) || (FALSE == test_nor.writeEna)
+        || (numBytes > FLASH_PAGE_SIZE) || ((logAddr + numBytes) > TEST_FLASH_SIZE) )
+  {
+    test_nor.numViolations++;
+  }
+  else
+  {
+    for(idx = 0; idx < numBytes; idx++)
+    {
+      test_nor.mem[logAddr + idx] &= srcBuf[idx];
+    }
+    test_nor.busyCnt = TEST_BUSY_PROGRAM;
+  }
+  test_nor.writeEna = FALSE;
+  return result;
+}
+
+
+/*
+ ******************************************************************************
+ * flexspi_readData
+ ******************************************************************************
+ * Description:
+ *   The model provides the status register. SFDP and ID reads return a
+ *   blank bus.
+ *
+ ******************************************************************************
+ */
+
+T_STATUS flexspi_readData(uint32 logAddr, uint32 seqID, uint8 dstBuf[], uint32 numBytes)
+{
+  T_STATUS result = STATUS_eOK;
+
+  test_logCmd(logAddr, seqID);
+
+  libc_memset(dstBuf, 0xFF, numBytes);
+  if(seqID == test_nor.failSeqID)
+  {
+    result = STATUS_eNOK;
+  }
+  else if(TEST_SEQ_READ_STATUS == seqID)
+  {
+    /* Busy bit 0 and the write enable latch bit 1 */
+    dstBuf[0] = ((0 != test_nor.busyCnt) ? 0x01 : 0x00) | ((FALSE != test_nor.writeEna) ? 0x02 : 0x00);
+    if(0 != test_nor.busyCnt)
+    {
+      test_nor.busyCnt--;
+    }
+  }
+  else
+  {
+    /* Nothing driven */
+  }
+  return result;
+}
+
+
+/*
+ ******************************************************************************
+ * flexspi_clearAhbBuffers
+ ******************************************************************************
+ */
+
+void flexspi_clearAhbBuffers(void)
+{
+  test_nor.numAhbClears++;
+}
+
+
+/*
+ ******************************************************************************
+ * cpu_invalidateDCacheRange
+ ******************************************************************************
+ */
+
+void cpu_invalidateDCacheRange(uint32 addr, uint32 len)
+{
+  (void)addr;
+  (void)len;
+}
+
+
+/*
+ ******************************************************************************
+ * ROM API
+ ******************************************************************************
+ * Description:
+ *   Only the functions used for opening the session are provided.
+ *
+ ******************************************************************************
+ */
+
+static int test_romGetConfig(uint32 devID, T_FLEXSPI_NOR_CFG* devCfg, T_SER_NOR_ONFIG_OPTION* option)
+{
+  (void)devID;
+  (void)option;
+  libc_memset(devCfg, 0, sizeof(*devCfg));
+  devCfg->memCfg.sflashA1Size = 0x200000;
+  devCfg->memCfg.busyOffset = 0;
+  devCfg->memCfg.busyBitPolarity = 0;
+  devCfg->pageSize = FLASH_PAGE_SIZE;
+  devCfg->sectorSize = FLASH_ERASE_SECTOR_SIZE;
+  return 0;
+}
+
+static int test_romInit(uint32 devID, T_FLEXSPI_NOR_CFG* devCfg)
+{
+  (void)devID;
+  (void)devCfg;
+  return 0;
+}
+
+static int test_romUpdateLut(uint32 devID, uint32 seqIdx, const uint32* lutBase, uint32 seqNum)
+{
+  (void)devID;
+  (void)seqIdx;
+  (void)lutBase;
+  (void)seqNum;
+  return 0;
+}
+
+static const T_NORFLASH_API test_norFlashApi =
+{
+  .init = test_romInit,
+  .updateLut = test_romUpdateLut,
+  .getConfig = test_romGetConfig,
+};
+
+static T_ROM_API test_romApi =
+{
+  .norFlashApi = &test_norFlashApi,
+};
+
+T_ROM_API* romApi_getAddr(void)
+{
+  return &test_romApi;
+}
+
+
+/*
+ ******************************************************************************
+ * test_reset
+ ******************************************************************************
+ * Description:
+ *   The function opens the session and clears the device's memory and log.
+ *
+ ******************************************************************************
+ */
+
+static void test_reset(void)
+{
+  TEST_CHECK(STATUS_eOK == extflash_open());
+
+  libc_memset(test_nor.mem, 0x00, sizeof(test_nor.mem));
+  test_nor.writeEna = FALSE;
+  test_nor.eraseSusp = FALSE;
+  test_nor.busyCnt = 0;
+  test_nor.failSeqID = 0;
+  test_nor.numViolations = 0;
+  test_nor.numAhbClears = 0;
+  test_nor.numCmds = 0;
+}
+
+
+/*
+ ******************************************************************************
+ * test_checkLog
+ ******************************************************************************
+ * Description:
+ *   The function checks the logged sequences from the given position on
+ *   against the expected ones, skipping status reads. It returns the
+ *   position behind the last expected sequence.
+ *
+ ******************************************************************************
+ */
+
+static uint32 test_checkLog(uint32 logPos, const T_TEST_CMD expCmds[], uint32 numExp)
+{
+  uint32 expIdx;
+
+  for(expIdx = 0; expIdx < numExp; expIdx++)
+  {
+    while( (logPos < test_nor.numCmds) && (TEST_SEQ_READ_STATUS == test_nor.log[logPos].seqID) )
+    {
+      logPos++;
+    }
+    TEST_CHECK(logPos < test_nor.numCmds);
+    TEST_CHECK(expCmds[expIdx].seqID == test_nor.log[logPos].seqID);
+    TEST_CHECK(expCmds[expIdx].logAddr == test_nor.log[logPos].logAddr);
+    logPos++;
+  }
+  return logPos;
+}
+
+
+/*
+ ******************************************************************************
+ * test_runJob
+ ******************************************************************************
+ * Description:
+ *   The function polls the job until done and returns the number of polls.
+ *
+ ******************************************************************************
+ */
+
+static uint32 test_runJob(void)
+{
+  uint32 numPolls = 0;
+
+  while( (EXTFLASH_STATUS_eBUSY == extflash_getStatus()) && (numPolls < 100) )
+  {
+    extflash_run();
+    numPolls++;
+  }
+  return numPolls;
+}
+
+
+/*
+ ******************************************************************************
+ * test_isErased
+ ******************************************************************************
+ */
+
+static boolean test_isErased(uint32 logAddr, uint32 numBytes, uint8 value)
+{
+  boolean isErased = !FALSE;
+
+  while(numBytes > 0)
+  {
+    if(value != test_nor.mem[logAddr])
+    {
+      isErased = FALSE;
+    }
+    logAddr++;
+    numBytes--;
+  }
+  return isErased;
+}
+
+
+/*
+ ******************************************************************************
+ * test_eraseSector
+ ******************************************************************************
+ * Description:
+ *   A sector is erased by write enable and the erase command. The job
+ *   reads the status once per poll and finishes with the device ready.
+ *
+ ******************************************************************************
+ */
+
+static void test_eraseSector(void)
+{
+  static const T_TEST_CMD expCmds[] =
+  {
+    { TEST_SEQ_WRITE_ENABLE, 0x1000 },
+    { TEST_SEQ_ERASE_SECTOR, 0x1000 },
+  };
+  uint32 logPos;
+  uint32 idx;
+
+  test_reset();
+
+  TEST_CHECK(STATUS_eOK == extflash_startErase(0x1234, 0x10));
+  TEST_CHECK(EXTFLASH_STATUS_eBUSY == extflash_getStatus());
+  TEST_CHECK(EXTFLASH_JOB_RESULT_ePENDING == extflash_getJobResult());
+  logPos = test_checkLog(0, expCmds, 2);
+  TEST_CHECK(2 == logPos);
+
+  /* Busy for the erase time, ready on the next status read */
+  TEST_CHECK((TEST_BUSY_SECTOR + 1) == test_runJob());
+  TEST_CHECK(EXTFLASH_STATUS_eIDLE == extflash_getStatus());
+  TEST_CHECK(EXTFLASH_JOB_RESULT_eOK == extflash_getJobResult());
+  for(idx = logPos; idx < test_nor.numCmds; idx++)
+  {
+    TEST_CHECK(TEST_SEQ_READ_STATUS == test_nor.log[idx].seqID);
+  }
+  TEST_CHECK((logPos + TEST_BUSY_SECTOR + 1) == test_nor.numCmds);
+
+  TEST_CHECK(test_isErased(0x1000, 0x1000, 0xFF));
+  TEST_CHECK(test_isErased(0x0000, 0x1000, 0x00));
+  TEST_CHECK(test_isErased(0x2000, 0x1000, 0x00));
+  TEST_CHECK(0 != test_nor.numAhbClears);
+  TEST_CHECK(0 == test_nor.numViolations);
+
+  /* Polling without a job doesn't access the device */
+  extflash_run();
+  TEST_CHECK((logPos + TEST_BUSY_SECTOR + 1) == test_nor.numCmds);
+}
+
+
+/*
+ ******************************************************************************
+ * test_eraseUnits
+ ******************************************************************************
+ * Description:
+ *   A region is erased by the largest aligned units. Each unit is issued
+ *   only after the previous one is done.
+ *
+ ******************************************************************************
+ */
+
+static void test_eraseUnits(void)
+{
+  static const T_TEST_CMD expCmds[] =
+  {
+    { TEST_SEQ_WRITE_ENABLE,  0x07000 },
+    { TEST_SEQ_ERASE_SECTOR,  0x07000 },
+    { TEST_SEQ_WRITE_ENABLE,  0x08000 },
+    { TEST_SEQ_ERASE_BLOCK32, 0x08000 },
+    { TEST_SEQ_WRITE_ENABLE,  0x10000 },
+    { TEST_SEQ_ERASE_BLOCK64, 0x10000 },
+    { TEST_SEQ_WRITE_ENABLE,  0x20000 },
+    { TEST_SEQ_ERASE_SECTOR,  0x20000 },
+  };
+  uint32 logPos;
+
+  test_reset();
+
+  TEST_CHECK(STATUS_eOK == extflash_startErase(0x7000, 0x1A000));
+  TEST_CHECK( (TEST_BUSY_SECTOR + TEST_BUSY_BLOCK32 + TEST_BUSY_BLOCK64 + TEST_BUSY_SECTOR + 4)
+           == test_runJob() );
+  TEST_CHECK(EXTFLASH_JOB_RESULT_eOK == extflash_getJobResult());
+  logPos = test_checkLog(0, expCmds, sizeof(expCmds) / sizeof(expCmds[0]));
+  TEST_CHECK((logPos + TEST_BUSY_SECTOR + 1) == test_nor.numCmds);
+
+  TEST_CHECK(test_isErased(0x07000, 0x1A000, 0xFF));
+  TEST_CHECK(test_isErased(0x06000, 0x1000, 0x00));
+  TEST_CHECK(test_isErased(0x21000, 0x1000, 0x00));
+  TEST_CHECK(0 == test_nor.numViolations);
+}
+
+
+/*
+ ******************************************************************************
+ * test_suspend
+ ******************************************************************************
+ * Description:
+ *   A suspended erase waits for the device to accept the suspend and is
+ *   left alone until resumed. The resumed erase completes.
+ *
+ ******************************************************************************
+ */
+
+static void test_suspend(void)
+{
+  static const T_TEST_CMD expCmds[] =
+  {
+    { TEST_SEQ_WRITE_ENABLE,  0x10000 },
+    { TEST_SEQ_ERASE_BLOCK64, 0x10000 },
+    { TEST_SEQ_ERASE_SUSPEND, 0 },
+  };
+  static const T_TEST_CMD resumeCmd = { TEST_SEQ_ERASE_RESUME, 0 };
+  uint8 page[FLASH_PAGE_SIZE];
+  uint32 logPos;
+  uint32 numCmds;
+
+  test_reset();
+  libc_memset(page, 0x5A, sizeof(page));
+
+  TEST_CHECK(STATUS_eOK == extflash_startErase(0x10000, 0x10000));
+  extflash_run();
+  TEST_CHECK(EXTFLASH_STATUS_eBUSY == extflash_getStatus());
+
+  TEST_CHECK(STATUS_eOK == extflash_suspend());
+  TEST_CHECK(EXTFLASH_STATUS_eSUSPENDED == extflash_getStatus());
+  logPos = test_checkLog(0, expCmds, sizeof(expCmds) / sizeof(expCmds[0]));
+
+  /* Returned once the status read the device ready */
+  TEST_CHECK((logPos + TEST_BUSY_SUSPEND + 1) == test_nor.numCmds);
+  TEST_CHECK(TEST_SEQ_READ_STATUS == test_nor.log[test_nor.numCmds - 1].seqID);
+  TEST_CHECK(FALSE != test_nor.eraseSusp);
+
+  /* Neither polled nor replaced by another job while suspended */
+  numCmds = test_nor.numCmds;
+  extflash_run();
+  TEST_CHECK(STATUS_eOK != extflash_startWrite(0x0000, page));
+  TEST_CHECK(STATUS_eOK != extflash_startErase(0x0000, 0x1000));
+  TEST_CHECK(STATUS_eOK != extflash_suspend());
+  TEST_CHECK(numCmds == test_nor.numCmds);
+
+  TEST_CHECK(STATUS_eOK == extflash_resume());
+  TEST_CHECK(EXTFLASH_STATUS_eBUSY == extflash_getStatus());
+  TEST_CHECK((numCmds + 1) == test_checkLog(numCmds, &resumeCmd, 1));
+  TEST_CHECK(FALSE == test_nor.eraseSusp);
+  TEST_CHECK(STATUS_eOK != extflash_resume());
+
+  TEST_CHECK(0 != test_runJob());
+  TEST_CHECK(EXTFLASH_JOB_RESULT_eOK == extflash_getJobResult());
+  TEST_CHECK(test_isErased(0x10000, 0x10000, 0xFF));
+  TEST_CHECK(0 == test_nor.numViolations);
+}
+
+
+/*
+ ******************************************************************************
+ * test_writePage
+ ******************************************************************************
+ * Description:
+ *   A page is programmed by write enable and the program sequence. Page
+ *   program jobs can't be suspended.
+ *
+ ******************************************************************************
+ */
+
+static void test_writePage(void)
+{
+  static const T_TEST_CMD expCmds[] =
+  {
+    { TEST_SEQ_WRITE_ENABLE, 0x2100 },
+    { TEST_SEQ_PAGE_PROGRAM, 0x2100 },
+  };
+  uint8 page[FLASH_PAGE_SIZE];
+  uint32 idx;
+
+  test_reset();
+  libc_memset(&test_nor.mem[0x2000], 0xFF, 0x1000);
+  for(idx = 0; idx < sizeof(page); idx++)
+  {
+    page[idx] = (uint8)idx;
+  }
+
+  TEST_CHECK(FLASH_PAGE_SIZE == extflash_getPageSize());
+  TEST_CHECK(STATUS_eOK != extflash_startWrite(0x2180, page));
+  TEST_CHECK(0 == test_nor.numCmds);
+
+  TEST_CHECK(STATUS_eOK == extflash_startWrite(0x2100, page));
+  TEST_CHECK(2 == test_checkLog(0, expCmds, 2));
+  TEST_CHECK(STATUS_eOK != extflash_suspend());
+  TEST_CHECK(EXTFLASH_STATUS_eBUSY == extflash_getStatus());
+
+  TEST_CHECK((TEST_BUSY_PROGRAM + 1) == test_runJob());
+  TEST_CHECK(EXTFLASH_JOB_RESULT_eOK == extflash_getJobResult());
+  TEST_CHECK(0 == memcmp(&test_nor.mem[0x2100], page, sizeof(page)));
+  TEST_CHECK(test_isErased(0x2000, 0x100, 0xFF));
+  TEST_CHECK(test_isErased(0x2200, 0x100, 0xFF));
+  TEST_CHECK(0 == test_nor.numViolations);
+}
+
+
+/*
+ ******************************************************************************
+ * test_failure
+ ******************************************************************************
+ * Description:
+ *   A failing command ends the job as failed and leaves the device to the
+ *   next job.
+ *
+ ******************************************************************************
+ */
+
+static void test_failure(void)
+{
+  test_reset();
+
+  /* The first unit fails to start */
+  test_nor.failSeqID = TEST_SEQ_ERASE_SECTOR;
+  TEST_CHECK(STATUS_eOK != extflash_startErase(0x3000, 0x1000));
+  TEST_CHECK(EXTFLASH_STATUS_eIDLE == extflash_getStatus());
+  TEST_CHECK(EXTFLASH_JOB_RESULT_eFAILED == extflash_getJobResult());
+
+  /* A following unit fails to start */
+  TEST_CHECK(STATUS_eOK == extflash_startErase(0x0000, 0x10000 + 0x1000));
+  TEST_CHECK(0 != test_runJob());
+  TEST_CHECK(EXTFLASH_STATUS_eIDLE == extflash_getStatus());
+  TEST_CHECK(EXTFLASH_JOB_RESULT_eFAILED == extflash_getJobResult());
+
+  /* The status can't be read */
+  test_nor.failSeqID = TEST_SEQ_READ_STATUS;
+  TEST_CHECK(STATUS_eOK == extflash_startErase(0x4000, 0x1000));
+  TEST_CHECK(1 == test_runJob());
+  TEST_CHECK(EXTFLASH_JOB_RESULT_eFAILED == extflash_getJobResult());
+
+  test_nor.failSeqID = 0;
+  while(0 != test_nor.busyCnt)
+  {
+    test_nor.busyCnt--;
+  }
+  TEST_CHECK(STATUS_eOK == extflash_startErase(0x4000, 0x1000));
+  TEST_CHECK(0 != test_runJob());
+  TEST_CHECK(EXTFLASH_JOB_RESULT_eOK == extflash_getJobResult());
+  TEST_CHECK(test_isErased(0x4000, 0x1000, 0xFF));
+}
+
+
+int main(void)
+{
+  test_eraseSector();
+  test_eraseUnits();
+  test_suspend();
+  test_writePage();
+  test_failure();
+
+  if(0 != test_numFailed)
+  {
+    printf("ext_flash_test: %u check(s) failed\n", test_numFailed);
+  }
+  else
+  {
+    printf("ext_flash_test: passed\n");
+  }
+  return (0 != test_numFailed) ? 1 : 0;
+}
@@ -0,0 +1,303 @@
+#ifndef SFDP_C
+#define SFDP_C
+#endif /* SFDP_C */
+
+
+#include "bsp.h"
+#include "reg.h"
+
+#include "sfdp.h"
+
+
+/*
+ * Serial Flash Discoverable Parameters (JESD216)
+ *
+ * The SFDP header and the parameter headers are read by the given read
+ * function. The most recent basic flash parameter table (BFPT) is decoded
+ * into the device geometry, the erase types with their typical times and
+ * the quad read and quad enable parameters. Nothing but the read function
+ * touches the device, so captured SFDP dumps can be parsed on the host.
+ */
+
+#define SFDP_SIGNATURE          0x50444653 /* "SFDP" */
+#define SFDP_HEADER_LEN         8
+#define SFDP_PARAM_HEADER_LEN   8
+#define SFDP_MAX_PARAM_HEADERS  8
+
+/* Parameter ID and major revision of the basic flash parameter table */
+#define SFDP_BFPT_ID            0xFF00
+#define SFDP_BFPT_MAJOR_REV     1
+
+/* DWORDs of the basic flash parameter table decoded */
+#define SFDP_BFPT_NUM_DWORDS    15
+
+/* BFPT DWORD 1 */
+#define SFDP_DW1_FAST_READ_144_BF  22, 1
+#define SFDP_DW1_FAST_READ_114_BF  21, 1
+#define SFDP_DW1_ADDR_BYTES_BF     17, 2
+
+/* BFPT DWORD 2 */
+#define SFDP_DW2_DENSITY_POW2_BF   31, 1
+
+/* BFPT DWORD 3, quad fast read parameters */
+#define SFDP_DW3_114_CMD_BF        24, 8
+#define SFDP_DW3_114_MODE_BF       21, 3
+#define SFDP_DW3_114_DUMMY_BF      16, 5
+#define SFDP_DW3_144_CMD_BF         8, 8
+#define SFDP_DW3_144_MODE_BF        5, 3
+#define SFDP_DW3_144_DUMMY_BF       0, 5
+
+/* BFPT DWORD 8 and 9, two erase types each */
+#define SFDP_DW8_ERASE_CMD_BF(i)    (8 + (16 * (i))), 8
+#define SFDP_DW8_ERASE_SIZE_BF(i)   (16 * (i)), 8
+
+/* BFPT DWORD 10, typical erase time per erase type */
+#define SFDP_DW10_ERASE_TIME_BF(i)  (4 + (7 * (i))), 7
+#define SFDP_ERASE_TIME_CNT_BF      0, 5
+#define SFDP_ERASE_TIME_UNIT_BF     5, 2
+
+/* BFPT DWORD 11 */
+#define SFDP_DW11_PROG_TIME_UNIT_BF 13, 1
+#define SFDP_DW11_PROG_TIME_CNT_BF   8, 5
+#define SFDP_DW11_PAGE_SIZE_BF       4, 4
+
+/* BFPT DWORD 15 */
+#define SFDP_DW15_QER_BF            20, 3
+
+/* Page size of devices with a JESD216 table lacking DWORD 11 */
+#define SFDP_DEFAULT_PAGE_SIZE      256
+
+/* Units of the typical erase time [ms] */
+static const uint32 sfdp_eraseTimeUnitTbl[4] = { 1, 16, 128, 1000 };
+
+
+/*
+ ******************************************************************************
+ * Function: sfdp_getDword
+ ******************************************************************************
+ * @brief Get a little endian DWORD from a byte buffer
+ *
+ ******************************************************************************
+ */
+
+static uint32 sfdp_getDword(const uint8 buf[])
+{
+  return ( ((uint32)buf[0] <<  0)
+         | ((uint32)buf[1] <<  8)
+         | ((uint32)buf[2] << 16)
+         | ((uint32)buf[3] << 24) );
+}
+
+
+/*
+ ******************************************************************************
+ * Function: sfdp_findBfpt
+ ******************************************************************************
+ * @brief Find the most recent basic flash parameter table
+ *
+ * @param [in]  readFunc   - Function reading the SFDP address space
+ * @param [out] bfptAddr   - SFDP address of the table
+ * @param [out] bfptDwords - Length of the table in DWORDs
+ *
+ * @return STATUS_eOK if a table was found, STATUS_eNOK otherwise
+ *
+ ******************************************************************************
+ */
+
+static T_STATUS sfdp_findBfpt(T_SFDP_READ_FUNC readFunc, uint32* bfptAddr, uint32* bfptDwords)
+{
+  T_STATUS result = STATUS_eNOK;
+  uint8  hdr[SFDP_PARAM_HEADER_LEN];
+  uint32 numHeaders;
+  uint32 hdrIdx;
+  uint32 paramID;
+
+  if(STATUS_eOK != readFunc(0, hdr, SFDP_HEADER_LEN))
+  {
+    /* Failed */
+  }
+  else if(SFDP_SIGNATURE != sfdp_getDword(hdr))
+  {
+    /* No SFDP */
+  }
+  else
+  {
+    numHeaders = (uint32)hdr[6] + 1;
+    if(numHeaders > SFDP_MAX_PARAM_HEADERS)
+    {
+      numHeaders = SFDP_MAX_PARAM_HEADERS;
+    }
+
+    /* Later headers of the same table describe later revisions */
+    for(hdrIdx = 0; hdrIdx < numHeaders; hdrIdx++)
+    {
+      if(STATUS_eOK != readFunc(SFDP_HEADER_LEN + (hdrIdx * SFDP_PARAM_HEADER_LEN), hdr, SFDP_PARAM_HEADER_LEN))
+      {
+        break;
+      }
+
+      paramID = ((uint32)hdr[7] << 8) | hdr[0];
+      if( (SFDP_BFPT_ID == paramID) && (SFDP_BFPT_MAJOR_REV == hdr[2]) && (hdr[3] > 0) )
+      {
+        *bfptDwords = hdr[3];
+        *bfptAddr = sfdp_getDword(&hdr[4]) & 0x00FFFFFF;
+        result = STATUS_eOK;
+      }
+    }
+  }
+  return result;
+}
+
+
+/*
+ ******************************************************************************
+ * Function: sfdp_parse
+ ******************************************************************************
+ * @brief Get the device parameters from the SFDP tables
+ *
+ * @par Description:
+ *   Parameters not described by an older table revision are set to the
+ *   defaults of JESD216: a page size of 256 bytes, unknown typical times
+ *   of 0 and an unknown quad enable requirement.
+ *
+ * @param [in]  readFunc - Function reading the SFDP address space
+ * @param [out] info     - Decoded device parameters
+ *
+ * @return STATUS_eOK if the tables were decoded, STATUS_eNOK otherwise
+ *
+ ******************************************************************************
+ */
+
+T_STATUS sfdp_parse(T_SFDP_READ_FUNC readFunc, T_SFDP_INFO* info)
+{
+  T_STATUS result = STATUS_eNOK;
+  uint8  bfptBuf[SFDP_BFPT_NUM_DWORDS * sizeof(uint32)];
+  uint32 bfpt[SFDP_BFPT_NUM_DWORDS];
+  uint32 bfptAddr = 0;
+  uint32 bfptDwords = 0;
+  uint32 density;
+  uint32 eraseDw;
+  uint32 eraseTime;
+  uint32 typeIdx;
+  uint32 dwIdx;
+  T_SFDP_ERASE_TYPE* eraseType;
+
+  if(STATUS_eOK != sfdp_findBfpt(readFunc, &bfptAddr, &bfptDwords))
+  {
+    /* No basic flash parameter table */
+  }
+  else
+  {
+    if(bfptDwords > SFDP_BFPT_NUM_DWORDS)
+    {
+      bfptDwords = SFDP_BFPT_NUM_DWORDS;
+    }
+    result = readFunc(bfptAddr, bfptBuf, bfptDwords * sizeof(uint32));
+  }
+
+  if(STATUS_eOK != result)
+  {
+    /* Failed */
+  }
+  /* JESD216 defines at least 9 DWORDs */
+  else if(bfptDwords < 9)
+  {
+    result = STATUS_eNOK;
+  }
+  else
+  {
+    /* DWORDs not provided by the table read as 0 */
+    for(dwIdx = 0; dwIdx < SFDP_BFPT_NUM_DWORDS; dwIdx++)
+    {
+      bfpt[dwIdx] = (dwIdx < bfptDwords) ? sfdp_getDword(&bfptBuf[dwIdx * sizeof(uint32)]) : 0;
+    }
+
+    /* Address bytes: 0 - 3 byte only, 1 - 3 or 4 byte, 2 - 4 byte only */
+    info->addrBytes = (2 == BF_GET(bfpt[0], SFDP_DW1_ADDR_BYTES_BF)) ? 4 : 3;
+
+    /* Density in bits */
+    density = bfpt[1] & ~BF_MASK(SFDP_DW2_DENSITY_POW2_BF);
+    if(0 == BF_GET(bfpt[1], SFDP_DW2_DENSITY_POW2_BF))
+    {
+      info->flashSize = (density + 1) / 8;
+    }
+    else if( (density < 3) || (density > 34) )
+    {
+      /* Size not representable */
+      info->flashSize = 0;
+    }
+    else
+    {
+      info->flashSize = 1u << (density - 3);
+    }
+
+    /* Quad fast read, quad address preferred */
+    if(0 != BF_GET(bfpt[0], SFDP_DW1_FAST_READ_144_BF))
+    {
+      info->quadReadCmd = (uint8)BF_GET(bfpt[2], SFDP_DW3_144_CMD_BF);
+      info->quadReadAddrPads = 4;
+      info->quadReadDummy = (uint8)(BF_GET(bfpt[2], SFDP_DW3_144_DUMMY_BF) + BF_GET(bfpt[2], SFDP_DW3_144_MODE_BF));
+    }
+    else if(0 != BF_GET(bfpt[0], SFDP_DW1_FAST_READ_114_BF))
+    {
+      info->quadReadCmd = (uint8)BF_GET(bfpt[2], SFDP_DW3_114_CMD_BF);
+      info->quadReadAddrPads = 1;
+      info->quadReadDummy = (uint8)(BF_GET(bfpt[2], SFDP_DW3_114_DUMMY_BF) + BF_GET(bfpt[2], SFDP_DW3_114_MODE_BF));
+    }
+    else
+    {
+      info->quadReadCmd = 0;
+      info->quadReadAddrPads = 0;
+      info->quadReadDummy = 0;
+    }
+
+    /* Erase types with a size of 0 are not supported */
+    info->numEraseTypes = 0;
+    for(typeIdx = 0; typeIdx < SFDP_MAX_ERASE_TYPES; typeIdx++)
+    {
+      eraseDw = bfpt[7 + (typeIdx / 2)];
+      if(0 == BF_GET(eraseDw, SFDP_DW8_ERASE_SIZE_BF(typeIdx % 2)))
+      {
+        /* Erase type not supported */
+      }
+      else if(BF_GET(eraseDw, SFDP_DW8_ERASE_SIZE_BF(typeIdx % 2)) > 31)
+      {
+        /* Invalid size */
+      }
+      else
+      {
+        eraseType = &info->eraseTypes[info->numEraseTypes];
+        eraseType->size = 1u << BF_GET(eraseDw, SFDP_DW8_ERASE_SIZE_BF(typeIdx % 2));
+        eraseType->cmd = (uint8)BF_GET(eraseDw, SFDP_DW8_ERASE_CMD_BF(typeIdx % 2));
+
+        /* Typical time is 0, if DWORD 10 isn't provided */
+        eraseTime = BF_GET(bfpt[9], SFDP_DW10_ERASE_TIME_BF(typeIdx));
+        eraseType->typTime = (bfptDwords < 10) ? 0 :
+          (BF_GET(eraseTime, SFDP_ERASE_TIME_CNT_BF) + 1) * sfdp_eraseTimeUnitTbl[BF_GET(eraseTime, SFDP_ERASE_TIME_UNIT_BF)];
+        info->numEraseTypes++;
+      }
+    }
+
+    if(bfptDwords < 11)
+    {
+      info->pageSize = SFDP_DEFAULT_PAGE_SIZE;
+      info->progTime = 0;
+    }
+    else
+    {
+      info->pageSize = 1u << BF_GET(bfpt[10], SFDP_DW11_PAGE_SIZE_BF);
+      info->progTime = (BF_GET(bfpt[10], SFDP_DW11_PROG_TIME_CNT_BF) + 1)
+                     * ((0 != BF_GET(bfpt[10], SFDP_DW11_PROG_TIME_UNIT_BF)) ? 64 : 8);
+    }
+
+    if(bfptDwords < 15)
+    {
+      info->quadEnableReq = SFDP_QER_eUNKNOWN;
+    }
+    else
+    {
+      info->quadEnableReq = (T_SFDP_QER)BF_GET(bfpt[14], SFDP_DW15_QER_BF);
+    }
+  }
+  return result;
+}
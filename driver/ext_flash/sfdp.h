@@ -0,0 +1,48 @@
+#ifndef SFDP_H
+#define SFDP_H
+
+
+/* Maximum number of erase types of the basic flash parameter table */
+#define SFDP_MAX_ERASE_TYPES 4
+
+/* Quad enable requirements (QER) of the basic flash parameter table */
+typedef enum SFDP_QER
+{
+  SFDP_QER_eNONE = 0,       /* No quad enable bit */
+  SFDP_QER_eSR2_BIT1_WR2,   /* Bit 1 of SR2, written with SR1 by 0x01, cleared by 1 byte writes */
+  SFDP_QER_eSR1_BIT6,       /* Bit 6 of SR1, written by 0x01 */
+  SFDP_QER_eSR2_BIT7,       /* Bit 7 of SR2, read by 0x3F, written by 0x3E */
+  SFDP_QER_eSR2_BIT1_WR2_KEEP, /* Bit 1 of SR2, written with SR1 by 0x01, kept by 1 byte writes */
+  SFDP_QER_eSR2_BIT1_RD35,  /* Bit 1 of SR2, read by 0x35, written with SR1 by 0x01 */
+  SFDP_QER_eSR2_BIT1_WR31,  /* Bit 1 of SR2, read by 0x35, written by 0x31 */
+  SFDP_QER_eUNKNOWN,        /* Not described by the table */
+}T_SFDP_QER;
+
+typedef struct
+{
+  uint32 size;     /* Erase size in bytes */
+  uint32 typTime;  /* Typical erase time [ms] */
+  uint8  cmd;      /* Erase command */
+}T_SFDP_ERASE_TYPE;
+
+typedef struct
+{
+  uint32 flashSize;     /* Flash size in bytes */
+  uint32 pageSize;      /* Page size in bytes */
+  uint32 progTime;      /* Typical page program time [us] */
+  uint8  addrBytes;     /* Address bytes, 3 or 4 */
+  uint8  numEraseTypes; /* Number of valid erase types */
+  T_SFDP_ERASE_TYPE eraseTypes[SFDP_MAX_ERASE_TYPES];
+  uint8  quadReadCmd;   /* Quad fast read command, 0 if not supported */
+  uint8  quadReadAddrPads; /* Address pads of the quad fast read, 1 or 4 */
+  uint8  quadReadDummy; /* Dummy cycles of the quad fast read, including the mode bits */
+  T_SFDP_QER quadEnableReq;
+}T_SFDP_INFO;
+
+/* Function reading the SFDP address space of the device */
+typedef T_STATUS (*T_SFDP_READ_FUNC)(uint32 sfdpAddr, uint8 dstBuf[], uint32 numBytes);
+
+
+extern T_STATUS sfdp_parse(T_SFDP_READ_FUNC readFunc, T_SFDP_INFO* info);
+
+#endif /* SFDP_H */
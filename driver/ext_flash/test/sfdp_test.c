@@ -0,0 +1,215 @@
+#ifndef SFDP_TEST_C
+#define SFDP_TEST_C
+#endif /* SFDP_TEST_C */
+
+#include "bsp.h"
+#include "sfdp.h"
+
+#include <stdio.h>
+#include <string.h>
+
+
+/*
+ * Host test of the SFDP parser
+ *
+ * The SFDP address space of a Winbond W25Q16JV, the NOR flash of the
+ * Teensy 4.0, is read from a dump. It holds a JESD216A header and a basic
+ * flash parameter table of 16 DWORDs at 0x80.
+ */
+
+#define TEST_DUMP_SIZE 0x100u
+
+#define TEST_CHECK(cond)                                                  \
+  do                                                                      \
+  {                                                                       \
+    if(!(cond))                                                           \
+    {                                                                     \
+      printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond);     \
+      test_numFailed++;                                                   \
+    }                                                                     \
+  }while(0)
+
+/* SFDP dump of the W25Q16JV, bytes not listed read as 0xFF */
+static const uint8 test_w25q16jvDump[] =
+{
+  /* 0x00: SFDP header, parameter header of the BFPT */
+  0x53, 0x46, 0x44, 0x50, 0x05, 0x01, 0x00, 0xFF,
+  0x00, 0x05, 0x01, 0x10, 0x80, 0x00, 0x00, 0xFF,
+  /* 0x10 */
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  /* 0x80: BFPT */
+  0xE5, 0x20, 0xF9, 0xFF, 0xFF, 0xFF, 0xFF, 0x00, 0x44, 0xEB, 0x08, 0x6B, 0x08, 0x3B, 0x42, 0xBB,
+  0xFE, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x00, 0x00, 0xFF, 0xFF, 0x40, 0xEB, 0x0C, 0x20, 0x0F, 0x52,
+  0x10, 0xD8, 0x00, 0x00, 0x36, 0x02, 0xA6, 0x00, 0x82, 0xEA, 0x14, 0xC9, 0xE9, 0x63, 0x76, 0x33,
+  0x7A, 0x75, 0x7A, 0x75, 0xF7, 0xA2, 0xD5, 0x5C, 0x19, 0xF7, 0x4D, 0xFF, 0xE9, 0x30, 0xF8, 0x80,
+};
+
+static uint8 test_dump[TEST_DUMP_SIZE];
+static uint32 test_numFailed;
+
+
+/*
+ ******************************************************************************
+ * test_readDump
+ ******************************************************************************
+ * Description:
+ *   The function reads the SFDP address space from the dump.
+ *
+ ******************************************************************************
+ */
+
+static T_STATUS test_readDump(uint32 sfdpAddr, uint8 dstBuf[], uint32 numBytes)
+{
+  T_STATUS result = STATUS_eNOK;
+
+  if( (sfdpAddr < TEST_DUMP_SIZE) && (numBytes <= (TEST_DUMP_SIZE - sfdpAddr)) )
+  {
+    memcpy(dstBuf, &test_dump[sfdpAddr], numBytes);
+    result = STATUS_eOK;
+  }
+  return result;
+}
+
+
+/*
+ ******************************************************************************
+ * test_loadDump
+ ******************************************************************************
+ */
+
+static void test_loadDump(void)
+{
+  memset(test_dump, 0xFF, sizeof(test_dump));
+  memcpy(test_dump, test_w25q16jvDump, sizeof(test_w25q16jvDump));
+}
+
+
+/*
+ ******************************************************************************
+ * test_w25q16jv
+ ******************************************************************************
+ * Description:
+ *   All parameters are taken from the table.
+ *
+ ******************************************************************************
+ */
+
+static void test_w25q16jv(void)
+{
+  T_SFDP_INFO info;
+
+  test_loadDump();
+  memset(&info, 0, sizeof(info));
+  TEST_CHECK(STATUS_eOK == sfdp_parse(test_readDump, &info));
+
+  /* 16 Mbit, 3 byte addresses */
+  TEST_CHECK(0x200000 == info.flashSize);
+  TEST_CHECK(3 == info.addrBytes);
+
+  /* 256 byte pages, programmed in (10 + 1) * 64 us */
+  TEST_CHECK(256 == info.pageSize);
+  TEST_CHECK(704 == info.progTime);
+
+  /* 4 KiB, 32 KiB and 64 KiB erase types, the fourth isn't supported */
+  TEST_CHECK(3 == info.numEraseTypes);
+  TEST_CHECK(0x1000 == info.eraseTypes[0].size);
+  TEST_CHECK(0x20 == info.eraseTypes[0].cmd);
+  TEST_CHECK(64 == info.eraseTypes[0].typTime);
+  TEST_CHECK(0x8000 == info.eraseTypes[1].size);
+  TEST_CHECK(0x52 == info.eraseTypes[1].cmd);
+  TEST_CHECK(128 == info.eraseTypes[1].typTime);
+  TEST_CHECK(0x10000 == info.eraseTypes[2].size);
+  TEST_CHECK(0xD8 == info.eraseTypes[2].cmd);
+  TEST_CHECK(160 == info.eraseTypes[2].typTime);
+
+  /* 1-4-4 fast read by 0xEB with 2 mode and 4 dummy clocks */
+  TEST_CHECK(0xEB == info.quadReadCmd);
+  TEST_CHECK(4 == info.quadReadAddrPads);
+  TEST_CHECK(6 == info.quadReadDummy);
+
+  /* Quad enable is bit 1 of SR2, kept by single byte writes */
+  TEST_CHECK(SFDP_QER_eSR2_BIT1_WR2_KEEP == info.quadEnableReq);
+}
+
+
+/*
+ ******************************************************************************
+ * test_jesd216
+ ******************************************************************************
+ * Description:
+ *   A table of the first revision has 9 DWORDs only. The page size is the
+ *   default, times and the quad enable requirement are unknown.
+ *
+ ******************************************************************************
+ */
+
+static void test_jesd216(void)
+{
+  T_SFDP_INFO info;
+
+  test_loadDump();
+  test_dump[0x0B] = 9;
+  memset(&info, 0, sizeof(info));
+  TEST_CHECK(STATUS_eOK == sfdp_parse(test_readDump, &info));
+
+  TEST_CHECK(0x200000 == info.flashSize);
+  TEST_CHECK(256 == info.pageSize);
+  TEST_CHECK(0 == info.progTime);
+  TEST_CHECK(3 == info.numEraseTypes);
+  TEST_CHECK(0x8000 == info.eraseTypes[1].size);
+  TEST_CHECK(0 == info.eraseTypes[1].typTime);
+  TEST_CHECK(0xEB == info.quadReadCmd);
+  TEST_CHECK(SFDP_QER_eUNKNOWN == info.quadEnableReq);
+
+  /* Shorter tables aren't valid */
+  test_dump[0x0B] = 8;
+  TEST_CHECK(STATUS_eOK != sfdp_parse(test_readDump, &info));
+}
+
+
+/*
+ ******************************************************************************
+ * test_noSfdp
+ ******************************************************************************
+ * Description:
+ *   A device without SFDP reads a blank bus.
+ *
+ ******************************************************************************
+ */
+
+static void test_noSfdp(void)
+{
+  T_SFDP_INFO info;
+
+  memset(test_dump, 0xFF, sizeof(test_dump));
+  TEST_CHECK(STATUS_eOK != sfdp_parse(test_readDump, &info));
+
+  /* A table of another major revision is skipped */
+  test_loadDump();
+  test_dump[0x0A] = 2;
+  TEST_CHECK(STATUS_eOK != sfdp_parse(test_readDump, &info));
+}
+
+
+int main(void)
+{
+  test_w25q16jv();
+  test_jesd216();
+  test_noSfdp();
+
+  if(0 != test_numFailed)
+  {
+    printf("sfdp_test: %u check(s) failed\n", test_numFailed);
+  }
+  else
+  {
+    printf("sfdp_test: passed\n");
+  }
+  return (0 != test_numFailed) ? 1 : 0;
+}
@@ -0,0 +1,35 @@
+#ifndef ARMV7M_DWT_H
+#define ARMV7M_DWT_H
+
+
+/*
+ * Data Watchpoint and Trace unit (DWT)
+ */
+
+/* Control Register */
+#define DWT_CTRL_OFFS            0x000
+
+#define DWT_CTRL_NUMCOMP_BF      28,  4
+#define DWT_CTRL_NOCYCCNT_BF     25,  1
+#define DWT_CTRL_CYCCNTENA_BF     0,  1
+
+/* Cycle Count Register */
+#define DWT_CYCCNT_OFFS          0x004
+
+/* Lock Access Register (Cortex-M7 only) */
+#define DWT_LAR_OFFS             0xFB0
+
+#define DWT_LAR_KEY              0xC5ACCE55UL
+
+
+/*
+ * Debug Control Block (DCB)
+ */
+
+/* Debug Exception and Monitor Control Register */
+#define DCB_DEMCR_OFFS           0x00C
+
+#define DCB_DEMCR_TRCENA_BF      24,  1
+
+
+#endif /* ARMV7M_DWT_H */
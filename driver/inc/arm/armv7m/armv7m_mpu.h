@@ -0,0 +1,92 @@
+#ifndef ARMV7M_MPU_H
+#define ARMV7M_MPU_H
+
+
+/*
+ * Memory Protection Unit (MPU)
+ */
+
+/* MPU Type Register */
+#define MPU_TYPE_OFFS            0x000
+
+#define MPU_TYPE_IREGION_BF      16,  8
+#define MPU_TYPE_DREGION_BF       8,  8
+#define MPU_TYPE_SEPARATE_BF      0,  1
+
+/* MPU Control Register */
+#define MPU_CTRL_OFFS            0x004
+
+#define MPU_CTRL_PRIVDEFENA_BF    2,  1
+#define MPU_CTRL_HFNMIENA_BF      1,  1
+#define MPU_CTRL_ENABLE_BF        0,  1
+
+/* MPU Region Number Register */
+#define MPU_RNR_OFFS             0x008
+
+#define MPU_RNR_REGION_BF         0,  8
+
+/* MPU Region Base Address Register */
+#define MPU_RBAR_OFFS            0x00C
+
+#define MPU_RBAR_ADDR_BF          5, 27
+#define MPU_RBAR_VALID_BF         4,  1
+#define MPU_RBAR_REGION_BF        0,  4
+
+/* MPU Region Attribute and Size Register */
+#define MPU_RASR_OFFS            0x010
+
+#define MPU_RASR_XN_BF           28,  1
+#define MPU_RASR_AP_BF           24,  3
+#define MPU_RASR_TEX_BF          19,  3
+#define MPU_RASR_S_BF            18,  1
+#define MPU_RASR_C_BF            17,  1
+#define MPU_RASR_B_BF            16,  1
+#define MPU_RASR_SRD_BF           8,  8
+#define MPU_RASR_SIZE_BF          1,  5
+#define MPU_RASR_ENABLE_BF        0,  1
+
+/* Access permissions */
+#define MPU_AP_eNO_ACCESS         0
+#define MPU_AP_eRW                3
+#define MPU_AP_eRO                6
+
+/* Memory types as of TEX, C, B and S */
+#define MPU_RASR_MEM_STRONGLY_ORDERED (0                      \
+  | BF_SET(0, MPU_RASR_TEX_BF)                                \
+  )
+
+#define MPU_RASR_MEM_DEVICE (0                                \
+  | BF_SET(0, MPU_RASR_TEX_BF)                                \
+  | BF_SET(1, MPU_RASR_B_BF)                                  \
+  | BF_SET(1, MPU_RASR_S_BF)                                  \
+  )
+
+#define MPU_RASR_MEM_NORMAL_NC (0                             \
+  | BF_SET(1, MPU_RASR_TEX_BF)                                \
+  )
+
+#define MPU_RASR_MEM_NORMAL_WT (0                             \
+  | BF_SET(0, MPU_RASR_TEX_BF)                                \
+  | BF_SET(1, MPU_RASR_C_BF)                                  \
+  )
+
+#define MPU_RASR_MEM_NORMAL_WBWA (0                           \
+  | BF_SET(1, MPU_RASR_TEX_BF)                                \
+  | BF_SET(1, MPU_RASR_C_BF)                                  \
+  | BF_SET(1, MPU_RASR_B_BF)                                  \
+  )
+
+/* Region size of 2^log2Size bytes, the minimum is 32 bytes */
+#define MPU_RASR_SIZE(log2Size)  BF_SET((log2Size) - 1, MPU_RASR_SIZE_BF)
+
+/* Region attributes and size of an enabled region */
+#define MPU_RASR(log2Size, mem, ap, xn) (0                    \
+  | MPU_RASR_SIZE(log2Size)                                   \
+  | (mem)                                                     \
+  | BF_SET((ap), MPU_RASR_AP_BF)                              \
+  | BF_SET((xn), MPU_RASR_XN_BF)                              \
+  | BF_SET(1, MPU_RASR_ENABLE_BF)                             \
+  )
+
+
+#endif /* ARMV7M_MPU_H */
@@ -7,6 +7,9 @@
 #endif /* !defined(ARMV7_M_BASE) */
 
 
+/* ARMv7-M Data Watchpoint and Trace unit (DWT) */
+#define ARMV7_M_DWT_BASE                    (ARMV7_M_BASE + 0x00001000)
+
 /* ARMv7-M System Control Space */
 #define ARMV7_M_SCS_BASE                    (ARMV7_M_BASE + 0x0000E000)
 
@@ -19,8 +22,11 @@
 /* ARMv7-M Nested Vector Interrupt Controller (NVIC) */
 #define ARMV7_M_NVIC_BASE                   (ARMV7_M_SCS_BASE + 0x0100)
 
+/* ARMv7-M Debug Control Block (DCB) */
+#define ARMV7_M_DCB_BASE                    (ARMV7_M_SCS_BASE + 0x0DF0)
+
 /* ARMv7-M Memory Protection Unit (MPU) */
-#define ARMV7_M_MPU_BASE                    (ARMV7_M_SCS_BASE + 0x0100)
+#define ARMV7_M_MPU_BASE                    (ARMV7_M_SCS_BASE + 0x0D90)
 
 
 #endif /* ARMV7M_REGMAP_H */
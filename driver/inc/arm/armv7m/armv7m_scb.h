@@ -37,6 +37,10 @@
 /* Configuration Control Register */
 #define SCB_CCR_OFFS             0x014
 
+#define SCB_CCR_BP_BF            18,  1
+#define SCB_CCR_IC_BF            17,  1
+#define SCB_CCR_DC_BF            16,  1
+
 
 /* System Handlers Priority Registers */
 #define SCB_SHPR_BASE_OFFS       0x018
@@ -154,5 +158,16 @@
 #define SCB_MVFR1_OFFS           0x244
 #define SCB_MVFR2_OFFS           0x248
 
+/* Cache maintenance operations */
+#define SCB_ICIALLU_OFFS         0x250 /* I-cache invalidate all to PoU */
+#define SCB_ICIMVAU_OFFS         0x258 /* I-cache invalidate by address to PoU */
+#define SCB_DCIMVAC_OFFS         0x25C /* D-cache invalidate by address to PoC */
+#define SCB_DCISW_OFFS           0x260 /* D-cache invalidate by set/way */
+#define SCB_DCCMVAU_OFFS         0x264 /* D-cache clean by address to PoU */
+#define SCB_DCCMVAC_OFFS         0x268 /* D-cache clean by address to PoC */
+#define SCB_DCCSW_OFFS           0x26C /* D-cache clean by set/way */
+#define SCB_DCCIMVAC_OFFS        0x270 /* D-cache clean and invalidate by address to PoC */
+#define SCB_DCCISW_OFFS          0x274 /* D-cache clean and invalidate by set/way */
+
 #endif /* ARMV7M_SCB_H */
 
@@ -28,6 +28,9 @@
 /* Low Power UART */
 #include "imxrt_lpuart.h"
 
+/* Enhanced Direct Memory Access */
+#include "imxrt_edma.h"
+
 /* Low Power SPI */
 #include "imxrt_lpspi.h"
 
@@ -40,5 +43,8 @@
 /* Bit Encryption Engine */
 #include "imxrt_bee.h"
 
+/* Flexible Serial Peripheral Interface */
+#include "imxrt_flexspi.h"
+
 #endif /* IMXRT_H */
 
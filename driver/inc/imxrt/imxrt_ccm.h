@@ -430,6 +430,7 @@ enum
 
 #define LPUART7_CLK_ENA_BF               26, 2
 #define LPUART1_CLK_ENA_BF               24, 2
+#define EDMA_CLK_ENA_BF                   6, 2
 
 /* CCM Clock Gating Register 6 */
 #define CCM_CCGR6_OFFS                   0x080 /*!<  */
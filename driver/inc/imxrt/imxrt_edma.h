@@ -0,0 +1,133 @@
+#ifndef IMXRT_EDMA_H
+#define IMXRT_EDMA_H
+
+
+/*
+ * Enhanced Direct Memory Access Controller Registers
+ */
+
+/* eDMA Control Register */
+#define EDMA_CR_OFFS                   0x000
+
+#define EDMA_CR_ACTIVE_BF              31, 1
+#define EDMA_CR_CX_BF                  17, 1
+#define EDMA_CR_ECX_BF                 16, 1
+#define EDMA_CR_GRP1PRI_BF             10, 1
+#define EDMA_CR_GRP0PRI_BF              8, 1
+#define EDMA_CR_EMLM_BF                 7, 1
+#define EDMA_CR_CLM_BF                  6, 1
+#define EDMA_CR_HALT_BF                 5, 1
+#define EDMA_CR_HOE_BF                  4, 1
+#define EDMA_CR_ERGA_BF                 3, 1
+#define EDMA_CR_ERCA_BF                 2, 1
+#define EDMA_CR_EDBG_BF                 1, 1
+
+/* eDMA Error Status Register */
+#define EDMA_ES_OFFS                   0x004
+
+/* eDMA Enable Request Register */
+#define EDMA_ERQ_OFFS                  0x00C
+
+/* eDMA Enable Error Interrupt Register */
+#define EDMA_EEI_OFFS                  0x014
+
+/* eDMA byte wide channel control registers, written with the channel number */
+#define EDMA_CEEI_OFFS                 0x018
+#define EDMA_SEEI_OFFS                 0x019
+#define EDMA_CERQ_OFFS                 0x01A
+#define EDMA_SERQ_OFFS                 0x01B
+#define EDMA_CDNE_OFFS                 0x01C
+#define EDMA_SSRT_OFFS                 0x01D
+#define EDMA_CERR_OFFS                 0x01E
+#define EDMA_CINT_OFFS                 0x01F
+
+/* eDMA Interrupt Request Register */
+#define EDMA_INT_OFFS                  0x024
+
+/* eDMA Error Register */
+#define EDMA_ERR_OFFS                  0x02C
+
+/* eDMA Hardware Request Status Register */
+#define EDMA_HRS_OFFS                  0x034
+
+/* eDMA Channel Priority Registers (byte wide, one per channel) */
+#define EDMA_DCHPRI_OFFS(n)            (0x100 + ((n) ^ 3))
+
+
+/* Transfer Control Descriptors */
+#define EDMA_TCD_OFFS(n)               (0x1000 + ((n) * 0x20))
+#define EDMA_NUM_CHANNELS              32
+
+/* TCD register offsets */
+#define EDMA_TCD_SADDR_OFFS            0x000
+#define EDMA_TCD_SOFF_OFFS             0x004 /* 16 bit */
+#define EDMA_TCD_ATTR_OFFS             0x006 /* 16 bit */
+#define EDMA_TCD_NBYTES_OFFS           0x008
+#define EDMA_TCD_SLAST_OFFS            0x00C
+#define EDMA_TCD_DADDR_OFFS            0x010
+#define EDMA_TCD_DOFF_OFFS             0x014 /* 16 bit */
+#define EDMA_TCD_CITER_OFFS            0x016 /* 16 bit */
+#define EDMA_TCD_DLAST_SGA_OFFS        0x018
+#define EDMA_TCD_CSR_OFFS              0x01C /* 16 bit */
+#define EDMA_TCD_BITER_OFFS            0x01E /* 16 bit */
+
+#define EDMA_TCD_ATTR_SMOD_BF          11, 5
+#define EDMA_TCD_ATTR_SSIZE_BF          8, 3
+#define EDMA_TCD_ATTR_DMOD_BF           3, 5
+#define EDMA_TCD_ATTR_DSIZE_BF          0, 3
+
+#define EDMA_TCD_CITER_ELINK_BF        15, 1
+#define EDMA_TCD_CITER_CITER_BF         0, 15
+
+#define EDMA_TCD_BITER_ELINK_BF        15, 1
+#define EDMA_TCD_BITER_BITER_BF         0, 15
+
+#define EDMA_TCD_CSR_BWC_BF            14, 2
+#define EDMA_TCD_CSR_MAJORLINKCH_BF     8, 5
+#define EDMA_TCD_CSR_DONE_BF            7, 1
+#define EDMA_TCD_CSR_ACTIVE_BF          6, 1
+#define EDMA_TCD_CSR_MAJORELINK_BF      5, 1
+#define EDMA_TCD_CSR_ESG_BF             4, 1
+#define EDMA_TCD_CSR_DREQ_BF            3, 1
+#define EDMA_TCD_CSR_INTHALF_BF         2, 1
+#define EDMA_TCD_CSR_INTMAJOR_BF        1, 1
+#define EDMA_TCD_CSR_START_BF           0, 1
+
+/* Transfer sizes for ATTR.SSIZE/DSIZE */
+#define EDMA_TCD_ATTR_SIZE_8BIT         0
+#define EDMA_TCD_ATTR_SIZE_16BIT        1
+#define EDMA_TCD_ATTR_SIZE_32BIT        2
+#define EDMA_TCD_ATTR_SIZE_32BYTE       5
+
+
+/*
+ * DMA Channel Multiplexer Registers
+ */
+
+/* DMAMUX Channel Configuration Registers */
+#define DMAMUX_CHCFG_OFFS(n)           ((n) * 4)
+
+#define DMAMUX_CHCFG_ENBL_BF           31, 1
+#define DMAMUX_CHCFG_TRIG_BF           30, 1
+#define DMAMUX_CHCFG_A_ON_BF           29, 1
+#define DMAMUX_CHCFG_SOURCE_BF          0, 7
+
+/* DMAMUX request sources */
+#define DMAMUX_SRC_LPUART1_TX           2
+#define DMAMUX_SRC_LPUART1_RX           3
+#define DMAMUX_SRC_LPUART3_TX           6
+#define DMAMUX_SRC_LPUART3_RX           7
+#define DMAMUX_SRC_LPUART5_TX          10
+#define DMAMUX_SRC_LPUART5_RX          11
+#define DMAMUX_SRC_LPUART7_TX          14
+#define DMAMUX_SRC_LPUART7_RX          15
+#define DMAMUX_SRC_LPUART2_TX          66
+#define DMAMUX_SRC_LPUART2_RX          67
+#define DMAMUX_SRC_LPUART4_TX          70
+#define DMAMUX_SRC_LPUART4_RX          71
+#define DMAMUX_SRC_LPUART6_TX          74
+#define DMAMUX_SRC_LPUART6_RX          75
+#define DMAMUX_SRC_LPUART8_TX          78
+#define DMAMUX_SRC_LPUART8_RX          79
+
+#endif /* IMXRT_EDMA_H */
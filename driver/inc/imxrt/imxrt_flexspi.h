@@ -0,0 +1,131 @@
+#ifndef IMXRT_FLEXSPI_H
+#define IMXRT_FLEXSPI_H
+
+
+/*
+ * Flexible Serial Peripheral Interface
+ */
+
+#define FLEXSPI_MCR0_OFFS                 0x000
+#define FLEXSPI_MCR0_MDIS_BF               1,  1
+#define FLEXSPI_MCR0_SWRESET_BF            0,  1
+
+#define FLEXSPI_INTEN_OFFS                0x010
+#define FLEXSPI_INTR_OFFS                 0x014
+#define FLEXSPI_INTR_SEQTIMEOUT_BF        11,  1
+#define FLEXSPI_INTR_IPTXWE_BF             6,  1
+#define FLEXSPI_INTR_IPRXWA_BF             5,  1
+#define FLEXSPI_INTR_AHBCMDERR_BF          4,  1
+#define FLEXSPI_INTR_IPCMDERR_BF           3,  1
+#define FLEXSPI_INTR_AHBCMDGE_BF           2,  1
+#define FLEXSPI_INTR_IPCMDGE_BF            1,  1
+#define FLEXSPI_INTR_IPCMDDONE_BF          0,  1
+
+#define FLEXSPI_LUTKEY_OFFS               0x018
+#define FLEXSPI_LUTKEY_KEY                0x5AF05AF0
+#define FLEXSPI_LUTCR_OFFS                0x01C
+#define FLEXSPI_LUTCR_UNLOCK_BF            1,  1
+#define FLEXSPI_LUTCR_LOCK_BF              0,  1
+
+/* IP command: serial flash address */
+#define FLEXSPI_IPCR0_OFFS                0x0A0
+
+/* IP command: sequence and data size */
+#define FLEXSPI_IPCR1_OFFS                0x0A4
+#define FLEXSPI_IPCR1_IPAREN_BF           31,  1
+#define FLEXSPI_IPCR1_ISEQNUM_BF          24,  3
+#define FLEXSPI_IPCR1_ISEQID_BF           16,  4
+#define FLEXSPI_IPCR1_IDATSZ_BF            0, 16
+
+#define FLEXSPI_IPCMD_OFFS                0x0B0
+#define FLEXSPI_IPCMD_TRG_BF               0,  1
+
+#define FLEXSPI_IPRXFCR_OFFS              0x0B8
+#define FLEXSPI_IPRXFCR_RXWMRK_BF          2,  6
+#define FLEXSPI_IPRXFCR_RXDMAEN_BF         1,  1
+#define FLEXSPI_IPRXFCR_CLRIPRXF_BF        0,  1
+
+#define FLEXSPI_IPTXFCR_OFFS              0x0BC
+#define FLEXSPI_IPTXFCR_TXWMRK_BF          2,  7
+#define FLEXSPI_IPTXFCR_TXDMAEN_BF         1,  1
+#define FLEXSPI_IPTXFCR_CLRIPTXF_BF        0,  1
+
+#define FLEXSPI_STS0_OFFS                 0x0E0
+#define FLEXSPI_STS0_ARBIDLE_BF            1,  1
+#define FLEXSPI_STS0_SEQIDLE_BF            0,  1
+
+#define FLEXSPI_STS1_OFFS                 0x0E4
+#define FLEXSPI_STS1_IPCMDERRCODE_BF      24,  4
+#define FLEXSPI_STS1_IPCMDERRID_BF        16,  4
+
+/* IP RX and TX FIFO data registers */
+#define FLEXSPI_RFDR_OFFS                 0x100
+#define FLEXSPI_TFDR_OFFS                 0x180
+#define FLEXSPI_FDR_NUM_WORDS             32
+
+/* FIFO watermark unit in bytes */
+#define FLEXSPI_FIFO_WMRK_UNIT             8
+
+#define FLEXSPI_LUT_OFFS                  0x200
+#define FLEXSPI_LUT_NUM_SEQS              16
+
+
+/* Look-up table instruction word, holding two instructions */
+#define FLEXSPI_LUT_OPERAND0_BF            0,  8
+#define FLEXSPI_LUT_NUM_PADS0_BF           8,  2
+#define FLEXSPI_LUT_OPCODE0_BF            10,  6
+#define FLEXSPI_LUT_OPERAND1_BF           16,  8
+#define FLEXSPI_LUT_NUM_PADS1_BF          24,  2
+#define FLEXSPI_LUT_OPCODE1_BF            26,  6
+
+/* Number of instruction words per LUT sequence */
+#define FLEXSPI_LUT_SEQ_NUM_WORDS          4
+
+/* Number of pads used by an instruction */
+#define FLEXSPI_LUT_PADS_e1                0
+#define FLEXSPI_LUT_PADS_e2                1
+#define FLEXSPI_LUT_PADS_e4                2
+#define FLEXSPI_LUT_PADS_e8                3
+
+/* LUT instruction opcodes */
+#define FLEXSPI_LUT_OPC_STOP               0x00
+#define FLEXSPI_LUT_OPC_CMD_SDR            0x01
+#define FLEXSPI_LUT_OPC_RADDR_SDR          0x02
+#define FLEXSPI_LUT_OPC_CADDR_SDR          0x03
+#define FLEXSPI_LUT_OPC_MODE1_SDR          0x04
+#define FLEXSPI_LUT_OPC_MODE2_SDR          0x05
+#define FLEXSPI_LUT_OPC_MODE4_SDR          0x06
+#define FLEXSPI_LUT_OPC_MODE8_SDR          0x07
+#define FLEXSPI_LUT_OPC_WRITE_SDR          0x08
+#define FLEXSPI_LUT_OPC_READ_SDR           0x09
+#define FLEXSPI_LUT_OPC_LEARN_SDR          0x0A
+#define FLEXSPI_LUT_OPC_DATSZ_SDR          0x0B
+#define FLEXSPI_LUT_OPC_DUMMY_SDR          0x0C
+#define FLEXSPI_LUT_OPC_DUMMY_RWDS_SDR     0x0D
+#define FLEXSPI_LUT_OPC_JMP_ON_CS          0x1F
+#define FLEXSPI_LUT_OPC_CMD_DDR            0x21
+#define FLEXSPI_LUT_OPC_RADDR_DDR          0x22
+#define FLEXSPI_LUT_OPC_CADDR_DDR          0x23
+#define FLEXSPI_LUT_OPC_MODE1_DDR          0x24
+#define FLEXSPI_LUT_OPC_MODE2_DDR          0x25
+#define FLEXSPI_LUT_OPC_MODE4_DDR          0x26
+#define FLEXSPI_LUT_OPC_MODE8_DDR          0x27
+#define FLEXSPI_LUT_OPC_WRITE_DDR          0x28
+#define FLEXSPI_LUT_OPC_READ_DDR           0x29
+#define FLEXSPI_LUT_OPC_LEARN_DDR          0x2A
+#define FLEXSPI_LUT_OPC_DATSZ_DDR          0x2B
+#define FLEXSPI_LUT_OPC_DUMMY_DDR          0x2C
+#define FLEXSPI_LUT_OPC_DUMMY_RWDS_DDR     0x2D
+
+/* Build a LUT instruction word from two instructions */
+#define FLEXSPI_LUT_INSTR(opc0, pads0, opr0, opc1, pads1, opr1) \
+  ( 0                                                           \
+  | BF_SET((uint32)(opr0),  FLEXSPI_LUT_OPERAND0_BF)            \
+  | BF_SET((uint32)(pads0), FLEXSPI_LUT_NUM_PADS0_BF)           \
+  | BF_SET((uint32)(opc0),  FLEXSPI_LUT_OPCODE0_BF)             \
+  | BF_SET((uint32)(opr1),  FLEXSPI_LUT_OPERAND1_BF)            \
+  | BF_SET((uint32)(pads1), FLEXSPI_LUT_NUM_PADS1_BF)           \
+  | BF_SET((uint32)(opc1),  FLEXSPI_LUT_OPCODE1_BF)             \
+  )
+
+#endif /* IMXRT_FLEXSPI_H */
@@ -202,6 +202,7 @@
 
 /* Aliases */
 #define MUXCONF_LPUART1_RX__GPIO_AD_B0_13_ALT2_OFFS      MUXCONF_GPIO_AD_B0_13_OFFS
+#define MUXCONF_GPIO1_IO13__GPIO_AD_B0_13_ALT5_OFFS      MUXCONF_GPIO_AD_B0_13_OFFS
 
 #define MUXCONF_GPIO_AD_B0_14_OFFS   0x0F4 /*!<  */
 #define MUXCONF_GPIO_AD_B0_15_OFFS   0x0F8 /*!<  */
@@ -448,6 +449,7 @@ enum
 
 /* Aliases */
 #define PADCONF_LPUART1_RX__GPIO_AD_B0_13_ALT2_OFFS      PADCONF_GPIO_AD_B0_13_OFFS
+#define PADCONF_GPIO1_IO13__GPIO_AD_B0_13_ALT5_OFFS      PADCONF_GPIO_AD_B0_13_OFFS
 
 #define PADCONF_GPIO_AD_B0_14_OFFS   0x2E4 /*!<  */
 #define PADCONF_GPIO_AD_B0_15_OFFS   0x2E8 /*!<  */
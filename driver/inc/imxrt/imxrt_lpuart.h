@@ -13,7 +13,7 @@
 #define LPUART_PARAM_OFFS      0x004
 
 #define LPUART_PARAM_RXFIFO_BF  8,  8
-#define LPUART_PARAM_TXFIFO_BF  1,  8
+#define LPUART_PARAM_TXFIFO_BF  0,  8
 
 /* LPUART Global Register */
 #define LPUART_GLOBAL_OFFS     0x008
@@ -95,10 +95,41 @@
 
 /* LPUART Data Register */
 #define LPUART_DATA_OFFS       0x01C
+
+#define LPUART_DATA_NOISY_BF      15, 1
+#define LPUART_DATA_PARITYE_BF    14, 1
+#define LPUART_DATA_FRETSC_BF     13, 1
+#define LPUART_DATA_RXEMPT_BF     12, 1
+#define LPUART_DATA_IDLINE_BF     11, 1
+#define LPUART_DATA_DATA_BF        0, 10
+
 #define LPUART_MATCH_ADDR_OFFS 0x020
 #define LPUART_MODEM_IRDA_OFFS 0x024
+
+/* LPUART FIFO Register */
 #define LPUART_FIFO_OFFS       0x028
+
+#define LPUART_FIFO_TXEMPT_BF     23, 1
+#define LPUART_FIFO_RXEMPT_BF     22, 1
+#define LPUART_FIFO_TXOF_BF       17, 1
+#define LPUART_FIFO_RXUF_BF       16, 1
+#define LPUART_FIFO_TXFLUSH_BF    15, 1
+#define LPUART_FIFO_RXFLUSH_BF    14, 1
+#define LPUART_FIFO_RXIDEN_BF     10, 3
+#define LPUART_FIFO_TXOFE_BF       9, 1
+#define LPUART_FIFO_RXUFE_BF       8, 1
+#define LPUART_FIFO_TXFE_BF        7, 1
+#define LPUART_FIFO_TXFIFOSIZE_BF  4, 3
+#define LPUART_FIFO_RXFE_BF        3, 1
+#define LPUART_FIFO_RXFIFOSIZE_BF  0, 3
+
+/* LPUART Watermark Register */
 #define LPUART_WATER_MARK_OFFS 0x02C
 
+#define LPUART_WATER_RXCOUNT_BF   24, 3
+#define LPUART_WATER_RXWATER_BF   16, 2
+#define LPUART_WATER_TXCOUNT_BF    8, 3
+#define LPUART_WATER_TXWATER_BF    0, 2
+
 #endif /* IMXRT_LPUART_H */
 
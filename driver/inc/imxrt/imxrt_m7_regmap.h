@@ -68,6 +68,10 @@
 /* Central Security Unit */
 #define CSU_BASE               (AIPS1_BASE + 0x000DC000)
 
+/* Enhanced Direct Memory Access Controller */
+#define EDMA_BASE              (AIPS2_BASE + 0x000E8000)
+#define DMAMUX_BASE            (AIPS2_BASE + 0x000EC000)
+
 /* Data Co-Processor  */
 #define DCP_BASE               (AIPS3_BASE + 0x000FC000)
 
@@ -112,6 +116,10 @@
 /* Data Co-Processor with Cryptographic Accelleration (DCP) */
 #define DCP_BASE                 (AIPS3_BASE + 0x000FC000)
 
+/* Flexible Serial Peripheral Interface (FlexSPI) */
+#define FLEXSPI_BASE             (AIPS3_BASE + 0x000A8000)
+#define FLEXSPI2_BASE            (AIPS3_BASE + 0x000A4000)
+
 /* True Random Number Generator (TRNG) */
 #define TRNG_BASE                (AIPS1_BASE + 0x000CC000)
 
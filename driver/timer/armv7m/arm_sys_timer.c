@@ -56,6 +56,21 @@ void arm_initSysTimer(uint32 clock, uint32 interval)
 }
 
 
+/*
+ ******************************************************************************
+ *
+ ******************************************************************************
+ * Enable the timer interrupt, which executes the sys timer callback.
+ *
+ ******************************************************************************
+ */
+
+void arm_enableSysTimerIrq(void)
+{
+  REG32_WRBF_BASE_OFFS(1, ARMV7_M_SYS_TIM_BASE, SYS_TIM_CTRL_OFFS, SYS_TIM_IRQ_ENA_BF);
+}
+
+
 /*
  ******************************************************************************
  *
@@ -6,6 +6,7 @@ typedef void (T_SYS_TICK_CBK)(void);
 
 
 extern void arm_initSysTimer(uint32 clock, uint32 interval);
+extern void arm_enableSysTimerIrq(void);
 extern uint32 arm_pollSysTimer(void);
 extern uint32 arm_getSysTimerCount(void);
 
@@ -8,10 +8,24 @@
 #define UART_CTL_ID_UART1           (0u)
 #define UART_CTL_ID_UART3           (2u)
 
+/* Reference clock of the baud rate generators (OSC 24MHz, PODF=0) */
+#define UART_REF_CLK_FREQ        (24000000u)
+
 /* define COM UART dependent stuff */
 #define UART1_BAUDRATE           115200u
 #define UART1_TX_BUF_SIZE        (256u)
-#define UART1_RX_BUF_SIZE        (1088u)
+/* The receive buffer holds a worst case FBL frame, i.e. a 1K block request
+ * with all bytes escaped: 2 * (1024 + 16) + 2 = 2082 bytes. So a frame
+ * received while the FBL task is blocked by a flash erase isn't lost.
+ */
+#define UART1_RX_BUF_SIZE        (2112u)
+#define UART1_RX_DMA_CHAN        (0u)
+#define UART1_TX_DMA_CHAN        (1u)
+#if (COM_UART_DMA == STD_ON)
+#define UART1_DMA_MODE           (UART_DMA_RX | UART_DMA_TX)
+#else
+#define UART1_DMA_MODE           (UART_DMA_NONE)
+#endif /* (COM_UART_DMA == STD_ON) */
 
 /* define DBG UART dependent stuff */
 #define UART3_BAUDRATE           115200u
@@ -151,6 +165,10 @@ const T_UART_CTL_DESC uart_ctlDevDescTbl[UART_NUM_DEVS_USED] =
     .rxBuffer = uart1_rxBuf,
     .txBufSize = sizeof(uart1_txBuf),
     .rxBufSize = sizeof(uart1_rxBuf),
+    .rxDmaChan = UART1_RX_DMA_CHAN,
+    .txDmaChan = UART1_TX_DMA_CHAN,
+    .rxDmaSrc = DMAMUX_SRC_LPUART1_RX,
+    .txDmaSrc = DMAMUX_SRC_LPUART1_TX,
   },
 };
 
@@ -181,6 +199,10 @@ const T_UART_CTL_CFG uart_ctlDevCfgTbl[UART_NUM_DEVS_USED] =
     .opMode = (UART_OPMODE_RX | UART_OPMODE_TX),
     .clkPolarity = 0,
     .clkPhase = 0,
+    .hwFifo = (UART_HWFIFO_RX | UART_HWFIFO_TX | UART_HWFIFO_IDLE),
+    .rxWater = 1,
+    .txWater = 1,
+    .idleCfg = 1,
   },
   [1] =
   {
@@ -197,6 +219,11 @@ const T_UART_CTL_CFG uart_ctlDevCfgTbl[UART_NUM_DEVS_USED] =
     .opMode = (UART_OPMODE_RX | UART_OPMODE_TX),
     .clkPolarity = 0,
     .clkPhase = 0,
+    .hwFifo = (UART_HWFIFO_RX | UART_HWFIFO_TX | UART_HWFIFO_IDLE),
+    .rxWater = 2,
+    .txWater = 1,
+    .idleCfg = 1,
+    .dmaMode = UART1_DMA_MODE,
   },
 };
 
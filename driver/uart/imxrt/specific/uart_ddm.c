@@ -3,6 +3,7 @@
 #endif /* UART_DDM_C */
 
 #include "bsp.h"
+#include "config.h"
 #include "uart_irq.h"
 #include "uart_prv.h"
 #include "uart_ddm.h"
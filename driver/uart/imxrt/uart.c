@@ -15,6 +15,13 @@
 #include <string.h> // for memset()
 
 
+/* Limits of the baud rate generator */
+#define UART_OSR_MIN        (4u)    /* Minimum oversampling ratio */
+#define UART_OSR_MAX        (32u)   /* Maximum oversampling ratio */
+#define UART_SBR_MAX        (8191u) /* Maximum modulo divider */
+#define UART_BAUD_TOLERANCE (3u)    /* Maximum baud rate deviation in % */
+
+
 enum UART_CTL_STATE
 {
    UART_CTL_STATE_eRESET = 0,
@@ -35,38 +42,112 @@ uint32 std_dev = 0;
 #endif /* (BSP_BOARD_TYPE) */
 
 
+/*!
+ ******************************************************************************
+ * Function: uart_calcSpeed
+ ******************************************************************************
+ * @par Description:
+ *   This function searches the oversampling ratio and modulo divider pair,
+ *   which gets closest to the requested baud rate.
+ *
+ *                  refFreq
+ * BaudRate = -------------------
+ *             (OSR + 1) x SBR
+ *
+ * @param baudrate - Requested baud rate
+ * @param osr - Resulting oversampling ratio as written to the register
+ * @param sbr - Resulting modulo divider
+ *
+ * @return status
+ *
+ * @retval UART_OK - divider found
+ * @retval UART_ERROR_FORMAT - baud rate can't be set up within tolerance
+ *
+ ******************************************************************************
+ */
+
+static T_STATUS uart_calcSpeed(uint32 baudrate, uint32* osr, uint32* sbr)
+{
+  T_STATUS stat = UART_ERROR_FORMAT;
+  uint32 bestDiff = 0xFFFFFFFFu;
+  uint32 ratio;
+
+  if( (0 == baudrate) || (baudrate > (UART_REF_CLK_FREQ / UART_OSR_MIN)) )
+  {
+    /* Baud rate out of range */
+  }
+  else
+  {
+    for(ratio = UART_OSR_MIN; ratio <= UART_OSR_MAX; ratio++)
+    {
+      uint32 div = (UART_REF_CLK_FREQ + ((baudrate * ratio) / 2)) / (baudrate * ratio);
+      uint32 actual;
+      uint32 diff;
+
+      if( (0 == div) || (div > UART_SBR_MAX) )
+      {
+        /* Divider can't be set up for this ratio */
+        continue;
+      }
+
+      actual = UART_REF_CLK_FREQ / (div * ratio);
+      diff = (actual > baudrate) ? (actual - baudrate) : (baudrate - actual);
+      if(diff < bestDiff)
+      {
+        bestDiff = diff;
+        *osr = ratio - 1;
+        *sbr = div;
+      }
+    }
+
+    /* Accept a deviation within tolerance only */
+    if((bestDiff * 100u) <= (baudrate * UART_BAUD_TOLERANCE))
+    {
+      stat = UART_OK;
+    }
+  }
+  return stat;
+}
+
+
 /*!
  ******************************************************************************
  * Function: uart_setSpeed
  ******************************************************************************
  * @par Description:
  *   This function changes UART registers to set up the speed of the clock
- *   generator.
+ *   generator. Transmitter and receiver have to be disabled by the caller.
  *
- * @param baudrate - ...
+ * @param base - Base address of the UART controller
+ * @param baudrate - Requested baud rate
  *
  * @return status
  *
  * @retval UART_OK - succeeding operation
- *
- *                 refFreq
- * BaudRate = -----------------
- *             (OSR + 1) x SBR
+ * @retval UART_ERROR_FORMAT - baud rate can't be set up
  *
  ******************************************************************************
  */
-// TODO: Check correctness
-void uart_setSpeed(uint32 base, uint32 clockVal)
+
+T_STATUS uart_setSpeed(uint32 base, uint32 baudrate)
 {
-//  uint32 clk = 80000000;
-  uint32 sbr = 8;
-  uint32 osr = 25;
+  T_STATUS stat;
+  uint32 sbr = 0;
+  uint32 osr = 0;
 
-  /*  */
-  REG32_WRBF_BASE_OFFS(osr, base, LPUART_BAUD_RATE_OFFS, LPUART_BAUD_OVER_SAMPLE_RATIO_BF);
+  stat = uart_calcSpeed(baudrate, &osr, &sbr);
+  if(UART_OK == stat)
+  {
+    /* Sampling on both edges is required for oversampling ratios below 8 */
+    REG32_WRBF_BASE_OFFS(((osr < 7) ? 1 : 0), base, LPUART_BAUD_RATE_OFFS, LPUART_BAUD_BOTH_EDGE_ENA_BF);
 
-  /*  */  
-  REG32_WRBF_BASE_OFFS(sbr, base, LPUART_BAUD_RATE_OFFS, LPUART_BAUD_RATE_MODULO_DIV_BF);
+    /*  */
+    REG32_WRBF_BASE_OFFS(osr, base, LPUART_BAUD_RATE_OFFS, LPUART_BAUD_OVER_SAMPLE_RATIO_BF);
+
+    /*  */  
+    REG32_WRBF_BASE_OFFS(sbr, base, LPUART_BAUD_RATE_OFFS, LPUART_BAUD_RATE_MODULO_DIV_BF);
+  }
+  return stat;
 }
 
 
@@ -770,6 +851,98 @@ T_STATUS uart_disTxBlocking(uint32 ctlID)
 }
 
 
+/*
+ ******************************************************************************
+ * Function: uart_setFifoConfig
+ ******************************************************************************
+ * @par Description:
+ *   This function sets up the transmitter's and receiver's hardware FIFOs
+ *   and their watermarks. It must be called while transmitter and receiver
+ *   are disabled.
+ *   The receiver watermark is only applied if the receiver is served by
+ *   interrupt, because polling relies on RDRF being set for every byte.
+ *
+ * @param base - Base address of the UART controller
+ * @param ctlData - Runtime data of the UART controller
+ * @param ctlCfg - Configuration to be applied
+ *
+ * @return Control register flags required by the FIFO configuration
+ *
+ ******************************************************************************
+ */
+
+static uint32 uart_setFifoConfig(uint32 base, T_UART_CTL_DATA* ctlData, const T_UART_CTL_CFG* ctlCfg)
+{
+  uint32 paramReg;
+  uint32 fifoReg = 0;
+  uint32 waterReg = 0;
+  uint32 coreCtrl = 0;
+  uint32 depth;
+  uint32 water;
+
+  ctlData->rxDepth = 0;
+  ctlData->txDepth = 0;
+
+  REG32_RD_BASE_OFFS(paramReg, base, LPUART_PARAM_OFFS);
+
+  if(0 != (ctlCfg->hwFifo & UART_HWFIFO_TX))
+  {
+    /* Transmitter FIFO is requested */
+    depth = 1 << BF_GET(paramReg, LPUART_PARAM_TXFIFO_BF);
+    water = (ctlCfg->txWater < depth) ? ctlCfg->txWater : (depth - 1);
+    fifoReg |= BF_SET(1, LPUART_FIFO_TXFE_BF);
+    waterReg |= BF_SET(water, LPUART_WATER_TXWATER_BF);
+    ctlData->txDepth = depth;
+  }
+
+  if(0 != (ctlCfg->hwFifo & UART_HWFIFO_RX))
+  {
+    /* Receiver FIFO is requested */
+    depth = 1 << BF_GET(paramReg, LPUART_PARAM_RXFIFO_BF);
+    water = (ctlCfg->rxWater < depth) ? ctlCfg->rxWater : (depth - 1);
+    if(NULL == ctlData->rxFifo.buffer)
+    {
+      /* Receiver is polled */
+      water = 0;
+    }
+    fifoReg |= BF_SET(1, LPUART_FIFO_RXFE_BF);
+    waterReg |= BF_SET(water, LPUART_WATER_RXWATER_BF);
+    ctlData->rxDepth = depth;
+  }
+
+  if(0 == (ctlCfg->hwFifo & UART_HWFIFO_IDLE))
+  {
+    /* No idle line interrupt requested */
+  }
+  else if( (NULL == ctlData->rxFifo.buffer) && (0 == (ctlData->dmaMode & UART_DMA_RX)) )
+  {
+    /* Receiver is polled, so no idle line interrupt required */
+  }
+  else
+  {
+    /* Flush remaining bytes below watermark when line becomes idle,
+     * a DMA receiver gets the end of the received data signalled only.
+     */
+    coreCtrl |= ( 0
+                | BF_SET(1, LPUART_CTRL_ILIE_BF)
+                | BF_SET(ctlCfg->idleCfg, LPUART_CTRL_IDLE_CFG_BF)
+                );
+  }
+
+  REG32_WR_BASE_OFFS(waterReg, base, LPUART_WATER_MARK_OFFS);
+  REG32_WR_BASE_OFFS(fifoReg, base, LPUART_FIFO_OFFS);
+
+  /* Flush FIFOs after enabling them */
+  fifoReg |= ( 0
+             | BF_SET(1, LPUART_FIFO_TXFLUSH_BF)
+             | BF_SET(1, LPUART_FIFO_RXFLUSH_BF)
+             );
+  REG32_WR_BASE_OFFS(fifoReg, base, LPUART_FIFO_OFFS);
+
+  return coreCtrl;
+}
+
+
 /*!
  ******************************************************************************
  * @fn uart_configCtl
@@ -777,7 +950,7 @@ T_STATUS uart_disTxBlocking(uint32 ctlID)
  * @par Description :
  *   This function configures the UART core.
  *
- * @param speed - Baud rate setting using UART_SPEED()
+ * @param baudrate - Baud rate
  * @param dataBits - Nuber of data bits per frame 5..8
  * @param stopBits - Number of stop bits per frame 1..2
  * @param parity - Parity (even/odd/none)
@@ -826,6 +999,10 @@ T_STATUS uart_configCtl(uint32 ctlID, const T_UART_CTL_CFG* ctlCfg)
   {
     stat = UART_ERROR_FORMAT;
   }
+  else if(UART_OK != uart_checkBaudrate(ctlID, ctlCfg->baudrate))
+  {
+    stat = UART_ERROR_FORMAT;
+  }
   else
   {
     uint32 coreCtrl = 0;
@@ -839,11 +1016,18 @@ T_STATUS uart_configCtl(uint32 ctlID, const T_UART_CTL_CFG* ctlCfg)
     ctlData->flags = ctlCfg->flags;
     
     /* Set UART baud rate generator speed */
-    uart_setSpeed(base, ctlCfg->speed);
+    uart_setSpeed(base, ctlCfg->baudrate);
+    ctlData->baudrate = ctlCfg->baudrate;
 
     /* Set frame/data format */
 //    uart_setFormat(base, UART_FORMAT(ctlCfg->dataBits, ctlCfg->stopBits, ctlCfg->parity, ctlCfg->opMode & UART_MODE_POL_MASK));
 
+    /* Set up DMA transfers */
+    uart_setDmaConfig(base, ctlData, ctlCfg);
+
+    /* Set up hardware FIFOs and watermarks */
+    coreCtrl |= uart_setFifoConfig(base, ctlData, ctlCfg);
+
     /* Check whether RX fifo is used */
     if(NULL != ctlData->rxFifo.buffer)
     {
@@ -876,6 +1060,178 @@ T_STATUS uart_configCtl(uint32 ctlID, const T_UART_CTL_CFG* ctlCfg)
 }
 
 
+/*!
+ ******************************************************************************
+ * @fn uart_setEventCallback
+ ******************************************************************************
+ * @par Description :
+ *   This function sets the callback, which is executed by the interrupt
+ *   handler to report received data or a drained transmit buffer. Thus
+ *   the callback must be short and shall only signal the event.
+ *
+ * @param devID - UART device ID
+ * @param evtCbk - Event callback, NULL to disable
+ *
+ * @return status
+ *
+ * @retval UART_OK - succeeding operation
+ * @retval UART_ERROR_INVALID - invalid device ID
+ *
+ ******************************************************************************
+ */
+
+T_STATUS uart_setEventCallback(uint32 devID, T_UART_EVT_CBK evtCbk)
+{
+  T_UART_CTL_DATA* ctlData;
+  T_STATUS stat;
+
+  ctlData = uart_getDevData(devID);
+  if(NULL == ctlData)
+  {
+    stat = UART_ERROR_INVALID;
+  }
+  else
+  {
+    ctlData->evtCbk = evtCbk;
+    stat = UART_OK;
+  }
+  return stat;
+}
+
+
+/*!
+ ******************************************************************************
+ * @fn uart_checkBaudrate
+ ******************************************************************************
+ * @par Description :
+ *   This function checks whether the baud rate generator of the given device
+ *   is able to set up the requested baud rate.
+ *
+ * @param devID - UART device ID
+ * @param baudrate - Requested baud rate
+ *
+ * @return status
+ *
+ * @retval UART_OK - baud rate is supported
+ * @retval UART_ERROR_FORMAT - baud rate is not supported
+ * @retval UART_ERROR_INVALID - invalid device ID
+ *
+ ******************************************************************************
+ */
+
+T_STATUS uart_checkBaudrate(uint32 devID, uint32 baudrate)
+{
+  T_STATUS stat;
+  uint32 sbr;
+  uint32 osr;
+
+  if(0 == uart_getDevBase(devID))
+  {
+    stat = UART_ERROR_INVALID;
+  }
+  else
+  {
+    stat = uart_calcSpeed(baudrate, &osr, &sbr);
+  }
+  return stat;
+}
+
+
+/*!
+ ******************************************************************************
+ * @fn uart_setBaudrate
+ ******************************************************************************
+ * @par Description :
+ *   This function changes the baud rate of an already configured device.
+ *   Transmitter and receiver are disabled while the divider is changed,
+ *   so the call is refused as long as data is pending to be transmitted.
+ *   The content of the receive buffer is kept.
+ *
+ * @param devID - UART device ID
+ * @param baudrate - New baud rate
+ *
+ * @return status
+ *
+ * @retval UART_OK - succeeding operation
+ * @retval UART_ERROR_TX_BUSY - transmission is pending
+ * @retval UART_ERROR_FORMAT - baud rate is not supported
+ * @retval UART_ERROR_INVALID - invalid device ID
+ *
+ ******************************************************************************
+ */
+
+T_STATUS uart_setBaudrate(uint32 devID, uint32 baudrate)
+{
+  T_UART_CTL_DATA* ctlData;
+  T_STATUS stat;
+  uint32 base;
+  uint32 coreCtrl;
+
+  ctlData = uart_getDevData(devID);
+  base = uart_getDevBase(devID);
+  if(NULL == ctlData)
+  {
+    stat = UART_ERROR_INVALID;
+  }
+  else if(0 == base)
+  {
+    stat = UART_ERROR_INVALID;
+  }
+  else if(UART_OK != uart_checkBaudrate(devID, baudrate))
+  {
+    stat = UART_ERROR_FORMAT;
+  }
+  else if(FALSE != uart_isTxBusy(devID))
+  {
+    stat = UART_ERROR_TX_BUSY;
+  }
+  else
+  {
+    /* Disable transmitter and receiver while changing the divider */
+    REG32_RD_BASE_OFFS(coreCtrl, base, LPUART_CTRL_OFFS);
+    REG32_WR_BASE_OFFS(coreCtrl & ~( 0
+                                   | BF_MASK(LPUART_CTRL_TE_BF)
+                                   | BF_MASK(LPUART_CTRL_RE_BF)
+                                   ), base, LPUART_CTRL_OFFS);
+
+    stat = uart_setSpeed(base, baudrate);
+    ctlData->baudrate = baudrate;
+
+    /* Restore transmitter and receiver */
+    REG32_WR_BASE_OFFS(coreCtrl, base, LPUART_CTRL_OFFS);
+  }
+  return stat;
+}
+
+
+/*!
+ ******************************************************************************
+ * @fn uart_getBaudrate
+ ******************************************************************************
+ * @par Description :
+ *   This function returns the baud rate currently set up for the device.
+ *
+ * @param devID - UART device ID
+ *
+ * @return baud rate, 0 if the device isn't configured
+ *
+ ******************************************************************************
+ */
+
+uint32 uart_getBaudrate(uint32 devID)
+{
+  T_UART_CTL_DATA* ctlData;
+  uint32 baudrate = 0;
+
+  ctlData = uart_getDevData(devID);
+  if(NULL != ctlData)
+  {
+    baudrate = ctlData->baudrate;
+  }
+  return baudrate;
+}
+
+
 /*
  ******************************************************************************
  * @fn uart_recvByte
@@ -917,6 +1273,11 @@ T_STATUS uart_recvByte(uint32 devID, uint8* rxByte)
   {
     drvStat = UART_ERROR_INVALID;
   }
+  else if(0 != (ctlData->dmaMode & UART_DMA_RX))
+  {
+    /* Receiver uses circular DMA buffer */
+    drvStat = uart_dmaRecvByte(ctlData, rxByte);
+  }
   else if(NULL != ctlData->rxFifo.buffer)
   {
     /* Receiver uses software FIFO */
@@ -1083,6 +1444,10 @@ sint16 uart_getRxFifoFill(uint32 ctlID)
   {
     /* Invalid device ID */
   }
+  else if(0 != (ctlData->dmaMode & UART_DMA_RX))
+  {
+    result = dring_getFill(&ctlData->rxRing);
+  }
   else if(ctlData->rxFifo.buffer != NULL)
   {
     result = rbuf_getFill(&ctlData->rxFifo);
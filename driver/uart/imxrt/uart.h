@@ -57,6 +57,24 @@ enum UART_OP_MODE
 /* Parity mask */
 #define UART_PARITY_MASK   0x30
 
+/* Hardware FIFO flags */
+#define UART_HWFIFO_NONE   0x00
+#define UART_HWFIFO_RX     0x01 /* Use receiver FIFO */
+#define UART_HWFIFO_TX     0x02 /* Use transmitter FIFO */
+#define UART_HWFIFO_IDLE   0x04 /* Use idle line interrupt to flush RX FIFO */
+
+/* Events reported by the event callback */
+#define UART_EVT_RX        0x01 /* Data received into the receive buffer */
+#define UART_EVT_TX_EMPTY  0x02 /* Transmit buffer ran empty */
+
+/* Event callback, executed in interrupt context */
+typedef void (*T_UART_EVT_CBK)(uint32 devID, uint32 evt);
+
+/* DMA flags */
+#define UART_DMA_NONE      0x00
+#define UART_DMA_RX        0x01 /* Receive into circular DMA buffer */
+#define UART_DMA_TX        0x02 /* Transmit blocks by DMA */
+
 
 
 /*! Structure for UART controller configuration data */
@@ -72,6 +90,11 @@ typedef struct
   uint8  mode;
   uint8  clkPolarity;
   uint8  clkPhase;
+  uint8  hwFifo;   /*!< Hardware FIFO flags UART_HWFIFO_xxx */
+  uint8  rxWater;  /*!< RX interrupt is raised if more than rxWater bytes are in the FIFO */
+  uint8  txWater;  /*!< TX interrupt is raised if txWater or less bytes are in the FIFO */
+  uint8  idleCfg;  /*!< Idle line interrupt after 2^idleCfg idle characters */
+  uint8  dmaMode;  /*!< DMA flags UART_DMA_xxx */
 }T_UART_CTL_CFG;
 
 
@@ -79,10 +102,20 @@ typedef struct
 extern void uart_initDev(uint32 devID);
 extern T_STATUS uart_configCtl(uint32 devID, const T_UART_CTL_CFG* ctlCfg);
 
-void uart_setSpeed(uint32 devID, uint32 clockSpeed);
+extern T_STATUS uart_checkBaudrate(uint32 devID, uint32 baudrate);
+extern T_STATUS uart_setBaudrate(uint32 devID, uint32 baudrate);
+extern uint32 uart_getBaudrate(uint32 devID);
+
 extern T_STATUS uart_recvByte(uint32 devID, uint8* rxByte);
 extern T_STATUS uart_sendByte(uint32 devID, uint8 txByte);
 
+extern T_STATUS uart_setEventCallback(uint32 devID, T_UART_EVT_CBK evtCbk);
+
+extern T_STATUS uart_sendBlock(uint32 devID, const uint8* txData, uint16 len);
+extern boolean uart_isTxBusy(uint32 devID);
+extern T_STATUS uart_recvBlock(uint32 devID, const uint8** rxData, uint16* len);
+extern void uart_releaseBlock(uint32 devID, uint16 len);
+
 int  uart_bufWrite(uint32 devID, const uint8* buf, uint32 len);
 
 void uart_setStdDev(uint32 devID);
@@ -0,0 +1,416 @@
+#ifndef UART_DMA_C
+#define UART_DMA_C
+#endif /* UART_DMA_C */
+
+#include "bsp.h"
+#include "reg.h"
+#include "edma.h"
+#include "cpu_cache.h"
+#include "uart_prv.h"
+#include "uart_ddm.h"
+
+
+/* Note:
+ *   The DMA buffers are accessed by the eDMA engine directly, so the data
+ *   cache is maintained around the transfers.
+ */
+
+
+/*
+ ******************************************************************************
+ * Function: uart_setDmaConfig
+ ******************************************************************************
+ * @par Description:
+ *   This function sets up the DMA transfers requested by the configuration.
+ *   The receiver writes into the device's receive buffer circularly, which
+ *   replaces the interrupt driven software FIFO. The transmitter channel
+ *   is set up per block by uart_sendBlock().
+ *   The eDMA controller must have been initialized by edma_initDev().
+ *
+ * @param base - Base address of the UART controller
+ * @param ctlData - Runtime data of the UART controller
+ * @param ctlCfg - Configuration to be applied
+ *
+ * @return none
+ *
+ ******************************************************************************
+ */
+
+void uart_setDmaConfig(uint32 base, T_UART_CTL_DATA* ctlData, const T_UART_CTL_CFG* ctlCfg)
+{
+  const T_UART_CTL_DESC* ctlDesc = ctlData->props;
+  T_EDMA_XFER_CFG xferCfg;
+
+  ctlData->dmaMode = ctlCfg->dmaMode & (UART_DMA_RX | UART_DMA_TX);
+  dring_init(&ctlData->rxRing, NULL, 0);
+
+  if(0 == (ctlData->dmaMode & UART_DMA_RX))
+  {
+    /* Receiver doesn't use DMA */
+  }
+  else if( (NULL == ctlDesc->rxBuffer) || (0 == ctlDesc->rxBufSize) )
+  {
+    /* No receive buffer available */
+    ctlData->dmaMode &= ~UART_DMA_RX;
+  }
+  else
+  {
+    /* Receive circularly into the device's receive buffer */
+    xferCfg.srcAddr = base + LPUART_DATA_OFFS;
+    xferCfg.srcOffs = 0;
+    xferCfg.srcLast = 0;
+    xferCfg.dstAddr = (uint32)ctlDesc->rxBuffer;
+    xferCfg.dstOffs = 1;
+    xferCfg.dstLast = -(sint32)ctlDesc->rxBufSize;
+    xferCfg.numIter = ctlDesc->rxBufSize;
+    xferCfg.numBytes = 1;
+    xferCfg.xferSize = EDMA_TCD_ATTR_SIZE_8BIT;
+    xferCfg.muxSrc = ctlDesc->rxDmaSrc;
+    xferCfg.flags = 0;
+
+    if(STATUS_eOK != edma_setupChannel(ctlDesc->rxDmaChan, &xferCfg))
+    {
+      /* Fall back to interrupt driven receiver */
+      ctlData->dmaMode &= ~UART_DMA_RX;
+    }
+    else
+    {
+      /* The buffer is owned by DMA now, so remove software FIFO */
+      rbuf_init(&ctlData->rxFifo, NULL, 0, NULL, NULL);
+      dring_init(&ctlData->rxRing, ctlDesc->rxBuffer, ctlDesc->rxBufSize);
+
+      REG32_WRBF_BASE_OFFS(1, base, LPUART_BAUD_RATE_OFFS, LPUART_BAUD_RX_DMA_ENA_BF);
+      edma_startChannel(ctlDesc->rxDmaChan);
+    }
+  }
+
+  if(0 == (ctlData->dmaMode & UART_DMA_TX))
+  {
+    /* Transmitter doesn't use DMA */
+  }
+  else
+  {
+    /* Channel is set up with the first block */
+    edma_stopChannel(ctlDesc->txDmaChan);
+  }
+}
+
+
+/*
+ ******************************************************************************
+ * Function: uart_dmaSampleRx
+ ******************************************************************************
+ * @par Description:
+ *   This function samples the write position of the circular DMA receive
+ *   buffer and drops the stale cached data of the buffer.
+ *
+ * @param ctlData - Runtime data of the UART controller
+ *
+ * @return none
+ *
+ ******************************************************************************
+ */
+
+static void uart_dmaSampleRx(T_UART_CTL_DATA* ctlData)
+{
+  uint16 remaining;
+
+  remaining = edma_getRemaining(ctlData->props->rxDmaChan);
+  if(DRING_OK != dring_update(&ctlData->rxRing, remaining))
+  {
+    /* Unread data was overwritten */
+    ctlData->error |= UART_ERROR_DATA_LOST;
+    ctlData->lostBytes++;
+  }
+
+  /* Drop stale cached data of the receive buffer */
+  cpu_invalidateDCacheRange((uint32)(void*)ctlData->rxRing.buffer, ctlData->rxRing.size);
+}
+
+
+/*
+ ******************************************************************************
+ * Function: uart_dmaRecvByte
+ ******************************************************************************
+ * @par Description:
+ *   This function reads the next byte from the circular DMA receive buffer.
+ *   The DMA write position is only sampled if all data up to the previously
+ *   sampled position has been consumed.
+ *
+ * @param ctlData - Runtime data of the UART controller
+ * @param rxByte - Received byte
+ *
+ * @return Status
+ *
+ * @retval UART_OK
+ * @retval UART_ERROR_RX_EMPTY
+ *
+ ******************************************************************************
+ */
+
+T_STATUS uart_dmaRecvByte(T_UART_CTL_DATA* ctlData, uint8* rxByte)
+{
+  T_STATUS drvStat = UART_OK;
+
+  if(DRING_OK == dring_rdByte(&ctlData->rxRing, rxByte))
+  {
+    /* Byte available from last sample */
+  }
+  else
+  {
+    uart_dmaSampleRx(ctlData);
+
+    if(DRING_OK != dring_rdByte(&ctlData->rxRing, rxByte))
+    {
+      /* Nothing received */
+      drvStat = UART_ERROR_RX_EMPTY;
+    }
+  }
+  return drvStat;
+}
+
+
+/*
+ ******************************************************************************
+ * Function: uart_recvBlock
+ ******************************************************************************
+ * @par Description:
+ *   This function provides the received data in place of the circular DMA
+ *   receive buffer, up to the sampled write position or the end of the
+ *   buffer. The DMA write position is only sampled if all data up to the
+ *   previously sampled position has been consumed.
+ *   The data stays valid until it is released by uart_releaseBlock(), so
+ *   it must be processed before the DMA transfer completes another lap.
+ *
+ * @param devID - UART device ID
+ * @param rxData - Start of the received data
+ * @param len - Number of bytes received contiguously
+ *
+ * @return Status
+ *
+ * @retval UART_OK
+ * @retval UART_ERROR_RX_EMPTY
+ * @retval UART_ERROR_INVALID
+ *
+ ******************************************************************************
+ */
+
+T_STATUS uart_recvBlock(uint32 devID, const uint8** rxData, uint16* len)
+{
+  T_UART_CTL_DATA* ctlData;
+  T_STATUS drvStat = UART_ERROR_INVALID;
+
+  /* Get pointer to controller device's runtime data */
+  ctlData = uart_getDevData(devID);
+  if(NULL == ctlData)
+  {
+    /* Invalid device ID */
+  }
+  else if(0 == (ctlData->dmaMode & UART_DMA_RX))
+  {
+    /* Receiver doesn't use DMA */
+  }
+  else
+  {
+    *len = dring_getBlock(&ctlData->rxRing, rxData);
+    if(0 == *len)
+    {
+      uart_dmaSampleRx(ctlData);
+      *len = dring_getBlock(&ctlData->rxRing, rxData);
+    }
+    drvStat = (0 == *len) ? UART_ERROR_RX_EMPTY : UART_OK;
+  }
+  return drvStat;
+}
+
+
+/*
+ ******************************************************************************
+ * Function: uart_releaseBlock
+ ******************************************************************************
+ * @par Description:
+ *   This function releases the given number of bytes provided by
+ *   uart_recvBlock() after they have been processed.
+ *
+ * @param devID - UART device ID
+ * @param len - Number of bytes processed
+ *
+ * @return none
+ *
+ ******************************************************************************
+ */
+
+void uart_releaseBlock(uint32 devID, uint16 len)
+{
+  T_UART_CTL_DATA* ctlData;
+
+  /* Get pointer to controller device's runtime data */
+  ctlData = uart_getDevData(devID);
+  if(NULL == ctlData)
+  {
+    /* Invalid device ID */
+  }
+  else if(0 == (ctlData->dmaMode & UART_DMA_RX))
+  {
+    /* Receiver doesn't use DMA */
+  }
+  else
+  {
+    dring_release(&ctlData->rxRing, len);
+  }
+}
+
+
+/*
+ ******************************************************************************
+ * Function: uart_sendBlock
+ ******************************************************************************
+ * @par Description:
+ *   This function starts transmitting the given block by DMA. The block
+ *   must not be modified until uart_isTxBusy() reports the transmitter to
+ *   be idle.
+ *
+ * @param devID - UART device ID
+ * @param txData - Data to be transmitted
+ * @param len - Number of bytes to be transmitted
+ *
+ * @return Status
+ *
+ * @retval UART_OK
+ * @retval UART_ERROR_TX_BUSY
+ * @retval UART_ERROR_INVALID
+ *
+ ******************************************************************************
+ */
+
+T_STATUS uart_sendBlock(uint32 devID, const uint8* txData, uint16 len)
+{
+  const T_UART_CTL_DESC* ctlDesc;
+  T_UART_CTL_DATA* ctlData;
+  T_EDMA_XFER_CFG xferCfg;
+  T_STATUS drvStat = UART_ERROR_INVALID;
+  uint32 base;
+
+  /* Get pointer to controller device's runtime data */
+  ctlData = uart_getDevData(devID);
+  base = uart_getDevBase(devID);
+  if(NULL == ctlData)
+  {
+    /* Invalid device ID */
+  }
+  else if(0 == base)
+  {
+    /* Invalid device ID */
+  }
+  else if(0 == (ctlData->dmaMode & UART_DMA_TX))
+  {
+    /* Transmitter doesn't use DMA */
+  }
+  else if( (NULL == txData) || (0 == len) )
+  {
+    /* Invalid block */
+  }
+  else if(FALSE != uart_isTxBusy(devID))
+  {
+    /* Previous transmission not finished */
+    drvStat = UART_ERROR_TX_BUSY;
+  }
+  else
+  {
+    ctlDesc = ctlData->props;
+
+    /* eDMA reads the block from memory */
+    cpu_cleanDCacheRange((uint32)(void*)txData, len);
+
+    xferCfg.srcAddr = (uint32)txData;
+    xferCfg.srcOffs = 1;
+    xferCfg.srcLast = 0;
+    xferCfg.dstAddr = base + LPUART_DATA_OFFS;
+    xferCfg.dstOffs = 0;
+    xferCfg.dstLast = 0;
+    xferCfg.numIter = len;
+    xferCfg.numBytes = 1;
+    xferCfg.xferSize = EDMA_TCD_ATTR_SIZE_8BIT;
+    xferCfg.muxSrc = ctlDesc->txDmaSrc;
+    xferCfg.flags = EDMA_CHAN_FLAG_ONESHOT;
+
+    if(STATUS_eOK != edma_setupChannel(ctlDesc->txDmaChan, &xferCfg))
+    {
+      /* Block too large */
+      drvStat = UART_ERROR_INVALID;
+    }
+    else
+    {
+      ctlData->dmaMode |= UART_DMA_TX_ACTIVE;
+      REG32_WRBF_BASE_OFFS(1, base, LPUART_BAUD_RATE_OFFS, LPUART_BAUD_TX_DMA_ENA_BF);
+      edma_startChannel(ctlDesc->txDmaChan);
+      drvStat = UART_OK;
+    }
+  }
+  return drvStat;
+}
+
+
+/*
+ ******************************************************************************
+ * Function: uart_isTxBusy
+ ******************************************************************************
+ * @par Description:
+ *   This function checks whether the transmitter is still busy, i.e. a DMA
+ *   block is pending, the software FIFO isn't empty or the last byte is
+ *   still being shifted out.
+ *
+ * @param devID - UART device ID
+ *
+ * @return FALSE if the transmitter is idle
+ *
+ ******************************************************************************
+ */
+
+boolean uart_isTxBusy(uint32 devID)
+{
+  T_UART_CTL_DATA* ctlData;
+  boolean result = FALSE;
+  uint32 statReg;
+  uint32 base;
+
+  /* Get pointer to controller device's runtime data */
+  ctlData = uart_getDevData(devID);
+  base = uart_getDevBase(devID);
+  if(NULL == ctlData)
+  {
+    /* Invalid device ID */
+  }
+  else if(0 == base)
+  {
+    /* Invalid device ID */
+  }
+  else if( (0 != (ctlData->dmaMode & UART_DMA_TX_ACTIVE)) &&
+           (FALSE == edma_isDone(ctlData->props->txDmaChan)) )
+  {
+    /* DMA block pending */
+    result = !FALSE;
+  }
+  else
+  {
+    if(0 != (ctlData->dmaMode & UART_DMA_TX_ACTIVE))
+    {
+      /* DMA block finished, so release transmitter */
+      REG32_WRBF_BASE_OFFS(0, base, LPUART_BAUD_RATE_OFFS, LPUART_BAUD_TX_DMA_ENA_BF);
+      ctlData->dmaMode &= ~UART_DMA_TX_ACTIVE;
+    }
+
+    REG32_RD_BASE_OFFS(statReg, base, LPUART_STATUS_OFFS);
+    if( (NULL != ctlData->txFifo.buffer) && (0 != rbuf_getFill(&ctlData->txFifo)) )
+    {
+      /* Software FIFO not empty */
+      result = !FALSE;
+    }
+    else if(0 == BF_GET(statReg, LPUART_STATUS_TXC_BF))
+    {
+      /* Transmission not complete */
+      result = !FALSE;
+    }
+  }
+  return result;
+}
@@ -7,6 +7,7 @@
 #include "uart_prv.h"
 #include "uart_ddm.h"
 #include "uart_irq.h"
+#include "cpu_tcm.h"
 
 
 #if !defined DRV_PANIC
@@ -16,68 +17,84 @@
 
 /*
  ******************************************************************************
- * Function: uart_irqHandler
+ * Function: uart_irqRecv
  ******************************************************************************
  * @par Description:
- *   This function implements the common UART interrupt handler,
- *   which is executed in order to tansmit/receive furher data from/to
- *   the ring buffer.
+ *   This function drains all bytes from the receiver's data register or
+ *   hardware FIFO into the ring buffer. It is executed on the receive
+ *   interrupt as well as on the idle line interrupt, which flushes bytes
+ *   remaining below the FIFO's watermark at the end of a frame.
  *
- * @param none
+ * @param ctlData - Runtime data of the UART controller
+ * @param base - Base address of the UART controller
  *
- * @return none
+ * @return UART_EVT_RX if data was written to the ring buffer, 0 otherwise
  *
  ******************************************************************************
  */
 
-void uart_irqHandler(uint32 ctlID)
+__itcm_text static uint32 uart_irqRecv(T_UART_CTL_DATA* ctlData, uint32 base)
 {
-  T_UART_CTL_DATA* ctlData;
+  uint32 evt = 0;
   T_STATUS fifoStat;
-  uint32 base;
-  uint32 ctrlReg;
+  uint32 statReg;
+  uint32 waterReg;
+  uint32 dataReg;
   uint32 rxStat;
-  uint32 txStat;
+  uint32 numBytes;
   uint8  rxData;
-  uint8  txData;
 
-  /* Get pointer to controller device's runtime data */
-  ctlData = uart_getDevData(ctlID);
-  base = uart_getDevBase(ctlID);
-  if(NULL == ctlData)
+  /* Clear idle line flag before counting bytes, so bytes
+   * arriving afterwards will raise a new interrupt.
+   */
+  REG32_RD_BASE_OFFS(statReg, base, LPUART_STATUS_OFFS);
+  if(0 != (statReg & BF_MASK(LPUART_STATUS_IDLE_BF)))
   {
-    DRV_PANIC();
+    REG32_WR_BASE_OFFS(BF_MASK(LPUART_STATUS_IDLE_BF), base, LPUART_STATUS_OFFS);
   }
-  else if(0 == base)
+
+  /* Retrieve receiver status */
+  uart_getRxStat(base, &rxStat);
+
+  if(0 == ctlData->rxDepth)
   {
-    DRV_PANIC();
+    /* No hardware FIFO, so at most one byte is available */
+    numBytes = BF_GET(rxStat, LPUART_STATUS_RDRF_BF);
   }
   else
   {
-    /* Retrieve receiver status */
-    uart_getRxStat(base, &rxStat);
+    REG32_RD_BASE_OFFS(waterReg, base, LPUART_WATER_MARK_OFFS);
+    numBytes = BF_GET(waterReg, LPUART_WATER_RXCOUNT_BF);
+  }
 
-    /* Check for receive interrupt */
-    if(0 != (rxStat & BF_MASK(LPUART_STATUS_RDRF_BF)))
-    {
-      uart_rxByte(base, ctlData->flags, &rxData);
-    }
-    else
-    {
-      /* No receive interrupt */
-    }
-    
-    /* Check for receive errors */
-    if(0 != (rxStat & ~(BF_MASK(LPUART_STATUS_RDRF_BF))))
+  /* Check for receive errors */
+  if(0 != (rxStat & ~(BF_MASK(LPUART_STATUS_RDRF_BF))))
+  {
+    /* Receiving error occured so data will be lost */
+    ctlData->error = rxStat;
+    uart_clrRxStat(base);
+  }
+  else
+  {
+    /* No receive error */
+    rxStat = 0;
+  }
+
+  while(0 < numBytes)
+  {
+    REG32_RD_BASE_OFFS(dataReg, base, LPUART_DATA_OFFS);
+    rxData = (uint8)dataReg;
+    numBytes--;
+
+    if(0 != rxStat)
     {
-      /* Receiving error occured so data will be lost */
-      ctlData->error = rxStat;
+      /* Discard data received along with errors */
       ctlData->lostBytes++;
-      uart_clrRxStat(base);
     }
-    else if(0 == (rxStat & BF_MASK(LPUART_STATUS_RDRF_BF)))
+    else if( ('\r' == rxData) &&
+             (0 != BF_GET(ctlData->flags, UART_DEV_DATA_FLAGS_CRLF_ENA_BF)) )
     {
-      /* Nothing received */
+      /* Char was CR and mode is CR/LF, so drop it */
     }
     else if(NULL != ctlData->rxFifo.buffer)
     {
@@ -95,6 +112,7 @@ void uart_irqHandler(uint32 ctlID)
       else
       {
         /* Sucessfully written to ring buffer */
+        evt = UART_EVT_RX;
       }
     }
     else
@@ -103,39 +121,196 @@ void uart_irqHandler(uint32 ctlID)
       ctlData->error |= UART_ERROR_DATA_LOST;
       ctlData->lostBytes++;
     }
+  }
+  return evt;
+}
+
+
+/*
+ ******************************************************************************
+ * Function: uart_irqIdle
+ ******************************************************************************
+ * @par Description:
+ *   This function serves the idle line interrupt of a receiver using a
+ *   circular DMA buffer. The data is moved by DMA, so the idle line only
+ *   signals the end of the received data.
+ *
+ * @param base - Base address of the UART controller
+ *
+ * @return UART_EVT_RX if the line became idle, 0 otherwise
+ *
+ ******************************************************************************
+ */
+
+__itcm_text static uint32 uart_irqIdle(uint32 base)
+{
+  uint32 evt = 0;
+  uint32 statReg;
+
+  REG32_RD_BASE_OFFS(statReg, base, LPUART_STATUS_OFFS);
+  if(0 != (statReg & BF_MASK(LPUART_STATUS_IDLE_BF)))
+  {
+    REG32_WR_BASE_OFFS(BF_MASK(LPUART_STATUS_IDLE_BF), base, LPUART_STATUS_OFFS);
+    evt = UART_EVT_RX;
+  }
+  return evt;
+}
+
+
+/*
+ ******************************************************************************
+ * Function: uart_irqXmit
+ ******************************************************************************
+ * @par Description:
+ *   This function fills the transmitter's data register or hardware FIFO
+ *   from the ring buffer. The transmit interrupt is disabled as soon as the
+ *   ring buffer runs empty.
+ *
+ * @param ctlData - Runtime data of the UART controller
+ * @param base - Base address of the UART controller
+ *
+ * @return UART_EVT_TX_EMPTY if the ring buffer ran empty, 0 otherwise
+ *
+ ******************************************************************************
+ */
+
+__itcm_text static uint32 uart_irqXmit(T_UART_CTL_DATA* ctlData, uint32 base)
+{
+  uint32 evt = 0;
+  T_STATUS fifoStat = RBUF_OK;
+  uint32 ctrlReg;
+  uint32 waterReg;
+  uint32 txStat;
+  uint32 numFree;
+  uint32 numReq;
+  uint8  txData;
 
-    /* Retrieve transmitter status */
-    uart_getTxStat(base, &txStat);
-    if(0 == txStat)
+  /* Retrieve transmitter status */
+  uart_getTxStat(base, &txStat);
+  if(0 == txStat)
+  {
+    /* No transmit interrupt */
+  }
+  else if(NULL == ctlData->txFifo.buffer)
+  {
+    /* No transmit fifo configured */
+    fifoStat = RBUF_ERROR_EMPTY;
+  }
+  else if(0 == ctlData->txDepth)
+  {
+    /* No hardware FIFO, so transmit a single byte */
+    fifoStat = rbuf_rdByte(&ctlData->txFifo, &txData);
+    if(RBUF_OK == fifoStat)
     {
-      /* No transmit interrupt */
+      /* Sucessfully read from ring buffer */
+      uart_txByte(base, ctlData->flags, txData);
     }
-    else if(NULL != ctlData->txFifo.buffer)
+  }
+  else
+  {
+    /* Fill hardware FIFO, reserve space for CR if needed */
+    numReq = (0 != BF_GET(ctlData->flags, UART_DEV_DATA_FLAGS_CRLF_ENA_BF)) ? 2 : 1;
+    REG32_RD_BASE_OFFS(waterReg, base, LPUART_WATER_MARK_OFFS);
+    numFree = ctlData->txDepth - BF_GET(waterReg, LPUART_WATER_TXCOUNT_BF);
+    while(numFree >= numReq)
     {
       fifoStat = rbuf_rdByte(&ctlData->txFifo, &txData);
       if(RBUF_OK != fifoStat)
       {
-        /* Ring buffer is empty, so disable transmit interrupt */
-        REG32_RD_BASE_OFFS(ctrlReg, base, LPUART_CTRL_OFFS);
-        ctrlReg &= ~( 0
-                    | BF_SET(1, LPUART_CTRL_TIE_BF)
-                    );
-        REG32_WR_BASE_OFFS(ctrlReg, base, LPUART_CTRL_OFFS);
+        /* Ring buffer is empty */
+        break;
       }
-      else
+      REG32_WR_BASE_OFFS(txData, base, LPUART_DATA_OFFS);
+      numFree--;
+
+      if( ('\n' == txData) && (2 == numReq) )
       {
-        /* Sucessfully read from ring buffer */
-        uart_txByte(base, ctlData->flags, txData);
+        /* Char was LF and mode is CR/LF */
+        REG32_WR_BASE_OFFS('\r', base, LPUART_DATA_OFFS);
+        numFree--;
       }
     }
+  }
+
+  if(RBUF_OK == fifoStat)
+  {
+    /* Possibly more data to transmit */
+  }
+  else
+  {
+    /* Ring buffer is empty, so disable transmit interrupt */
+    REG32_RD_BASE_OFFS(ctrlReg, base, LPUART_CTRL_OFFS);
+    if(0 != BF_GET(ctrlReg, LPUART_CTRL_TIE_BF))
+    {
+      /* Report only once, when the transmission ends */
+      evt = UART_EVT_TX_EMPTY;
+    }
+    ctrlReg &= ~( 0
+                | BF_SET(1, LPUART_CTRL_TIE_BF)
+                );
+    REG32_WR_BASE_OFFS(ctrlReg, base, LPUART_CTRL_OFFS);
+  }
+  return evt;
+}
+
+
+/*
+ ******************************************************************************
+ * Function: uart_irqHandler
+ ******************************************************************************
+ * @par Description:
+ *   This function implements the common UART interrupt handler,
+ *   which is executed in order to tansmit/receive furher data from/to
+ *   the ring buffer.
+ *   If hardware FIFOs are enabled, multiple bytes are handled per
+ *   interrupt. Received data and a drained transmit buffer are reported
+ *   by the event callback. A DMA receiver reports received data on the
+ *   idle line.
+ *
+ * @param none
+ *
+ * @return none
+ *
+ ******************************************************************************
+ */
+
+__itcm_text void uart_irqHandler(uint32 ctlID)
+{
+  T_UART_CTL_DATA* ctlData;
+  uint32 base;
+  uint32 evt;
+
+  /* Get pointer to controller device's runtime data */
+  ctlData = uart_getDevData(ctlID);
+  base = uart_getDevBase(ctlID);
+  if(NULL == ctlData)
+  {
+    DRV_PANIC();
+  }
+  else if(0 == base)
+  {
+    DRV_PANIC();
+  }
+  else
+  {
+    if(0 != (ctlData->dmaMode & UART_DMA_RX))
+    {
+      /* Receiver drained by DMA */
+      evt = uart_irqIdle(base);
+    }
     else
     {
-      /* No transmit fifo configured */
-      REG32_RD_BASE_OFFS(ctrlReg, base, LPUART_CTRL_OFFS);
-      ctrlReg &= ~( 0
-                  | BF_SET(1, LPUART_CTRL_TIE_BF)
-                  );
-      REG32_WR_BASE_OFFS(ctrlReg, base, LPUART_CTRL_OFFS);
+      /* Drain receiver */
+      evt = uart_irqRecv(ctlData, base);
+    }
+
+    /* Fill transmitter */
+    evt |= uart_irqXmit(ctlData, base);
+
+    if( (0 != evt) && (NULL != ctlData->evtCbk) )
+    {
+      /* Signal the event */
+      ctlData->evtCbk(ctlID, evt);
     }
   }
 }
@@ -150,7 +325,7 @@ void uart_irqHandler(uint32 ctlID)
  ******************************************************************************
  */
 
-void uart1_handler(void)
+__itcm_text void uart1_handler(void)
 {
   uart_irqHandler(0);
 }
@@ -165,7 +340,7 @@ void uart1_handler(void)
  ******************************************************************************
  */
 
-void uart2_handler(void)
+__itcm_text void uart2_handler(void)
 {
   uart_irqHandler(1);
 }
@@ -180,7 +355,7 @@ void uart2_handler(void)
  ******************************************************************************
  */
 
-void uart3_handler(void)
+__itcm_text void uart3_handler(void)
 {
   uart_irqHandler(2);
 }
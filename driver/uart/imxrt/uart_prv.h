@@ -5,6 +5,7 @@
 #include "ccm.h"   /* for T_CCM_CLK_CFG */
 #include "irqc.h"  /* For T_IRQC_IRQ_CFG */
 #include "rbuf.h"  /* for T_RBUF */
+#include "dring.h" /* for T_DRING */
 
 
 /*! Structure for UART controller device instance descriptor */
@@ -21,6 +22,10 @@ typedef struct
   uint8* rxBuffer;        /*!< Pointer to receive FIFO buffer */
   uint16 txBufSize;       /*!< Size of transmit FIFO buffer */
   uint16 rxBufSize;       /*!< Size of receive FIFO buffer */
+  uint8  rxDmaChan;       /*!< eDMA channel used for receiving */
+  uint8  txDmaChan;       /*!< eDMA channel used for transmitting */
+  uint8  rxDmaSrc;        /*!< DMAMUX request source of the receiver */
+  uint8  txDmaSrc;        /*!< DMAMUX request source of the transmitter */
 }T_UART_CTL_DESC;
 
 
@@ -32,9 +37,15 @@ typedef struct
   uint8  error;
   uint8  flags;
   uint16 lostBytes;
+  uint32 baudrate; /*!< Currently set up baud rate */
+  uint8  rxDepth; /*!< Depth of RX hardware FIFO, 0 if not used */
+  uint8  txDepth; /*!< Depth of TX hardware FIFO, 0 if not used */
+  uint8  dmaMode; /*!< DMA flags UART_DMA_xxx */
+  T_DRING rxRing; /*!< Controller of circular DMA receive buffer */
   T_RBUF txFifo; /*!< Controller of TX FIFO */
   T_RBUF rxFifo; /*!< Controller of RX FIFO */
   uint8  next;
+  void (*evtCbk)(uint32 devID, uint32 evt); /*!< Event callback, NULL if none */
   const T_UART_CTL_DESC* props;
 }T_UART_CTL_DATA;
 
@@ -42,6 +53,9 @@ typedef struct
 #define UART_DEV_DATA_FLAGS_FIFO_ENA_BF   1,  1
 #define UART_DEV_DATA_FLAGS_NOBLOCK_BF    2,  1
 
+/* Internal DMA flag, set while a DMA block is transmitted */
+#define UART_DMA_TX_ACTIVE 0x80
+
 #if 0
 /*! Structure for UART driver runtime data */
 typedef struct
@@ -59,7 +73,12 @@ void uart_getTxStat(uint32 base, uint32* txStat);
 void uart_clrTxStat(uint32 base);
 void uart_txByte(uint32 base, uint32 flags, uint8 txByte);
 void uart_rxByte(uint32 base, uint32 flags, uint8* rxByte);
+T_STATUS uart_setSpeed(uint32 base, uint32 baudrate);
 
 #include "uart.h"
+
+void uart_setDmaConfig(uint32 base, T_UART_CTL_DATA* ctlData, const T_UART_CTL_CFG* ctlCfg);
+T_STATUS uart_dmaRecvByte(T_UART_CTL_DATA* ctlData, uint8* rxByte);
+
 #endif /* UART_PRV_H */
 
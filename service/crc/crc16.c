@@ -4,6 +4,7 @@
 
 #include "bsp.h"
 #include "crc16.h"
+#include "cpu_tcm.h"
 
 
 /*!
@@ -139,7 +140,7 @@ void crc16_writeBE(T_CRC16_DATA* ctx, uint8 crc[2])
  ******************************************************************************
  */
 
-void crc16_updateNTabFwd(T_CRC16_DATA* ctx, const uint8* srcBuf, uint16 numBytes)
+__itcm_text void crc16_updateNTabFwd(T_CRC16_DATA* ctx, const uint8* srcBuf, uint16 numBytes)
 {
   uint8  hiByte;   /* CRC's MSB */
   sint8  bitMask;
@@ -193,7 +194,7 @@ void crc16_updateNTabFwd(T_CRC16_DATA* ctx, const uint8* srcBuf, uint16 numBytes
  ******************************************************************************
  */
  
-void crc16_updateSTabFwd(T_CRC16_DATA* ctx, const uint8* srcBuf, uint16 numBytes)
+__itcm_text void crc16_updateSTabFwd(T_CRC16_DATA* ctx, const uint8* srcBuf, uint16 numBytes)
 {
   uint8  hiByte;   /* CRC's MSB */
   uint8  hiNibble; /* MSB's high nibble */
@@ -240,7 +241,7 @@ void crc16_updateSTabFwd(T_CRC16_DATA* ctx, const uint8* srcBuf, uint16 numBytes
  ******************************************************************************
  */
  
-void crc16_updateFTabFwd(T_CRC16_DATA* ctx, const uint8* srcBuf, uint16 numBytes)
+__itcm_text void crc16_updateFTabFwd(T_CRC16_DATA* ctx, const uint8* srcBuf, uint16 numBytes)
 {
   uint8  hiByte;   /* CRC's MSB */
   uint16 srcPos;
@@ -10,6 +10,8 @@
 #include "uart.h"
 #include "pdu.h"
 #include "dlcf.h"
+#include "prof.h"
+#include "cpu_tcm.h"
 
 
 #if (TRC_FEAT_DLCF_ENA == STD_ON)
@@ -105,7 +107,7 @@
  ******************************************************************************
  */
 
-static boolean dlcf_sendByte(T_DLCF_CTX* ctx, uint8 byte)
+__itcm_text static boolean dlcf_sendByte(T_DLCF_CTX* ctx, uint8 byte)
 {
   const T_DLCF_DEV_INFO* devInfo = ctx->devInfo;
   return devInfo->wrByte(devInfo->devData, byte);
@@ -121,13 +123,51 @@ static boolean dlcf_sendByte(T_DLCF_CTX* ctx, uint8 byte)
  ******************************************************************************
  */
 
-static boolean dlcf_recvByte(T_DLCF_CTX* ctx, uint8* byte)
+__itcm_text static boolean dlcf_recvByte(T_DLCF_CTX* ctx, uint8* byte)
 {
   const T_DLCF_DEV_INFO* devInfo = ctx->devInfo;
   return devInfo->rdByte(devInfo->devData, byte);
 }
 
 
+/*
+ ******************************************************************************
+ * Function: dlcf_isPacketMode
+ ******************************************************************************
+ * @brief Check whether the device delimits packets, so framing is skipped
+ *
+ * @param [in] ctx - DLCF context
+ *
+ ******************************************************************************
+ */
+
+static boolean dlcf_isPacketMode(T_DLCF_CTX* ctx)
+{
+  const T_DLCF_DEV_INFO* devInfo = ctx->devInfo;
+  boolean result = FALSE;
+
+  if(NULL == devInfo)
+  {
+    /* No device */
+  }
+  else if(0 == (devInfo->flags & DLCF_DEV_FLAG_PACKET))
+  {
+    /* Byte stream device */
+  }
+  else if( (NULL == devInfo->wrBlock) ||
+           (NULL == devInfo->rdBlock) ||
+           (NULL == devInfo->isTxBusy) )
+  {
+    /* Packet callbacks missing */
+  }
+  else
+  {
+    result = !FALSE;
+  }
+  return result;
+}
+
+
 /*
  ******************************************************************************
  * Function: dlcf_configCtx
@@ -149,6 +189,10 @@ void dlcf_configCtx(T_DLCF_CTX* ctx, T_DLCF_CFG* cfg)
   ctx->txState = DLCF_TX_STATE_eCONFIG;
   ctx->rxState = DLCF_RX_STATE_eIDLE;
   ctx->devInfo = NULL;
+  ctx->txBuf = NULL;
+  ctx->txBufSize = 0;
+  ctx->txBlkLen = 0;
+  ctx->txHeld = FALSE;
   TRACE_DLCF_STATE("DLCF RX: RESET -> IDLE\n");
   TRACE_DLCF_STATE("DLCF TX: RESET -> CONFIG\n");  
 }
@@ -188,6 +232,27 @@ T_STATUS dlcf_setDevInfo(T_DLCF_CTX* ctx, const T_DLCF_DEV_INFO* devInfo)
 }
 
 
+/*
+ ******************************************************************************
+ * Function: dlcf_setTxBuffer
+ ******************************************************************************
+ * @brief Setup buffer for blockwise transmission
+ *
+ * @param [out] ctx - DLCF context
+ * @param [in] txBuf - Buffer the encoded frame is written to
+ * @param [in] txBufSize - Size of the buffer, a frame exceeding the size is
+ *                         sent in multiple blocks
+ *
+ ******************************************************************************
+ */
+
+void dlcf_setTxBuffer(T_DLCF_CTX* ctx, uint8* txBuf, uint16 txBufSize)
+{
+  ctx->txBuf = txBuf;
+  ctx->txBufSize = txBufSize;
+}
+
+
 /*
  ******************************************************************************
  * Function: dlcf_sendPdu
@@ -228,7 +293,8 @@ T_STATUS dlcf_sendPdu(T_DLCF_CTX* ctx, T_PDU* txPdu)
       /* Invalid write callback */
       result = DLCF_ERROR_INVALID;
     }
-    else if(NULL == ctx->devInfo->wrByte)
+    else if( (NULL == ctx->devInfo->wrByte) &&
+             (FALSE == dlcf_isPacketMode(ctx)) )
     {
       /* Invalid write callback */
       result = DLCF_ERROR_INVALID;
@@ -293,7 +359,8 @@ T_STATUS dlcf_recvPdu(T_DLCF_CTX* ctx, T_PDU* rxPdu)
       /* Invalid write callback */
       result = DLCF_ERROR_INVALID;
     }
-    else if(NULL == ctx->devInfo->rdByte)
+    else if( (NULL == ctx->devInfo->rdByte) &&
+             (FALSE == dlcf_isPacketMode(ctx)) )
     {
       /* Invalid read callback */
       result = DLCF_ERROR_INVALID;
@@ -399,7 +466,16 @@ T_DLCF_STATUS dlcf_getTxStatus(T_DLCF_CTX* ctx)
   {
   case DLCF_TX_STATE_eFINISHED:
   case DLCF_TX_STATE_eIDLE:
-    result = DLCF_STATUS_eFRAME_FINISHED;
+    if(FALSE != ctx->txHeld)
+    {
+      /* Last byte or block not yet accepted by the device,
+       * keep result.
+       */
+    }
+    else
+    {
+      result = DLCF_STATUS_eFRAME_FINISHED;
+    }
     break;
 
   case DLCF_TX_STATE_eSOF:
@@ -446,7 +522,7 @@ void dlcf_clrTxStatus(T_DLCF_CTX* ctx)
 }
 
 
-T_STATUS dlcf_procTxByte(T_DLCF_CTX* ctx, uint8* txByte)
+__itcm_text T_STATUS dlcf_procTxByte(T_DLCF_CTX* ctx, uint8* txByte)
 {
   T_STATUS result = DLCF_OK;
 
@@ -552,11 +628,13 @@ T_STATUS dlcf_procTxByte(T_DLCF_CTX* ctx, uint8* txByte)
  * ATTENTION: the control structure shall be initialized in advance
  */
 
-T_STATUS dlcf_procRxByte(T_DLCF_CTX* ctx, uint8 rxByte)
+__itcm_text T_STATUS dlcf_procRxByte(T_DLCF_CTX* ctx, uint8 rxByte)
 {
   /* Assume receiver pending */
   T_STATUS result = DLCF_FRAME_PENDING;
 
+  PROF_START(PROF_ID_eDLCF_RX_BYTE);
+
   switch(ctx->rxState)
   {
   case DLCF_RX_STATE_eSOF:
@@ -693,62 +771,359 @@ T_STATUS dlcf_procRxByte(T_DLCF_CTX* ctx, uint8 rxByte)
     result = DLCF_BYTE_RECEIVED;
     break;
   }
+
+  PROF_STOP(PROF_ID_eDLCF_RX_BYTE);
   return result;
 }
 
 
 /*
  ******************************************************************************
- * Function: dlcf_run
+ * Function: dlcf_isBlockMode
  ******************************************************************************
- * @brief DLCF's cyclic function
+ * @brief Check whether frames are transmitted blockwise
+ *
+ * @param [in] ctx - DLCF context
+ *
+ ******************************************************************************
+ */
+
+static boolean dlcf_isBlockMode(T_DLCF_CTX* ctx)
+{
+  boolean result = FALSE;
+
+  if(NULL == ctx->txBuf)
+  {
+    /* No transmit buffer */
+  }
+  else if(NULL != ctx->txCbk)
+  {
+    /* The callback may continue the transmission, so stay bytewise */
+  }
+  else if(NULL == ctx->devInfo->wrBlock)
+  {
+    /* Device doesn't support blocks */
+  }
+  else if(NULL == ctx->devInfo->isTxBusy)
+  {
+    /* Device doesn't support blocks */
+  }
+  else
+  {
+    result = !FALSE;
+  }
+  return result;
+}
+
+
+/*
+ ******************************************************************************
+ * Function: dlcf_procTxBlock
+ ******************************************************************************
+ * @brief Encode the transmit PDU into the transmit buffer and send it
+ *
+ * The PDU is encoded up to the buffer's size and handed over to the device
+ * as soon as it finished the previous block. A frame which doesn't fit into
+ * the buffer is continued with the next block. A block refused by the device
+ * is kept in the buffer and handed over again with the next run, so the
+ * transmission isn't finished before the device accepted it.
+ *
+ * @param [in] ctx - DLCF context
+ *
+ ******************************************************************************
+ */
+
+static void dlcf_procTxBlock(T_DLCF_CTX* ctx)
+{
+  const T_DLCF_DEV_INFO* devInfo = ctx->devInfo;
+  uint16 len = 0;
+
+  if(FALSE != devInfo->isTxBusy(devInfo->devData))
+  {
+    /* Previous block still pending */
+  }
+  else if(FALSE != ctx->txHeld)
+  {
+    /* Retry the block refused recently */
+    if(FALSE == devInfo->wrBlock(devInfo->devData, ctx->txBuf, ctx->txBlkLen))
+    {
+      /* Device still refuses, keep the block for the next run */
+    }
+    else
+    {
+      TRACE_DLCF_INFO("DLCF TX: block resent (L=%d)\n", ctx->txBlkLen);
+      ctx->txHeld = FALSE;
+    }
+  }
+  else
+  {
+    switch(ctx->txState)
+    {
+    case DLCF_TX_STATE_eSOF:
+    case DLCF_TX_STATE_eDATA:
+    case DLCF_TX_STATE_eESC:
+      /* Encode as much as fits into the buffer */
+      while( (len < ctx->txBufSize) &&
+             (DLCF_OK == dlcf_procTxByte(ctx, &ctx->txBuf[len])) )
+      {
+        len++;
+      }
+      TRACE_DLCF_INFO("DLCF TX: block (L=%d)\n", len);
+      if(FALSE == devInfo->wrBlock(devInfo->devData, ctx->txBuf, len))
+      {
+        /* Device refused the block, keep it for the next run */
+        TRACE_DLCF_ERROR("DLCF TX: block refused (L=%d)\n", len);
+        ctx->txBlkLen = len;
+        ctx->txHeld = !FALSE;
+      }
+      break;
+
+    default:
+      /* Nothing to transmit */
+      break;
+    }
+  }
+}
+
+
+/*
+ ******************************************************************************
+ * Function: dlcf_procPacket
+ ******************************************************************************
+ * @brief Pass PDUs unframed to or from a packet device
+ *
+ * The transmit PDU is handed over as a whole and the transmission is
+ * finished as soon as the device doesn't need the PDU's data anymore.
+ * A received packet completes the receive PDU at once.
+ *
+ * @param [in] ctx - DLCF context
+ *
+ ******************************************************************************
+ */
+
+static void dlcf_procPacket(T_DLCF_CTX* ctx)
+{
+  const T_DLCF_DEV_INFO* devInfo = ctx->devInfo;
+  uint16 len = 0;
+
+  switch(ctx->txState)
+  {
+  case DLCF_TX_STATE_eSOF:
+    if(FALSE != devInfo->isTxBusy(devInfo->devData))
+    {
+      /* Previous packet still pending */
+    }
+    else if(FALSE == devInfo->wrBlock(devInfo->devData, ctx->txData, ctx->txLen))
+    {
+      /* Device refused the packet, retry with next cycle */
+    }
+    else
+    {
+      /* Packet handed over, wait until it has been sent */
+      TRACE_DLCF_INFO("DLCF TX: packet (L=%d)\n", ctx->txLen);
+      ctx->txPos = ctx->txLen;
+      ctx->txState = DLCF_TX_STATE_eEOF;
+    }
+    break;
+
+  case DLCF_TX_STATE_eEOF:
+    if(FALSE != devInfo->isTxBusy(devInfo->devData))
+    {
+      /* Packet still pending */
+    }
+    else
+    {
+      ctx->txState = DLCF_TX_STATE_eFINISHED;
+    }
+    break;
+
+  default:
+    /* Nothing to transmit */
+    break;
+  }
+
+  if(DLCF_RX_STATE_eSOF != ctx->rxState)
+  {
+    /* No RX PDU set or PDU not yet collected */
+  }
+  else if(FALSE == devInfo->rdBlock(devInfo->devData, ctx->rxPdu->data, ctx->rxPdu->size, &len))
+  {
+    /* Nothing received */
+  }
+  else
+  {
+    TRACE_DLCF_INFO("DLCF RX: packet (L=%d)\n", len);
+    ctx->rxPos = len;
+    ctx->rxPdu->len = len;
+    ctx->rxState = DLCF_RX_STATE_eFINISHED;
+    TRACE_DLCF_STATE("DLCF RxState: SOF -> FIN\n");
+  }
+}
+
+
+/*
+ ******************************************************************************
+ * Function: dlcf_isRxBlockMode
+ ******************************************************************************
+ * @brief Check whether received data is decoded in place
+ *
+ * @param [in] ctx - DLCF context
+ *
+ ******************************************************************************
+ */
+
+static boolean dlcf_isRxBlockMode(T_DLCF_CTX* ctx)
+{
+  boolean result = FALSE;
+
+  if(NULL == ctx->devInfo->getRxBlock)
+  {
+    /* Device doesn't provide received blocks */
+  }
+  else if(NULL == ctx->devInfo->relRxBlock)
+  {
+    /* Device doesn't provide received blocks */
+  }
+  else
+  {
+    result = !FALSE;
+  }
+  return result;
+}
+
+
+/*
+ ******************************************************************************
+ * Function: dlcf_procRxBlock
+ ******************************************************************************
+ * @brief Decode the received data in place of the device's buffer
+ *
+ * The data is decoded block by block until the end of the frame, only the
+ * bytes processed are released, so the bytes following the frame are kept
+ * for the next PDU.
+ *
+ * @param [in] ctx - DLCF context
+ *
+ * @return Status of the last byte processed
+ *
+ ******************************************************************************
+ */
+
+static T_DLCF_STATUS dlcf_procRxBlock(T_DLCF_CTX* ctx)
+{
+  const T_DLCF_DEV_INFO* devInfo = ctx->devInfo;
+  T_DLCF_STATUS rxStat = DLCF_STATUS_eFRAME_PENDING;
+  const uint8* block;
+  uint16 len;
+  uint16 pos;
+
+  while( (DLCF_RX_STATE_eIDLE != ctx->rxState) &&
+         (DLCF_RX_STATE_eFINISHED != ctx->rxState) )
+  {
+    if(FALSE == devInfo->getRxBlock(devInfo->devData, &block, &len))
+    {
+      /* Nothing received */
+      break;
+    }
+
+    TRACE_DLCF_INFO("DLCF RX: block (L=%d)\n", len);
+    pos = 0;
+    while( (pos < len) &&
+           (DLCF_RX_STATE_eIDLE != ctx->rxState) &&
+           (DLCF_RX_STATE_eFINISHED != ctx->rxState) )
+    {
+      rxStat = (T_DLCF_STATUS)dlcf_procRxByte(ctx, block[pos]);
+      pos++;
+    }
+    devInfo->relRxBlock(devInfo->devData, pos);
+  }
+  return rxStat;
+}
+
+
+/*
+ ******************************************************************************
+ * Function: dlcf_procStream
+ ******************************************************************************
+ * @brief Frame PDUs to or from a byte stream device
  *
  * @param [out] ctx - DLCF context
  *
  ******************************************************************************
  */
  
-void dlcf_run(T_DLCF_CTX* ctx)
+static void dlcf_procStream(T_DLCF_CTX* ctx)
 {
   T_DLCF_STATUS rxStat = DLCF_STATUS_eFRAME_PENDING;
   uint8 byte;
 
   /* Execute transmission path:
-   * Try to process next byte of the tansmit PDU.
+   * Try to process next block or bytes of the tansmit PDU.
    */
-  if(DLCF_OK != dlcf_procTxByte(ctx, &byte))
+  if(FALSE != dlcf_isBlockMode(ctx))
   {
-    /* Nothing to transmit */
+    dlcf_procTxBlock(ctx);
   }
   else
   {
-    /* We got a byte to be transmitted */
-    TRACE_DLCF_INFO("DLCF TX: %02x ('%1c')\n", byte, byte);
-    /* Send it to the next lower layer */
-    dlcf_sendByte(ctx, byte);
-    // TODO: What to do if it fails?
-  }
+    /* Pass bytes to the next lower layer until it is busy */
+    while(1)
+    {
+      if(FALSE != ctx->txHeld)
+      {
+        /* Retry the byte refused recently */
+      }
+      else if(DLCF_OK != dlcf_procTxByte(ctx, &ctx->txByte))
+      {
+        /* Nothing to transmit */
+        break;
+      }
+      else
+      {
+        /* We got a byte to be transmitted */
+        TRACE_DLCF_INFO("DLCF TX: %02x ('%1c')\n", ctx->txByte, ctx->txByte);
+      }
 
-  if(DLCF_RX_STATE_eIDLE == ctx->rxState)
-  {
-    /* No RX PDU set.
-     * If we do nothing here, we cannot deliver non-frame bytes either.
-     * If we try to receive something, we will latest get stuck, if
-     * SOF is received. If we really expect framing, we should never see
-     * the SOF unintended.
-     */
+      /* Send it to the next lower layer */
+      if(FALSE == dlcf_sendByte(ctx, ctx->txByte))
+      {
+        /* Device busy, keep the byte for the next run */
+        ctx->txHeld = !FALSE;
+        break;
+      }
+      ctx->txHeld = FALSE;
+    }
   }
-  /* Execute reception path */
-  else if(FALSE != dlcf_recvByte(ctx, &byte))
+
+  /* Execute reception path:
+   * Process all bytes received so far, but stop at the end of the frame.
+   */
+  if(FALSE != dlcf_isRxBlockMode(ctx))
   {
-    /* Byte received */
-    TRACE_DLCF_INFO("DLCF RX: %02x ('%1c')\n", byte, byte);
-    /* Process the received byte into the receive PDU */
-    rxStat = dlcf_procRxByte(ctx, byte);
+    rxStat = dlcf_procRxBlock(ctx);
   }
   else
   {
-    /* Nothing received */
+    while( (DLCF_RX_STATE_eIDLE != ctx->rxState) &&
+           (DLCF_RX_STATE_eFINISHED != ctx->rxState) )
+    {
+      /* If no RX PDU is set (state IDLE), we do nothing here, so we cannot
+       * deliver non-frame bytes either.
+       * If we try to receive something, we will latest get stuck, if
+       * SOF is received. If we really expect framing, we should never see
+       * the SOF unintended.
+       */
+      if(FALSE == dlcf_recvByte(ctx, &byte))
+      {
+        /* Nothing received */
+        break;
+      }
+
+      /* Byte received */
+      TRACE_DLCF_INFO("DLCF RX: %02x ('%1c')\n", byte, byte);
+      /* Process the received byte into the receive PDU */
+      rxStat = dlcf_procRxByte(ctx, byte);
+    }
   }
 
   /* Examine the receiver status */
@@ -770,3 +1145,28 @@ void dlcf_run(T_DLCF_CTX* ctx)
     break;
   }
 }
+
+
+/*
+ ******************************************************************************
+ * Function: dlcf_run
+ ******************************************************************************
+ * @brief DLCF's cyclic function
+ *
+ * @param [out] ctx - DLCF context
+ *
+ ******************************************************************************
+ */
+ 
+void dlcf_run(T_DLCF_CTX* ctx)
+{
+  /* Packet devices don't need any framing */
+  if(FALSE != dlcf_isPacketMode(ctx))
+  {
+    dlcf_procPacket(ctx);
+  }
+  else
+  {
+    dlcf_procStream(ctx);
+  }
+}
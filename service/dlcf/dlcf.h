@@ -38,17 +38,42 @@ typedef struct
  *  - 1 callback for write/send
  *  - 1 callback for read/receive
  *  - 1 device data pointer that is given as parameter to the callbacks
+ *  - 2 optional callbacks for block write/send, e.g. by DMA
+ *  - 2 optional callbacks for block read/receive in place, e.g. by DMA
  *
- * The last member is a pointer to device specific data, which may be a
- * device specific structure or a device ID.
+ * The device data pointer is a pointer to device specific data, which may
+ * be a device specific structure or a device ID.
+ * If the block callbacks are set and a transmit buffer is given by
+ * dlcf_setTxBuffer(), frames are encoded into the buffer and sent blockwise.
+ *
+ * Devices which already delimit packets (e.g. USB bulk endpoints, UDP or
+ * shared memory mailboxes) set DLCF_DEV_FLAG_PACKET. PDUs are then passed
+ * unframed by wrBlock and rdBlock, so the byte callbacks may be left NULL.
+ * rdBlock returns !FALSE if a packet has been copied to the given buffer
+ * and stores its length. wrBlock must not be called again until isTxBusy
+ * reports the previous packet to be sent.
+ *
+ * Byte stream devices receiving into a buffer (e.g. a circular DMA buffer)
+ * may set getRxBlock and relRxBlock. getRxBlock returns !FALSE if data is
+ * available and provides it in place with its length, relRxBlock releases
+ * the number of bytes processed. The received data is then decoded without
+ * calling rdByte for every byte.
  */
 
+#define DLCF_DEV_FLAG_PACKET 0x01 /* Device delimits packets, no framing */
+
 typedef struct
 {
   
   boolean (*wrByte)(void*, uint8);
   boolean (*rdByte)(void*, uint8*);
   void* devData;
+  boolean (*wrBlock)(void*, const uint8*, uint16);
+  boolean (*isTxBusy)(void*);
+  boolean (*rdBlock)(void*, uint8*, uint16, uint16*);
+  boolean (*getRxBlock)(void*, const uint8**, uint16*);
+  void (*relRxBlock)(void*, uint16);
+  uint8 flags;
 }T_DLCF_DEV_INFO;
 
 
@@ -83,6 +108,11 @@ typedef struct
   uint16 txPos;
   uint16 txLen;
   uint8* txData;
+  uint8  txByte;    /* Byte refused by the device to be retried */
+  boolean txHeld;   /* txByte or the block in txBuf is pending */
+  uint8* txBuf;     /* Buffer for blockwise transmission */
+  uint16 txBufSize;
+  uint16 txBlkLen;  /* Length of the block refused by the device */
   void  (*txCbk)(void);
   T_DLCF_RX_STATE rxState;
   uint16 rxPos;
@@ -95,6 +125,7 @@ typedef struct
 
 extern void dlcf_configCtx(T_DLCF_CTX* ctx, T_DLCF_CFG* cfg);
 extern T_STATUS dlcf_setDevInfo(T_DLCF_CTX* ctx, const T_DLCF_DEV_INFO* devInfo);
+extern void dlcf_setTxBuffer(T_DLCF_CTX* ctx, uint8* txBuf, uint16 txBufSize);
 
 extern T_STATUS dlcf_recvPdu(T_DLCF_CTX* ctx, T_PDU* rxPdu);
 extern T_STATUS dlcf_sendPdu(T_DLCF_CTX* ctx, T_PDU* txPdu);
@@ -0,0 +1,146 @@
+#ifndef DLCF_LOOP_C
+#define DLCF_LOOP_C
+#endif /* DLCF_LOOP_C */
+
+
+#include "bsp.h"
+#include "libc.h"
+
+#include "pdu.h"
+#include "dlcf.h"
+#include "dlcf_loop.h"
+
+
+/*
+ ******************************************************************************
+ * Function: dlcf_loop_init
+ ******************************************************************************
+ * @brief Initialize a loopback transport
+ *
+ * @param [out] loop - Loopback transport
+ * @param [in] buffer - Packet slot
+ * @param [in] size - Size of the packet slot
+ *
+ ******************************************************************************
+ */
+
+void dlcf_loop_init(T_DLCF_LOOP* loop, uint8* buffer, uint16 size)
+{
+  loop->buffer = buffer;
+  loop->size = size;
+  loop->len = 0;
+  loop->full = FALSE;
+  loop->dropped = 0;
+}
+
+
+/*
+ ******************************************************************************
+ * Function: dlcf_loop_setDevInfo
+ ******************************************************************************
+ * @brief Set up DLCF device info to use the loopback transport
+ *
+ * @param [out] devInfo - DLCF device info
+ * @param [in] loop - Loopback transport
+ *
+ ******************************************************************************
+ */
+
+void dlcf_loop_setDevInfo(T_DLCF_DEV_INFO* devInfo, T_DLCF_LOOP* loop)
+{
+  devInfo->wrByte = NULL;
+  devInfo->rdByte = NULL;
+  devInfo->devData = (void*)loop;
+  devInfo->wrBlock = &dlcf_loop_sendBlock;
+  devInfo->isTxBusy = &dlcf_loop_isTxBusy;
+  devInfo->rdBlock = &dlcf_loop_recvBlock;
+  devInfo->flags = DLCF_DEV_FLAG_PACKET;
+}
+
+
+/*
+ ******************************************************************************
+ *
+ ******************************************************************************
+ *
+ *
+ ******************************************************************************
+ */
+
+boolean dlcf_loop_sendBlock(void* param, const uint8* block, uint16 len)
+{
+  T_DLCF_LOOP* loop = (T_DLCF_LOOP*)param;
+  boolean result = FALSE;
+
+  if(FALSE != loop->full)
+  {
+    /* Previous packet not yet read */
+    loop->dropped++;
+  }
+  else if(len > loop->size)
+  {
+    /* Packet doesn't fit into the slot */
+    loop->dropped++;
+  }
+  else
+  {
+    libc_memcpy(loop->buffer, block, len);
+    loop->len = len;
+    loop->full = !FALSE;
+    result = !FALSE;
+  }
+  return result;
+}
+
+
+/*
+ ******************************************************************************
+ *
+ ******************************************************************************
+ *
+ *
+ ******************************************************************************
+ */
+
+boolean dlcf_loop_recvBlock(void* param, uint8* block, uint16 size, uint16* len)
+{
+  T_DLCF_LOOP* loop = (T_DLCF_LOOP*)param;
+  boolean result = FALSE;
+
+  if(FALSE == loop->full)
+  {
+    /* Nothing received */
+  }
+  else if(loop->len > size)
+  {
+    /* Packet doesn't fit into the receive buffer, so drop it */
+    loop->full = FALSE;
+    loop->dropped++;
+  }
+  else
+  {
+    libc_memcpy(block, loop->buffer, loop->len);
+    *len = loop->len;
+    loop->full = FALSE;
+    result = !FALSE;
+  }
+  return result;
+}
+
+
+/*
+ ******************************************************************************
+ *
+ ******************************************************************************
+ *
+ *
+ ******************************************************************************
+ */
+
+boolean dlcf_loop_isTxBusy(void* param)
+{
+  (void)param;
+
+  /* Packets are copied at once */
+  return FALSE;
+}
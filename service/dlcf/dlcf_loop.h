@@ -0,0 +1,29 @@
+#ifndef DLCF_LOOP_H
+#define DLCF_LOOP_H
+
+/* Loopback packet transport
+ *
+ * Every packet written is kept in a single slot until it is read back, so
+ * a BCP instance bound to it receives its own responses. It doesn't depend
+ * on any hardware and is meant for exercising the packet path of DLCF and
+ * BCP in a host build.
+ */
+
+typedef struct
+{
+  uint8* buffer;  /* Packet slot */
+  uint16 size;    /* Size of the packet slot */
+  uint16 len;     /* Length of the packet in the slot */
+  boolean full;   /* Slot holds a packet not yet read */
+  uint32 dropped; /* Number of packets refused because the slot was full */
+}T_DLCF_LOOP;
+
+
+extern void dlcf_loop_init(T_DLCF_LOOP* loop, uint8* buffer, uint16 size);
+extern void dlcf_loop_setDevInfo(T_DLCF_DEV_INFO* devInfo, T_DLCF_LOOP* loop);
+
+extern boolean dlcf_loop_sendBlock(void* param, const uint8* block, uint16 len);
+extern boolean dlcf_loop_recvBlock(void* param, uint8* block, uint16 size, uint16* len);
+extern boolean dlcf_loop_isTxBusy(void* param);
+
+#endif /* DLCF_LOOP_H */
@@ -64,3 +64,93 @@ boolean dlcf_uart_recvByte(void* param, uint8* byte)
   }
   return result;
 }
+
+
+/*
+ ******************************************************************************
+ *
+ ******************************************************************************
+ *
+ *
+ ******************************************************************************
+ */
+
+boolean dlcf_uart_sendBlock(void* param, const uint8* block, uint16 len)
+{
+  boolean result;
+  uint32* devID = (uint32*)param;
+
+  if(UART_OK != uart_sendBlock(*devID, block, len))
+  {
+    /* Failed to transmit block */
+    result = FALSE;
+  }
+  else
+  {
+    /* Sucessfully started transmission */
+    result = !FALSE;
+  }
+  return result;
+}
+
+
+/*
+ ******************************************************************************
+ *
+ ******************************************************************************
+ *
+ *
+ ******************************************************************************
+ */
+
+boolean dlcf_uart_isTxBusy(void* param)
+{
+  uint32* devID = (uint32*)param;
+
+  return uart_isTxBusy(*devID);
+}
+
+
+/*
+ ******************************************************************************
+ *
+ ******************************************************************************
+ *
+ *
+ ******************************************************************************
+ */
+
+boolean dlcf_uart_recvBlock(void* param, const uint8** block, uint16* len)
+{
+  boolean result;
+  uint32* devID = (uint32*)param;
+
+  if(UART_OK != uart_recvBlock(*devID, block, len))
+  {
+    /* Nothing received */
+    result = FALSE;
+  }
+  else
+  {
+    /* Received data available in place */
+    result = !FALSE;
+  }
+  return result;
+}
+
+
+/*
+ ******************************************************************************
+ *
+ ******************************************************************************
+ *
+ *
+ ******************************************************************************
+ */
+
+void dlcf_uart_releaseBlock(void* param, uint16 len)
+{
+  uint32* devID = (uint32*)param;
+
+  uart_releaseBlock(*devID, len);
+}
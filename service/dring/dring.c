@@ -0,0 +1,182 @@
+#ifndef DRING_C
+#define DRING_C
+#endif /* DRING_C */
+
+#include "bsp.h"
+#include "dring.h"
+
+
+/*
+ ******************************************************************************
+ * dring_init
+ ******************************************************************************
+ * Description:
+ *   The function initializes the DMA ring buffer structure. The DMA transfer
+ *   is expected to start writing at index 0.
+ *
+ ******************************************************************************
+ */
+
+void dring_init(T_DRING* ring, uint8* buffer, uint16 size)
+{
+  ring->buffer = buffer;
+  ring->size = size;
+  ring->rdPtr = 0;
+  ring->wrPtr = 0;
+  ring->overruns = 0;
+}
+
+
+/*
+ ******************************************************************************
+ * dring_update
+ ******************************************************************************
+ * Description:
+ *   The function samples the DMA write position given by the number of
+ *   transfers remaining in the current major loop (CITER).
+ *   If the write position passed the read position since the last update,
+ *   the unread data was overwritten. In that case all data is discarded
+ *   and an overrun is reported.
+ *   Note: The ring must be updated at least once per lap of the DMA
+ *         transfer, otherwise complete laps can't be detected.
+ *
+ ******************************************************************************
+ */
+
+T_STATUS dring_update(T_DRING* ring, uint16 remaining)
+{
+  T_STATUS result = DRING_OK;
+  uint16 wrPtr;
+  uint16 delta;
+
+  if((0 == remaining) || (remaining > ring->size))
+  {
+    /* Major loop is just being reloaded */
+    wrPtr = 0;
+  }
+  else
+  {
+    wrPtr = ring->size - remaining;
+  }
+
+  /* Number of bytes written since last update */
+  delta = (wrPtr >= ring->wrPtr) ? (wrPtr - ring->wrPtr) : (ring->size - ring->wrPtr + wrPtr);
+
+  if((dring_getFill(ring) + delta) >= ring->size)
+  {
+    /* Unread data was overwritten */
+    ring->rdPtr = wrPtr;
+    ring->overruns++;
+    result = DRING_ERROR_OVERRUN;
+  }
+  ring->wrPtr = wrPtr;
+
+  return result;
+}
+
+
+/*
+ ******************************************************************************
+ * dring_rdByte
+ ******************************************************************************
+ * Description:
+ *   The function reads one byte from the ring buffer, if there is any data
+ *   up to the last sampled write position.
+ *
+ ******************************************************************************
+ */
+
+T_STATUS dring_rdByte(T_DRING* ring, uint8* byte)
+{
+  uint16 rd = ring->rdPtr;
+
+  if(rd != ring->wrPtr)
+  {
+    *byte = ring->buffer[rd++];
+    if(rd >= ring->size)
+    {
+      rd = 0;
+    }
+    ring->rdPtr = rd;
+
+    return DRING_OK;
+  }
+  else
+  {
+    /* buffer is empty */
+    return DRING_ERROR_EMPTY;
+  }
+}
+
+
+/*
+ ******************************************************************************
+ * dring_getFill
+ ******************************************************************************
+ * Description:
+ *   The function returns the number of unread bytes up to the last sampled
+ *   write position.
+ *
+ ******************************************************************************
+ */
+
+uint16 dring_getFill(T_DRING* ring)
+{
+  uint16 rd = ring->rdPtr;
+  uint16 wr = ring->wrPtr;
+
+  return (wr >= rd) ? (wr - rd) : (ring->size - rd + wr);
+}
+
+
+/*
+ ******************************************************************************
+ * dring_getBlock
+ ******************************************************************************
+ * Description:
+ *   The function returns a pointer to the unread data and the number of
+ *   bytes that can be accessed contiguously, i.e. up to the write position
+ *   or up to the end of the buffer. The data stays in the ring buffer until
+ *   it is released by dring_release().
+ *
+ ******************************************************************************
+ */
+
+uint16 dring_getBlock(T_DRING* ring, const uint8** data)
+{
+  uint16 rd = ring->rdPtr;
+  uint16 wr = ring->wrPtr;
+
+  *data = &ring->buffer[rd];
+  return (wr >= rd) ? (wr - rd) : (ring->size - rd);
+}
+
+
+/*
+ ******************************************************************************
+ * dring_release
+ ******************************************************************************
+ * Description:
+ *   The function releases the given number of bytes after being processed
+ *   in place.
+ *
+ ******************************************************************************
+ */
+
+void dring_release(T_DRING* ring, uint16 len)
+{
+  uint16 fill = dring_getFill(ring);
+  uint32 rd;
+
+  if(len > fill)
+  {
+    len = fill;
+  }
+  rd = ring->rdPtr + len;
+  if(rd >= ring->size)
+  {
+    rd -= ring->size;
+  }
+  ring->rdPtr = rd;
+}
+
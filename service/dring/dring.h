@@ -0,0 +1,32 @@
+#ifndef DRING_H
+#define DRING_H
+
+
+#define DRING_OK            0
+#define DRING_ERROR_EMPTY   1
+#define DRING_ERROR_OVERRUN 3
+
+
+/* Ring buffer filled by a circular DMA transfer.
+ * The write index is owned by the DMA engine and sampled from its
+ * remaining major loop count, the read index is owned by software.
+ * The logic doesn't access any hardware, so it can also be used with
+ * a simulated DMA engine.
+ */
+typedef struct T_DRING
+{
+  uint16 size;      /* size of buffer, equals the DMA major loop count */
+  uint16 rdPtr;     /* index of next byte to be read */
+  uint16 wrPtr;     /* index of next byte to be written, as last sampled */
+  uint16 overruns;  /* number of detected overruns */
+  uint8* buffer;    /* pointer to buffer array */
+}T_DRING;
+
+void   dring_init(T_DRING* ring, uint8* buffer, uint16 size);
+T_STATUS dring_update(T_DRING* ring, uint16 remaining);
+T_STATUS dring_rdByte(T_DRING* ring, uint8* byte);
+uint16 dring_getFill(T_DRING* ring);
+uint16 dring_getBlock(T_DRING* ring, const uint8** data);
+void   dring_release(T_DRING* ring, uint16 len);
+
+#endif /* DRING_H */
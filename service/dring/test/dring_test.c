@@ -0,0 +1,279 @@
+#ifndef DRING_TEST_C
+#define DRING_TEST_C
+#endif /* DRING_TEST_C */
+
+#include "bsp.h"
+#include "dring.h"
+
+#include <stdio.h>
+
+
+/*
+ * Host test of the DMA ring buffer
+ *
+ * A simulated DMA engine writes a running byte pattern into the buffer and
+ * reports its position as the number of transfers remaining in the major
+ * loop (CITER), exactly like the eDMA engine does. The major loop is
+ * reloaded with the buffer's size after each lap.
+ */
+
+#define TEST_RING_SIZE 8u
+
+#define TEST_CHECK(cond)                                                  \
+  do                                                                      \
+  {                                                                       \
+    if(!(cond))                                                           \
+    {                                                                     \
+      printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond);     \
+      test_numFailed++;                                                   \
+    }                                                                     \
+  }while(0)
+
+typedef struct
+{
+  uint8* buffer;
+  uint16 size;
+  uint16 wrPos;   /* Next position written by the DMA engine */
+  uint8  pattern; /* Next byte written by the DMA engine */
+}T_TEST_DMA;
+
+static uint32 test_numFailed;
+
+
+/*
+ ******************************************************************************
+ * test_dmaWrite
+ ******************************************************************************
+ * Description:
+ *   The function writes the given number of bytes like the circular DMA
+ *   transfer and returns the remaining major loop count afterwards.
+ *
+ ******************************************************************************
+ */
+
+static uint16 test_dmaWrite(T_TEST_DMA* dma, uint16 numBytes)
+{
+  while(numBytes > 0)
+  {
+    dma->buffer[dma->wrPos++] = dma->pattern++;
+    if(dma->wrPos >= dma->size)
+    {
+      dma->wrPos = 0;
+    }
+    numBytes--;
+  }
+  return dma->size - dma->wrPos;
+}
+
+
+/*
+ ******************************************************************************
+ * test_readBlocks
+ ******************************************************************************
+ * Description:
+ *   The function reads all data up to the sampled write position by blocks
+ *   and checks it against the expected pattern. It returns the number of
+ *   bytes read.
+ *
+ ******************************************************************************
+ */
+
+static uint16 test_readBlocks(T_DRING* ring, uint8* pattern)
+{
+  const uint8* data;
+  uint16 numRead = 0;
+  uint16 len;
+  uint16 idx;
+
+  while(0 != (len = dring_getBlock(ring, &data)))
+  {
+    TEST_CHECK(data >= ring->buffer);
+    TEST_CHECK((data + len) <= (ring->buffer + ring->size));
+    for(idx = 0; idx < len; idx++)
+    {
+      TEST_CHECK(data[idx] == *pattern);
+      (*pattern)++;
+    }
+    dring_release(ring, len);
+    numRead += len;
+  }
+  return numRead;
+}
+
+
+/*
+ ******************************************************************************
+ * test_wrap
+ ******************************************************************************
+ * Description:
+ *   Data wrapping around the end of the buffer is provided by two blocks.
+ *
+ ******************************************************************************
+ */
+
+static void test_wrap(void)
+{
+  uint8 buffer[TEST_RING_SIZE];
+  T_TEST_DMA dma = { buffer, TEST_RING_SIZE, 0, 0 };
+  T_DRING ring;
+  const uint8* data;
+  uint8 pattern = 0;
+  uint16 remaining;
+
+  dring_init(&ring, buffer, TEST_RING_SIZE);
+
+  /* Nothing written yet, the major loop count is the full size */
+  TEST_CHECK(DRING_OK == dring_update(&ring, TEST_RING_SIZE));
+  TEST_CHECK(0 == dring_getFill(&ring));
+  TEST_CHECK(0 == dring_getBlock(&ring, &data));
+
+  remaining = test_dmaWrite(&dma, 5);
+  TEST_CHECK(3 == remaining);
+  TEST_CHECK(DRING_OK == dring_update(&ring, remaining));
+  TEST_CHECK(5 == dring_getFill(&ring));
+  TEST_CHECK(5 == test_readBlocks(&ring, &pattern));
+
+  /* Six bytes at positions 5..7 and 0..2 */
+  remaining = test_dmaWrite(&dma, 6);
+  TEST_CHECK(5 == remaining);
+  TEST_CHECK(DRING_OK == dring_update(&ring, remaining));
+  TEST_CHECK(6 == dring_getFill(&ring));
+  TEST_CHECK(3 == dring_getBlock(&ring, &data));
+  TEST_CHECK(&buffer[5] == data);
+  TEST_CHECK(6 == test_readBlocks(&ring, &pattern));
+  TEST_CHECK(3 == ring.rdPtr);
+
+  /* Partial release keeps the remainder */
+  remaining = test_dmaWrite(&dma, 4);
+  TEST_CHECK(DRING_OK == dring_update(&ring, remaining));
+  TEST_CHECK(4 == dring_getBlock(&ring, &data));
+  dring_release(&ring, 1);
+  TEST_CHECK(3 == dring_getFill(&ring));
+  pattern++;
+
+  /* Releasing more than available is limited to the fill level */
+  TEST_CHECK(3 == test_readBlocks(&ring, &pattern));
+  dring_release(&ring, TEST_RING_SIZE);
+  TEST_CHECK(0 == dring_getFill(&ring));
+  TEST_CHECK(ring.wrPtr == ring.rdPtr);
+  TEST_CHECK(0 == ring.overruns);
+}
+
+
+/*
+ ******************************************************************************
+ * test_reload
+ ******************************************************************************
+ * Description:
+ *   A remaining count of zero is sampled while the major loop is reloaded,
+ *   so the write position is at the start of the buffer.
+ *
+ ******************************************************************************
+ */
+
+static void test_reload(void)
+{
+  uint8 buffer[TEST_RING_SIZE];
+  T_TEST_DMA dma = { buffer, TEST_RING_SIZE, 0, 0x80 };
+  T_DRING ring;
+  const uint8* data;
+  uint8 pattern = 0x80;
+  uint8 byte;
+
+  dring_init(&ring, buffer, TEST_RING_SIZE);
+
+  TEST_CHECK(DRING_OK == dring_update(&ring, test_dmaWrite(&dma, 3)));
+  TEST_CHECK(3 == test_readBlocks(&ring, &pattern));
+
+  /* The lap is completed and CITER not yet reloaded */
+  (void)test_dmaWrite(&dma, 5);
+  TEST_CHECK(DRING_OK == dring_update(&ring, 0));
+  TEST_CHECK(0 == ring.wrPtr);
+  TEST_CHECK(5 == dring_getFill(&ring));
+  TEST_CHECK(5 == dring_getBlock(&ring, &data));
+  TEST_CHECK(&buffer[3] == data);
+
+  /* Bytewise reading follows the same positions */
+  TEST_CHECK(DRING_OK == dring_rdByte(&ring, &byte));
+  TEST_CHECK(pattern++ == byte);
+  TEST_CHECK(4 == test_readBlocks(&ring, &pattern));
+  TEST_CHECK(DRING_ERROR_EMPTY == dring_rdByte(&ring, &byte));
+
+  /* The reloaded count is the full size, which is the same position */
+  TEST_CHECK(DRING_OK == dring_update(&ring, TEST_RING_SIZE));
+  TEST_CHECK(0 == dring_getFill(&ring));
+
+  /* A count above the size is treated like a reload */
+  TEST_CHECK(DRING_OK == dring_update(&ring, TEST_RING_SIZE + 1));
+  TEST_CHECK(0 == ring.wrPtr);
+  TEST_CHECK(0 == ring.overruns);
+}
+
+
+/*
+ ******************************************************************************
+ * test_overrun
+ ******************************************************************************
+ * Description:
+ *   Unread data overwritten by the DMA engine is discarded and counted.
+ *
+ ******************************************************************************
+ */
+
+static void test_overrun(void)
+{
+  uint8 buffer[TEST_RING_SIZE];
+  T_TEST_DMA dma = { buffer, TEST_RING_SIZE, 0, 0 };
+  T_DRING ring;
+  const uint8* data;
+  uint8 pattern;
+  uint16 remaining;
+
+  dring_init(&ring, buffer, TEST_RING_SIZE);
+
+  /* Five bytes pending, four more reach the unread data */
+  TEST_CHECK(DRING_OK == dring_update(&ring, test_dmaWrite(&dma, 5)));
+  TEST_CHECK(5 == dring_getBlock(&ring, &data));
+  remaining = test_dmaWrite(&dma, 4);
+  TEST_CHECK(DRING_ERROR_OVERRUN == dring_update(&ring, remaining));
+  TEST_CHECK(1 == ring.overruns);
+  TEST_CHECK(0 == dring_getFill(&ring));
+  TEST_CHECK(ring.wrPtr == ring.rdPtr);
+
+  /* Reception continues behind the discarded data */
+  pattern = dma.pattern;
+  TEST_CHECK(DRING_OK == dring_update(&ring, test_dmaWrite(&dma, 2)));
+  TEST_CHECK(2 == test_readBlocks(&ring, &pattern));
+
+  /* Filling the buffer completely across its end can't be told from
+   * an empty one, so it is an overrun as well
+   */
+  TEST_CHECK(DRING_OK == dring_update(&ring, test_dmaWrite(&dma, 3)));
+  TEST_CHECK(DRING_ERROR_OVERRUN == dring_update(&ring, test_dmaWrite(&dma, TEST_RING_SIZE - 3)));
+  TEST_CHECK(2 == ring.overruns);
+  TEST_CHECK(0 == dring_getFill(&ring));
+
+  /* One byte less than a lap is still fine */
+  pattern = dma.pattern;
+  TEST_CHECK(DRING_OK == dring_update(&ring, test_dmaWrite(&dma, TEST_RING_SIZE - 1)));
+  TEST_CHECK((TEST_RING_SIZE - 1) == test_readBlocks(&ring, &pattern));
+  TEST_CHECK(2 == ring.overruns);
+}
+
+
+int main(void)
+{
+  test_wrap();
+  test_reload();
+  test_overrun();
+
+  if(0 != test_numFailed)
+  {
+    printf("dring_test: %u check(s) failed\n", test_numFailed);
+  }
+  else
+  {
+    printf("dring_test: passed\n");
+  }
+  return (0 != test_numFailed) ? 1 : 0;
+}
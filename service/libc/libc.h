@@ -17,6 +17,8 @@
   /* On LINUX use standard libs per default */
   #include "stdlib.h"
   #include "stdarg.h"
+  #include "string.h"
+  #define libc_memcmp memcmp
   #define libc_memcpy memcpy
   #define libc_memset memset
 #elif defined (__TMS320C6X__)
@@ -0,0 +1,233 @@
+#ifndef PROF_C
+#define PROF_C
+#endif /* PROF_C */
+
+#include "bsp.h"
+#include "cpu_cyc.h"
+#include "libc.h"
+#include "prof.h"
+
+
+/*
+ * Cycle counter profiling
+ *
+ * Every probe configured in prof_cfg.h measures the cycles between
+ * PROF_START() and PROF_STOP() by the DWT cycle counter and keeps the
+ * number of measurements, the minimum, the maximum and the sum of cycles.
+ * Probes are not reentrant, so a probe must not be started from an
+ * interrupt handler while it is running in thread mode.
+ */
+
+typedef struct
+{
+  T_PROF_PROBE probes[MAX_PROF_ID];
+}T_PROF_DATA;
+
+static T_PROF_DATA prof_dataTbl[1];
+
+
+/*
+ ******************************************************************************
+ * Function: prof_divCycles
+ ******************************************************************************
+ * @brief Divide a 64 bit cycle sum by a 32 bit count
+ *
+ * @par Description:
+ *   The FBL is linked without libgcc, so 64 bit division is done by shift
+ *   and subtract. The quotient is saturated to 32 bits.
+ *
+ ******************************************************************************
+ */
+
+static uint32 prof_divCycles(uint64 num, uint32 den)
+{
+  uint64 rem = 0;
+  uint64 quot = 0;
+  int bit;
+
+  if(den == 0)
+  {
+    /* Nothing measured */
+  }
+  else
+  {
+    for(bit = 63; bit >= 0; bit--)
+    {
+      rem = (rem << 1) | ((num >> bit) & 1);
+      quot <<= 1;
+      if(rem >= den)
+      {
+        rem -= den;
+        quot |= 1;
+      }
+    }
+  }
+
+  if(quot > 0xFFFFFFFFu)
+  {
+    quot = 0xFFFFFFFFu;
+  }
+  return (uint32)quot;
+}
+
+
+/*
+ ******************************************************************************
+ * Function: prof_init
+ ******************************************************************************
+ * @brief Initialize the profiling probes
+ *
+ ******************************************************************************
+ */
+
+void prof_init(void)
+{
+  cpu_enableCycleCounter();
+  prof_clear();
+}
+
+
+/*
+ ******************************************************************************
+ * Function: prof_start
+ ******************************************************************************
+ * @brief Start a measurement of the given probe
+ *
+ * @param [in] probeID - ID of the probe as of enum PROF_ID
+ *
+ ******************************************************************************
+ */
+
+void prof_start(uint32 probeID)
+{
+  T_PROF_DATA* profData = prof_dataTbl;
+
+  if(probeID < MAX_PROF_ID)
+  {
+    profData->probes[probeID].cycStart = cpu_getCycleCount();
+  }
+}
+
+
+/*
+ ******************************************************************************
+ * Function: prof_stop
+ ******************************************************************************
+ * @brief Stop the measurement of the given probe and update its statistics
+ *
+ * @param [in] probeID - ID of the probe as of enum PROF_ID
+ *
+ ******************************************************************************
+ */
+
+void prof_stop(uint32 probeID)
+{
+  T_PROF_DATA* profData = prof_dataTbl;
+  T_PROF_PROBE* probe;
+  uint32 cycles;
+
+  /* Read the counter first, so the bookkeeping is not measured */
+  cycles = cpu_getCycleCount();
+
+  if(probeID < MAX_PROF_ID)
+  {
+    probe = &profData->probes[probeID];
+    cycles -= probe->cycStart;
+
+    probe->count++;
+    probe->cycSum += cycles;
+    if(cycles < probe->cycMin)
+    {
+      probe->cycMin = cycles;
+    }
+    if(cycles > probe->cycMax)
+    {
+      probe->cycMax = cycles;
+    }
+  }
+}
+
+
+/*
+ ******************************************************************************
+ * Function: prof_getProbe
+ ******************************************************************************
+ * @brief Get the statistics of a probe
+ *
+ * @param [in] probeID - ID of the probe as of enum PROF_ID
+ *
+ * @return Pointer to the probe or NULL if the ID is invalid
+ *
+ ******************************************************************************
+ */
+
+const T_PROF_PROBE* prof_getProbe(uint32 probeID)
+{
+  T_PROF_DATA* profData = prof_dataTbl;
+  const T_PROF_PROBE* result = NULL;
+
+  if(probeID < MAX_PROF_ID)
+  {
+    result = &profData->probes[probeID];
+  }
+  return result;
+}
+
+
+/*
+ ******************************************************************************
+ * Function: prof_clear
+ ******************************************************************************
+ * @brief Reset the statistics of all probes
+ *
+ ******************************************************************************
+ */
+
+void prof_clear(void)
+{
+  T_PROF_DATA* profData = prof_dataTbl;
+  uint32 probeID;
+
+  libc_memset(profData, 0, sizeof(T_PROF_DATA));
+  for(probeID = 0; probeID < MAX_PROF_ID; probeID++)
+  {
+    profData->probes[probeID].cycMin = 0xFFFFFFFFu;
+  }
+}
+
+
+/*
+ ******************************************************************************
+ * Function: prof_dump
+ ******************************************************************************
+ * @brief Print the statistics of all probes in cycles
+ *
+ ******************************************************************************
+ */
+
+void prof_dump(void)
+{
+  T_PROF_DATA* profData = prof_dataTbl;
+  const T_PROF_PROBE* probe;
+  uint32 probeID;
+
+  libc_printf("Probe        Count      Min        Max        Avg\n");
+  for(probeID = 0; probeID < MAX_PROF_ID; probeID++)
+  {
+    probe = &profData->probes[probeID];
+    if(probe->count == 0)
+    {
+      libc_printf("%-12s %10u          -          -          -\n",
+                  prof_nameList[probeID], 0);
+    }
+    else
+    {
+      libc_printf("%-12s %10u %10u %10u %10u\n",
+                  prof_nameList[probeID],
+                  probe->count,
+                  probe->cycMin,
+                  probe->cycMax,
+                  prof_divCycles(probe->cycSum, probe->count));
+    }
+  }
+}
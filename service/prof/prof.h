@@ -0,0 +1,35 @@
+#ifndef PROF_H
+#define PROF_H
+
+#include "prof_cfg.h"
+
+
+/*! Statistics of a probe */
+typedef struct
+{
+  uint32 cycStart;  /*!< Cycle count at the recent PROF_START() */
+  uint32 count;     /*!< Number of measurements */
+  uint32 cycMin;    /*!< Minimum cycles of a single measurement */
+  uint32 cycMax;    /*!< Maximum cycles of a single measurement */
+  uint64 cycSum;    /*!< Cycles of all measurements */
+}T_PROF_PROBE;
+
+
+#if (PROF_ENA == STD_ON)
+#define PROF_START(id)  prof_start(id)
+#define PROF_STOP(id)   prof_stop(id)
+#else
+#define PROF_START(id)
+#define PROF_STOP(id)
+#endif /* (PROF_ENA == STD_ON) */
+
+
+extern void prof_init(void);
+extern void prof_start(uint32 probeID);
+extern void prof_stop(uint32 probeID);
+
+extern const T_PROF_PROBE* prof_getProbe(uint32 probeID);
+extern void prof_clear(void);
+extern void prof_dump(void);
+
+#endif /* PROF_H */
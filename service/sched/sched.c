@@ -0,0 +1,245 @@
+#ifndef SCHED_C
+#define SCHED_C
+#endif /* SCHED_C */
+
+#include "bsp.h"
+#include "cpu_irq.h"
+#include "cpu_cyc.h"
+#include "libc.h"
+#include "sched.h"
+
+
+/*
+ * Cooperative scheduler
+ *
+ * Tasks are registered with a run function and a mask of events they are
+ * waiting for. Events are set from interrupt handlers or tasks by
+ * sched_setEvent(). Every pass of sched_run() collects the pending events
+ * and runs all tasks waiting for any of them in the order of registration.
+ * If no event is pending the core sleeps in WFI until an interrupt occurs.
+ */
+
+typedef struct
+{
+  T_SCHED_TASK tasks[SCHED_MAX_TASKS];
+  uint32 numTasks;
+  volatile uint32 evtPending;
+  uint64 cycSleep; /* Cycles spent sleeping in WFI */
+}T_SCHED_DATA;
+
+static T_SCHED_DATA sched_dataTbl[1];
+
+
+/*
+ ******************************************************************************
+ * Function: sched_init
+ ******************************************************************************
+ * @brief Initialize the scheduler
+ *
+ ******************************************************************************
+ */
+
+void sched_init(void)
+{
+  T_SCHED_DATA* schedData = sched_dataTbl;
+
+  libc_memset(schedData, 0, sizeof(T_SCHED_DATA));
+
+  /* Cycle counter is used for task statistics */
+  cpu_enableCycleCounter();
+}
+
+
+/*
+ ******************************************************************************
+ * Function: sched_addTask
+ ******************************************************************************
+ * @brief Register a task's run function
+ *
+ * @param [in] name - Name of the task
+ * @param [in] run - Run function of the task
+ * @param [in] evtMask - Events the task shall be run on
+ *
+ * @return STATUS_eOK if registered, STATUS_eNOK if the table is full
+ *
+ ******************************************************************************
+ */
+
+T_STATUS sched_addTask(const char* name, T_SCHED_RUN_FCT run, uint32 evtMask)
+{
+  T_SCHED_DATA* schedData = sched_dataTbl;
+  T_SCHED_TASK* task;
+  T_STATUS result = STATUS_eNOK;
+
+  if(NULL == run)
+  {
+    result = STATUS_eINVALID_ARG;
+  }
+  else if(schedData->numTasks >= SCHED_MAX_TASKS)
+  {
+    /* No more tasks available */
+  }
+  else
+  {
+    task = &schedData->tasks[schedData->numTasks];
+    libc_memset(task, 0, sizeof(T_SCHED_TASK));
+    task->name = name;
+    task->run = run;
+    task->evtMask = evtMask;
+    schedData->numTasks++;
+    result = STATUS_eOK;
+  }
+  return result;
+}
+
+
+/*
+ ******************************************************************************
+ * Function: sched_setEvent
+ ******************************************************************************
+ * @brief Set events to be processed with the next pass
+ *
+ * May be called from interrupt handlers.
+ *
+ * @param [in] evt - Events to be set
+ *
+ ******************************************************************************
+ */
+
+void sched_setEvent(uint32 evt)
+{
+  T_SCHED_DATA* schedData = sched_dataTbl;
+
+  (void)__atomic_fetch_or(&schedData->evtPending, evt, __ATOMIC_SEQ_CST);
+}
+
+
+/*
+ ******************************************************************************
+ * Function: sched_run
+ ******************************************************************************
+ * @brief Execute a single pass of the scheduler
+ *
+ * Interrupts are masked while checking for pending events, so an event
+ * set in between doesn't get lost but wakes up the core from WFI. The
+ * interrupt is served as soon as interrupts are unmasked again.
+ *
+ ******************************************************************************
+ */
+
+void sched_run(void)
+{
+  T_SCHED_DATA* schedData = sched_dataTbl;
+  T_SCHED_TASK* task;
+  uint32 events;
+  uint32 cycStart;
+  uint32 cycUsed;
+  uint32 taskID;
+
+  CPU_DIS_IRQS();
+  if(0 == schedData->evtPending)
+  {
+    /* Nothing to do, so sleep until the next interrupt */
+    cycStart = cpu_getCycleCount();
+    CPU_DSB();
+    CPU_WFI();
+    schedData->cycSleep += (uint32)(cpu_getCycleCount() - cycStart);
+  }
+  CPU_ENA_IRQS();
+
+  /* Collect events including those of the interrupt, which woke up the core */
+  events = __atomic_exchange_n(&schedData->evtPending, 0, __ATOMIC_SEQ_CST);
+
+  for(taskID = 0; taskID < schedData->numTasks; taskID++)
+  {
+    task = &schedData->tasks[taskID];
+    if(0 == (task->evtMask & events))
+    {
+      /* Task doesn't wait for any of the events */
+    }
+    else
+    {
+      cycStart = cpu_getCycleCount();
+      task->run();
+      cycUsed = cpu_getCycleCount() - cycStart;
+
+      task->runCnt++;
+      task->cycLast = cycUsed;
+      task->cycSum += cycUsed;
+      if(cycUsed > task->cycMax)
+      {
+        task->cycMax = cycUsed;
+      }
+    }
+  }
+}
+
+
+/*
+ ******************************************************************************
+ * Function: sched_getTask
+ ******************************************************************************
+ * @brief Get a task's descriptor and statistics
+ *
+ * @param [in] taskID - Index of the task in order of registration
+ *
+ * @return Task descriptor, NULL if no such task
+ *
+ ******************************************************************************
+ */
+
+const T_SCHED_TASK* sched_getTask(uint32 taskID)
+{
+  T_SCHED_DATA* schedData = sched_dataTbl;
+  const T_SCHED_TASK* task = NULL;
+
+  if(taskID < schedData->numTasks)
+  {
+    task = &schedData->tasks[taskID];
+  }
+  return task;
+}
+
+
+/*
+ ******************************************************************************
+ * Function: sched_getSleepCycles
+ ******************************************************************************
+ * @brief Get the number of cycles the core was sleeping
+ *
+ ******************************************************************************
+ */
+
+uint64 sched_getSleepCycles(void)
+{
+  T_SCHED_DATA* schedData = sched_dataTbl;
+
+  return schedData->cycSleep;
+}
+
+
+/*
+ ******************************************************************************
+ * Function: sched_clrStats
+ ******************************************************************************
+ * @brief Reset the statistics of all tasks
+ *
+ ******************************************************************************
+ */
+
+void sched_clrStats(void)
+{
+  T_SCHED_DATA* schedData = sched_dataTbl;
+  T_SCHED_TASK* task;
+  uint32 taskID;
+
+  for(taskID = 0; taskID < schedData->numTasks; taskID++)
+  {
+    task = &schedData->tasks[taskID];
+    task->runCnt = 0;
+    task->cycLast = 0;
+    task->cycMax = 0;
+    task->cycSum = 0;
+  }
+  schedData->cycSleep = 0;
+}
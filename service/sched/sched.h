@@ -0,0 +1,46 @@
+#ifndef SCHED_H
+#define SCHED_H
+
+/* Maximum number of tasks to be registered */
+#if !defined (SCHED_MAX_TASKS)
+#define SCHED_MAX_TASKS 8
+#endif /* !defined (SCHED_MAX_TASKS) */
+
+/* Events a task may wait for */
+#define SCHED_EVT_NONE      0x00000000
+#define SCHED_EVT_TICK      0x00000001 /* System timer tick */
+#define SCHED_EVT_COM_RX    0x00000002 /* Data received on COM_UART */
+#define SCHED_EVT_COM_TX    0x00000004 /* Transmit buffer of COM_UART drained */
+#define SCHED_EVT_STD_RX    0x00000008 /* Data received on STD_UART */
+#define SCHED_EVT_BCP_FRAME 0x00000010 /* BCP received or transmitted a frame */
+#define SCHED_EVT_ALL       0xFFFFFFFF
+
+
+/* Task run function type */
+typedef void (*T_SCHED_RUN_FCT)(void);
+
+
+/*! Task descriptor and statistics */
+typedef struct
+{
+  const char* name;     /*!< Name of the task */
+  T_SCHED_RUN_FCT run;  /*!< Run function of the task */
+  uint32 evtMask;       /*!< Events the task is run on */
+  uint32 runCnt;        /*!< Number of runs */
+  uint32 cycLast;       /*!< Cycles used by the recent run */
+  uint32 cycMax;        /*!< Maximum cycles used by a single run */
+  uint64 cycSum;        /*!< Cycles used by all runs */
+}T_SCHED_TASK;
+
+
+extern void sched_init(void);
+extern T_STATUS sched_addTask(const char* name, T_SCHED_RUN_FCT run, uint32 evtMask);
+
+extern void sched_setEvent(uint32 evt);
+extern void sched_run(void);
+
+extern const T_SCHED_TASK* sched_getTask(uint32 taskID);
+extern uint64 sched_getSleepCycles(void);
+extern void sched_clrStats(void);
+
+#endif /* SCHED_H */
@@ -0,0 +1,267 @@
+#!/usr/bin/perl -w
+
+###############################################################################
+#
+###############################################################################
+
+use strict;
+use File::Basename;
+
+
+# Create command arguments from arguments given to this scipt and undefine
+# the script's arguments
+my @cmdArgs = @ARGV;
+undef @ARGV;
+
+# Definition of all functions used by this script
+
+
+###############################################################################
+#
+###############################################################################
+#
+# Read the memory regions and output sections from a GNU ld map file.
+#
+# The memory regions are taken from the "Memory Configuration" table.
+# Output sections, input sections and symbols are taken from the
+# "Linker script and memory map" part. Section names exceeding the column
+# width are printed on a line of their own by the linker, so the address
+# and size of such a section are taken from the following line.
+#
+###############################################################################
+
+sub map_parse
+{
+  my $map = $_[0];
+  my $mapFile = $_[1];
+  my $file;
+  my $line;
+  my $part = 0;
+  my $pendName;
+  my $curSect;
+
+  @{$map->{'regions'}} = ();
+  @{$map->{'sections'}} = ();
+  %{$map->{'symbols'}} = ();
+
+  open($file, "<", $mapFile) or die "Failed to open: $mapFile $!";
+  while($line = <$file>)
+  {
+    chomp($line);
+    $line =~ s/\r$//;
+
+    if($line =~ m/^Memory Configuration/)
+    {
+      $part = 1;
+    }
+    elsif($line =~ m/^Linker script and memory map/)
+    {
+      $part = 2;
+    }
+    elsif($part == 1)
+    {
+      # Name Origin Length [Attributes]
+      if($line =~ m/^(\S+)\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)/)
+      {
+        if($1 ne "*default*")
+        {
+          push(@{$map->{'regions'}}, { 'name' => $1, 'origin' => hex($2), 'length' => hex($3) });
+        }
+      }
+    }
+    elsif($part == 2)
+    {
+      if(defined($pendName))
+      {
+        # Address and size of a section with a long name
+        $line = $pendName.$line;
+        undef $pendName;
+      }
+
+      if($line =~ m/^(\.\S+)$/ || $line =~ m/^ (\.\S+)$/)
+      {
+        $pendName = $line;
+      }
+      elsif($line =~ m/^(\.\S+)\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)(\s+load address 0x([0-9a-fA-F]+))?/)
+      {
+        # Output section
+        $curSect = { 'name' => $1, 'vma' => hex($2), 'size' => hex($3) };
+        $curSect->{'lma'} = defined($5) ? hex($5) : $curSect->{'vma'};
+        push(@{$map->{'sections'}}, $curSect);
+      }
+      elsif($line =~ m/^\s+0x([0-9a-fA-F]+)\s+([A-Za-z_][A-Za-z0-9_]*)( = .*)?$/)
+      {
+        # Symbol or assignment of the linker script
+        if(defined($curSect))
+        {
+          $map->{'symbols'}{$2} = { 'addr' => hex($1), 'sect' => $curSect->{'name'} };
+        }
+      }
+    }
+  }
+  close($file);
+}
+
+
+###############################################################################
+#
+###############################################################################
+#
+# Get the name of the memory region containing the given address.
+# Overlapping regions are resolved by the smallest one.
+#
+###############################################################################
+
+sub map_getRegion
+{
+  my $map = $_[0];
+  my $addr = $_[1];
+  my $result = "-";
+  my $resultLen = 0;
+  my $region;
+
+  foreach $region (@{$map->{'regions'}})
+  {
+    if( ($addr >= $region->{'origin'})
+     && ($addr < $region->{'origin'} + $region->{'length'})
+     && (($resultLen == 0) || ($region->{'length'} < $resultLen)) )
+    {
+      $result = $region->{'name'};
+      $resultLen = $region->{'length'};
+    }
+  }
+  return $result;
+}
+
+
+# Define help message for this script
+my $helpMessage = <<"END_HELP";
+ --map-file=<map-file-name>
+ --expect=<region>:<symbol|section>[,<symbol|section>...]
+END_HELP
+
+
+# Define the script's main function
+#
+sub main
+{
+  # Get arguments and argument count
+  my @args = @_;
+  my $argc = @args;
+
+  # Name of the map file to be reported
+  my $mapFile;
+  # List of symbols expected per region
+  my @expList = ();
+
+  my $map = {};
+  my $sect;
+  my $exp;
+  my $sym;
+  my $region;
+  my $numErrors = 0;
+
+  if($argc > 0)
+  {
+    my $argID;
+    my $argStr;
+    # Parse arguments
+    for($argID = 0; $argID < $argc; $argID++)
+    {
+      $argStr = $cmdArgs[$argID];
+      if($argStr =~ m/--map-file=(.+)/)
+      {
+        $mapFile = $1;
+      }
+      elsif($argStr =~ m/--expect=([A-Za-z0-9_]+):(.+)/)
+      {
+        my $expRegion = $1;
+        foreach $sym (split(/,/, $2))
+        {
+          push(@expList, { 'region' => $expRegion, 'symbol' => $sym });
+        }
+      }
+      else
+      {
+        print("Invalid argument: ".$argStr."\n");
+        exit(-1);
+      }
+    }
+  }
+  else
+  {
+    print("$helpMessage\n");
+    return -1;
+  }
+
+  if(defined($mapFile) && (-e $mapFile))
+  {
+    # All right
+  }
+  else
+  {
+    print("Map file doesn't exist.\n");
+    exit(-1);
+  }
+
+  map_parse($map, $mapFile);
+
+  print("\nMemory placement...\n");
+  printf("  MapFile: %s\n", $mapFile);
+  printf("  %-16s %-10s %-10s %-10s %s\n", "Section", "VMA", "LMA", "Size", "Region");
+  foreach $sect (@{$map->{'sections'}})
+  {
+    if($sect->{'size'} > 0)
+    {
+      printf("  %-16s 0x%08X 0x%08X 0x%08X %s\n",
+             $sect->{'name'}, $sect->{'vma'}, $sect->{'lma'}, $sect->{'size'},
+             map_getRegion($map, $sect->{'vma'}));
+    }
+  }
+
+  # Check the placement of the expected symbols
+  foreach $exp (@expList)
+  {
+    $sym = $map->{'symbols'}{$exp->{'symbol'}};
+    if(!defined($sym))
+    {
+      # Static symbols are not listed, so output sections may be given too
+      foreach $sect (@{$map->{'sections'}})
+      {
+        if($sect->{'name'} eq $exp->{'symbol'})
+        {
+          $sym = { 'addr' => $sect->{'vma'}, 'sect' => $sect->{'name'} };
+        }
+      }
+    }
+
+    if(!defined($sym))
+    {
+      printf("  %-8s %-24s not found\n", $exp->{'region'}, $exp->{'symbol'});
+      $numErrors++;
+    }
+    else
+    {
+      $region = map_getRegion($map, $sym->{'addr'});
+      if($region eq $exp->{'region'})
+      {
+        printf("  %-8s %-24s 0x%08X %s\n", $region, $exp->{'symbol'}, $sym->{'addr'}, $sym->{'sect'});
+      }
+      else
+      {
+        printf("  %-8s %-24s 0x%08X misplaced in %s\n", $exp->{'region'}, $exp->{'symbol'}, $sym->{'addr'}, $region);
+        $numErrors++;
+      }
+    }
+  }
+
+  if($numErrors > 0)
+  {
+    printf("Placement check failed for %d symbol(s)\n", $numErrors);
+    exit(-1);
+  }
+  return 0;
+}
+
+# This function is called, when the perl script is executed.
+main(@cmdArgs);